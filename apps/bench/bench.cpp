@@ -0,0 +1,355 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   bench.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// std libs
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+// stl
+#include <vector>
+
+// peak memory usage
+#if defined(__unix__) || defined(__APPLE__)
+#define DUALMC_BENCH_RUSAGE
+#include <sys/resource.h>
+#endif
+
+// dual mc builder
+#include "dualmc.h"
+
+// synthetic volumes
+#include "synthetic.h"
+
+// main include
+#include "bench.h"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+
+namespace {
+
+/// Convert a density in [0,1] to the value range of an integer volume.
+template<class T> T quantize(float const density) {
+    return density * std::numeric_limits<T>::max();
+}
+
+/// Floating point volumes keep the density as is.
+template<> float quantize<float>(float const density) {
+    return density;
+}
+
+} // END: anonymous namespace
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::run(int const argc, char** argv) {
+    // parse program options
+    BenchOptions options;
+    if(!parseArgs(argc,argv,options)) {
+        return;
+    }
+
+    printHeader(options.printCSV);
+
+    // generate each volume once and extract it with all data types
+    for(auto const & volumeName : options.volumes) {
+        for(int32_t const size : options.sizes) {
+            // volumes are generated with all hardware threads
+            std::vector<float> density;
+            if(!generateSyntheticVolume(volumeName, size, size, size, 0, density)) {
+                std::cerr << "Unknown volume: " << volumeName << std::endl;
+                printHelpHint();
+                return;
+            }
+            for(auto const & typeName : options.types) {
+                if(typeName == "uint8") {
+                    runType<uint8_t>("uint8", volumeName, size, density, options);
+                } else if(typeName == "uint16") {
+                    runType<uint16_t>("uint16", volumeName, size, density, options);
+                } else if(typeName == "float") {
+                    runType<float>("float", volumeName, size, density, options);
+                } else {
+                    std::cerr << "Unknown volume data type: " << typeName << std::endl;
+                    printHelpHint();
+                    return;
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCBenchmark::parseArgs(int const argc, char** argv, BenchOptions & options) {
+    // set default values
+    options.repeats = 5;
+    options.numThreads = 1;
+    options.useBricks = false;
+    options.printCSV = false;
+
+    // parse arguments
+    for(int currentArg = 1; currentArg < argc; ++currentArg) {
+        if(strcmp(argv[currentArg],"-bricks") == 0) {
+            options.useBricks = true;
+        } else if(strcmp(argv[currentArg],"-csv") == 0) {
+            options.printCSV = true;
+        } else if(strcmp(argv[currentArg],"-size") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Volume size missing" << std::endl;
+                return false;
+            }
+            int32_t const size = atoi(argv[currentArg+1]);
+            if(size < 2) {
+                std::cerr << "Invalid volume size: " << argv[currentArg+1] << std::endl;
+                return false;
+            }
+            options.sizes.push_back(size);
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-volume") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Volume name missing" << std::endl;
+                return false;
+            }
+            options.volumes.push_back(argv[currentArg+1]);
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-type") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Volume data type missing" << std::endl;
+                return false;
+            }
+            options.types.push_back(argv[currentArg+1]);
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-repeats") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Repeat count missing" << std::endl;
+                return false;
+            }
+            options.repeats = std::max(1, atoi(argv[currentArg+1]));
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-threads") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Thread count missing" << std::endl;
+                return false;
+            }
+            // negative values are treated as 0, i.e. all hardware threads
+            options.numThreads = std::max(0, atoi(argv[currentArg+1]));
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-help") == 0) {
+            printArgs();
+            return false;
+        } else {
+            std::cerr << "Unknown argument: " << argv[currentArg] << std::endl;
+            printHelpHint();
+            return false;
+        }
+    }
+
+    // run everything unless restricted by the arguments
+    if(options.sizes.empty()) {
+        options.sizes = {64, 128, 256};
+    }
+    if(options.volumes.empty()) {
+        options.volumes = {"caffeine", "noise", "sphere", "sparse"};
+    }
+    if(options.types.empty()) {
+        options.types = {"uint8", "uint16", "float"};
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printArgs() const {
+    std::cout << "Usage: bench ARGS" << std::endl;
+    std::cout << " -help              print this help" << std::endl;
+    std::cout << " -size N            extract volumes with N^3 voxels, may be repeated. DEFAULT: 64 128 256" << std::endl;
+    std::cout << " -volume NAME       extract volume NAME in {caffeine,noise,sphere,sparse}, may be repeated. DEFAULT: all" << std::endl;
+    std::cout << " -type NAME         use volume data type NAME in {uint8,uint16,float}, may be repeated. DEFAULT: all" << std::endl;
+    std::cout << " -repeats N         time N extractions per case after one warm-up run. DEFAULT: 5" << std::endl;
+    std::cout << " -threads N         extract with N threads, 0 uses all hardware threads. DEFAULT: 1" << std::endl;
+    std::cout << " -bricks            skip empty regions with min-max bricks, which are built in each run" << std::endl;
+    std::cout << " -csv               print comma separated values instead of a table" << std::endl;
+    std::cout << "Throughput is computed from the fastest run. The peak resident set size" << std::endl;
+    std::cout << "includes the volume and is reset between cases on Linux if permitted." << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printHelpHint() const {
+    std::cout << "Try: bench -help" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T>
+void DualMCBenchmark::runType(char const * typeName, std::string const & volumeName, int32_t const size,
+  std::vector<float> const & density, BenchOptions const & options) {
+    std::vector<T> data(density.size());
+    std::transform(density.begin(), density.end(), data.begin(), quantize<T>);
+    T const iso = quantize<T>(0.5f);
+
+    for(int manifold = 0; manifold < 2; ++manifold) {
+        for(int soup = 0; soup < 2; ++soup) {
+            CaseResult const result = runCase(data, size, iso, manifold == 1, soup == 1, options);
+            printResult(typeName, volumeName, size, manifold == 1, soup == 1, result, options.printCSV);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T>
+DualMCBenchmark::CaseResult DualMCBenchmark::runCase(std::vector<T> const & data, int32_t const size,
+  T const iso, bool const generateManifold, bool const generateSoup, BenchOptions const & options) const {
+    CaseResult result;
+    std::vector<double> times;
+    resetPeakRSS();
+
+    // the first run warms up caches and the allocator and is not timed
+    for(int32_t r = 0; r <= options.repeats; ++r) {
+        std::vector<dualmc::Vertex> vertices;
+        std::vector<dualmc::Quad> quads;
+
+        high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+
+        dualmc::DualMC<T> builder;
+        dualmc::MinMaxBricks<T> bricks;
+        if(options.useBricks) {
+            bricks.build(data.data(), size, size, size);
+            builder.setMinMaxBricks(&bricks);
+        }
+        if(options.numThreads == 1) {
+            builder.build(data.data(), size, size, size,
+                iso, generateManifold, generateSoup, vertices, quads);
+        } else {
+            builder.buildParallel(data.data(), size, size, size,
+                iso, generateManifold, generateSoup, vertices, quads, options.numThreads);
+        }
+
+        high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+        duration<double> const diffTime = duration_cast<duration<double>>(endTime - startTime);
+        if(r > 0) {
+            times.push_back(diffTime.count());
+        }
+        result.numVertices = vertices.size();
+        result.numQuads = quads.size();
+    }
+
+    result.peakRSS = getPeakRSS();
+
+    // statistics of the timed runs
+    result.minTime = *std::min_element(times.begin(), times.end());
+    double sum = 0.0;
+    for(double const t : times) {
+        sum += t;
+    }
+    result.meanTime = sum / times.size();
+    double squaredDeviations = 0.0;
+    for(double const t : times) {
+        squaredDeviations += (t - result.meanTime) * (t - result.meanTime);
+    }
+    result.stdDevTime = times.size() > 1 ? std::sqrt(squaredDeviations / (times.size() - 1)) : 0.0;
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printHeader(bool const printCSV) const {
+    if(printCSV) {
+        std::cout << "type,volume,size,manifold,soup,vertices,quads,min_ms,mean_ms,stddev_percent,"
+          "mcells_per_s,mquads_per_s,peak_rss_mib" << std::endl;
+        return;
+    }
+    std::cout << std::left
+      << std::setw(7) << "type" << std::setw(9) << "volume" << std::right
+      << std::setw(5) << "size" << std::setw(9) << "manifold" << std::setw(5) << "soup"
+      << std::setw(10) << "quads" << std::setw(10) << "min[ms]" << std::setw(10) << "mean[ms]"
+      << std::setw(8) << "dev[%]" << std::setw(10) << "Mcells/s" << std::setw(10) << "Mquads/s"
+      << std::setw(10) << "RSS[MiB]" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::printResult(char const * typeName, std::string const & volumeName, int32_t const size,
+  bool const generateManifold, bool const generateSoup, CaseResult const & result,
+  bool const printCSV) const {
+    double const numCells = double(size-1) * double(size-1) * double(size-1);
+    double const cellsPerSecond = numCells / result.minTime * 1e-6;
+    double const quadsPerSecond = double(result.numQuads) / result.minTime * 1e-6;
+    double const relativeDeviation = 100.0 * result.stdDevTime / result.meanTime;
+    char const separator = printCSV ? ',' : ' ';
+    std::ostream & out = std::cout;
+    out << std::fixed;
+    if(printCSV) {
+        out << typeName << separator << volumeName << separator << size << separator
+          << generateManifold << separator << generateSoup << separator
+          << result.numVertices << separator << result.numQuads << separator
+          << std::setprecision(3) << result.minTime * 1e3 << separator << result.meanTime * 1e3 << separator
+          << std::setprecision(1) << relativeDeviation << separator
+          << std::setprecision(2) << cellsPerSecond << separator << quadsPerSecond << separator
+          << std::setprecision(1) << result.peakRSS << std::endl;
+    } else {
+        out << std::left
+          << std::setw(7) << typeName << std::setw(9) << volumeName << std::right
+          << std::setw(5) << size << std::setw(9) << (generateManifold ? "yes" : "no")
+          << std::setw(5) << (generateSoup ? "yes" : "no") << std::setw(10) << result.numQuads
+          << std::setprecision(2) << std::setw(10) << result.minTime * 1e3
+          << std::setw(10) << result.meanTime * 1e3
+          << std::setprecision(1) << std::setw(8) << relativeDeviation
+          << std::setprecision(1) << std::setw(10) << cellsPerSecond << std::setw(10) << quadsPerSecond
+          << std::setw(10) << result.peakRSS << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCBenchmark::resetPeakRSS() {
+#if defined(__linux__)
+    // resets the VmHWM entry of the process status
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+double DualMCBenchmark::getPeakRSS() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)) {
+        if(line.compare(0, 6, "VmHWM:") == 0) {
+            return std::atof(line.c_str() + 6) / 1024.0;
+        }
+    }
+#endif
+#ifdef DUALMC_BENCH_RUSAGE
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        // reported in bytes
+        return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        // reported in kilobytes
+        return usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+    return 0.0;
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef BENCH_H_INCLUDED
+#define BENCH_H_INCLUDED
+
+/// \file   bench.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cstdint>
+
+// std includes
+#include <string>
+
+// stl includes
+#include <vector>
+
+/// Benchmark application for the dual marching cubes builder. Extracts iso
+/// surfaces of synthetic volumes with all combinations of volume data type,
+/// volume size, and builder settings and reports the throughput.
+class DualMCBenchmark {
+public:
+    /// run benchmark
+    void run(int const argc, char** argv);
+
+private:
+
+    /// Structure for the program options.
+    struct BenchOptions {
+        std::vector<int32_t> sizes;
+        std::vector<std::string> volumes;
+        std::vector<std::string> types;
+        int32_t repeats;
+        unsigned int numThreads;
+        bool useBricks;
+        bool printCSV;
+    };
+
+    /// Timing and memory results of one benchmark case.
+    struct CaseResult {
+        size_t numVertices;
+        size_t numQuads;
+        double minTime;
+        double meanTime;
+        double stdDevTime;
+        double peakRSS;
+    };
+
+    /// Parse program arguments.
+    bool parseArgs(int const argc, char** argv, BenchOptions & options);
+
+    /// Print program arguments.
+    void printArgs() const;
+
+    /// Print program help hint.
+    void printHelpHint() const;
+
+    /// Run all builder settings for a volume converted to the data type T.
+    template<class T>
+    void runType(char const * typeName, std::string const & volumeName, int32_t const size,
+      std::vector<float> const & density, BenchOptions const & options);
+
+    /// Extract the iso surface repeatedly with one builder setting.
+    template<class T>
+    CaseResult runCase(std::vector<T> const & data, int32_t const size, T const iso,
+      bool const generateManifold, bool const generateSoup, BenchOptions const & options) const;
+
+    /// Print the header of the result table.
+    void printHeader(bool const printCSV) const;
+
+    /// Print one row of the result table.
+    void printResult(char const * typeName, std::string const & volumeName, int32_t const size,
+      bool const generateManifold, bool const generateSoup, CaseResult const & result,
+      bool const printCSV) const;
+
+    /// Reset the peak resident set size of the process if supported.
+    static void resetPeakRSS();
+
+    /// Get the peak resident set size of the process in MiB, or 0 if unknown.
+    static double getPeakRSS();
+};
+
+#endif // BENCH_H_INCLUDED
@@ -0,0 +1,130 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   synthetic.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cmath>
+
+// std libs
+#include <algorithm>
+#include <random>
+
+// executor for generating slices concurrently
+#include "dualmc_executor.h"
+
+// caffeine molecule density of the example application
+#include "caffeine.h"
+
+// main include
+#include "synthetic.h"
+
+namespace {
+
+/// Generate trilinearly interpolated value noise with a lattice point every
+/// eight voxels, which creates many small surface components.
+void generateNoise(int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  dualmc::ThreadExecutor const & executor, std::vector<float> & density) {
+    int32_t constexpr spacing = 8;
+    int32_t const latticeX = (dimX-1) / spacing + 2;
+    int32_t const latticeY = (dimY-1) / spacing + 2;
+    int32_t const latticeZ = (dimZ-1) / spacing + 2;
+    std::vector<float> lattice(size_t(latticeX) * latticeY * latticeZ);
+    std::mt19937 random(5489u);
+    for(auto & value : lattice) {
+        value = (random() >> 8) * (1.0f / 16777216.0f);
+    }
+    auto const gL = [latticeX,latticeY](int32_t x, int32_t y, int32_t z) {
+        return size_t(x) + size_t(latticeX) * (size_t(y) + size_t(latticeY) * size_t(z));
+    };
+    executor.run(dimZ, [&](int32_t const z) {
+        int32_t const lz = z / spacing;
+        float const fz = float(z % spacing) / spacing;
+        size_t p = size_t(dimX) * size_t(dimY) * size_t(z);
+        for(int32_t y = 0; y < dimY; ++y) {
+            int32_t const ly = y / spacing;
+            float const fy = float(y % spacing) / spacing;
+            for(int32_t x = 0; x < dimX; ++x, ++p) {
+                int32_t const lx = x / spacing;
+                float const fx = float(x % spacing) / spacing;
+                float const c00 = lattice[gL(lx,ly,lz)] * (1-fx) + lattice[gL(lx+1,ly,lz)] * fx;
+                float const c10 = lattice[gL(lx,ly+1,lz)] * (1-fx) + lattice[gL(lx+1,ly+1,lz)] * fx;
+                float const c01 = lattice[gL(lx,ly,lz+1)] * (1-fx) + lattice[gL(lx+1,ly,lz+1)] * fx;
+                float const c11 = lattice[gL(lx,ly+1,lz+1)] * (1-fx) + lattice[gL(lx+1,ly+1,lz+1)] * fx;
+                float const c0 = c00 * (1-fy) + c10 * fy;
+                float const c1 = c01 * (1-fy) + c11 * fy;
+                density[p] = c0 * (1-fz) + c1 * fz;
+            }
+        }
+    });
+}
+
+/// Generate a sphere with a linear density fall-off in canonical [0,1]^3
+/// volume coordinates.
+void generateSphere(int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  float const radius, float const center,
+  dualmc::ThreadExecutor const & executor, std::vector<float> & density) {
+    float const invDimX = 1.0f / (dimX-1);
+    float const invDimY = 1.0f / (dimY-1);
+    float const invDimZ = 1.0f / (dimZ-1);
+    // The density is zero beyond the bounding radius, so only the part of a
+    // row inside the bounding sphere is evaluated. The bounding radius is
+    // slightly enlarged to cover the rounding of the distances.
+    float const boundingRadius = 0.5f + radius + 1e-3f;
+    executor.run(dimZ, [&](int32_t const z) {
+        float const dz = float(z) * invDimZ - center;
+        for(int32_t y = 0; y < dimY; ++y) {
+            float const dy = float(y) * invDimY - center;
+            float * const row = &density[size_t(dimX) * (size_t(y) + size_t(dimY) * size_t(z))];
+            std::fill(row, row + dimX, 0.0f);
+            float const remaining = boundingRadius * boundingRadius - dy * dy - dz * dz;
+            if(remaining <= 0.0f)
+                continue;
+            float const halfWidth = std::sqrt(remaining);
+            int32_t const begin = std::max(0, int32_t(std::floor((center - halfWidth) * (dimX-1))));
+            int32_t const end = std::min(dimX, int32_t(std::ceil((center + halfWidth) * (dimX-1))) + 1);
+            for(int32_t x = begin; x < end; ++x) {
+                float const dx = float(x) * invDimX - center;
+                float const distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+                row[x] = std::min(1.0f, std::max(0.0f, 0.5f + (radius - distance)));
+            }
+        }
+    });
+}
+
+} // END: anonymous namespace
+
+//------------------------------------------------------------------------------
+
+bool generateSyntheticVolume(std::string const & name,
+  int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  unsigned int const numThreads, std::vector<float> & density) {
+    // the molecule of the example application scaled to the volume size
+    if(name == "caffeine") {
+        computeCaffeineDensity(dimX, dimY, dimZ, density, numThreads);
+        return true;
+    }
+
+    // The sparse volume contains a single small sphere, so most of the volume
+    // is empty.
+    bool const noise = name == "noise";
+    bool const sphere = name == "sphere";
+    bool const sparse = name == "sparse";
+    if(!noise && !sphere && !sparse)
+        return false;
+
+    density.resize(size_t(dimX) * size_t(dimY) * size_t(dimZ));
+    dualmc::ThreadExecutor const executor(numThreads);
+    if(noise) {
+        generateNoise(dimX, dimY, dimZ, executor, density);
+    } else if(sphere) {
+        generateSphere(dimX, dimY, dimZ, 0.4f, 0.5f, executor, density);
+    } else {
+        generateSphere(dimX, dimY, dimZ, 0.05f, 0.25f, executor, density);
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef SYNTHETIC_H_INCLUDED
+#define SYNTHETIC_H_INCLUDED
+
+/// \file   synthetic.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cstdint>
+
+// std includes
+#include <string>
+
+// stl includes
+#include <vector>
+
+/// Generate a synthetic volume with values in [0,1] and the iso surface at
+/// 0.5. Available volumes are
+///  - caffeine, the molecule of the example application
+///  - noise, trilinearly interpolated value noise with many small surface
+///    components
+///  - sphere, a large sphere with a linear density fall-off
+///  - sparse, a single small sphere, so most of the volume is empty
+/// Slices are generated concurrently by the given number of threads, 0 uses
+/// all hardware threads. The volume does not depend on the thread count.
+/// Returns false for unknown volume names.
+bool generateSyntheticVolume(std::string const & name,
+  int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  unsigned int const numThreads, std::vector<float> & density);
+
+#endif // SYNTHETIC_H_INCLUDED
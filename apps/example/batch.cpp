@@ -0,0 +1,294 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   batch.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// std libs
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// stl
+#include <vector>
+
+// dual mc builder
+#include "dualmc.h"
+
+// vertex cache optimization
+#include "dualmc_reorder.h"
+
+// iso value mapping
+#include "volumefile.h"
+
+// main include
+#include "batch.h"
+
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+
+namespace {
+
+/// Volume and mesh of a job. Tiles are recycled for later jobs, so their
+/// memory is only allocated for the largest jobs.
+struct Tile {
+    /// manifest line of the job
+    size_t line;
+    std::string inputFile;
+    std::string outputFile;
+    int32_t dimX;
+    int32_t dimY;
+    int32_t dimZ;
+    /// bit depth, 8 or 16
+    int32_t bitDepth;
+    /// volume data
+    std::vector<uint8_t> data;
+    /// extracted surface
+    std::vector<dualmc::Vertex> vertices;
+    std::vector<dualmc::Quad> quads;
+    /// error of a failed job, empty if the job succeeded so far
+    std::string error;
+};
+
+//------------------------------------------------------------------------------
+
+/// \class  TileQueue
+/// Queue passing tiles between the threads of a batch.
+class TileQueue {
+public:
+    /// Create an open queue.
+    TileQueue() : closed(false) {}
+
+    /// Append a tile.
+    void push(Tile * tile) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tiles.push_back(tile);
+        }
+        available.notify_one();
+    }
+
+    /// Wait for the next tile. Returns null if the queue is closed and empty.
+    Tile * pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this]() { return closed || !tiles.empty(); });
+        if(tiles.empty())
+            return nullptr;
+        Tile * const tile = tiles.front();
+        tiles.pop_front();
+        return tile;
+    }
+
+    /// Close the queue after the last tile.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        available.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<Tile*> tiles;
+    bool closed;
+};
+
+//------------------------------------------------------------------------------
+
+/// Get the file name extension of a mesh format.
+char const * getMeshFormatExtension(MeshFormat const format) {
+    switch(format) {
+        case MeshFormat::OBJ: return ".obj";
+        case MeshFormat::PLY: return ".ply";
+        case MeshFormat::RAW: return ".raw";
+        case MeshFormat::COMPACT: return ".dmcq";
+    }
+    return "";
+}
+
+//------------------------------------------------------------------------------
+
+/// Parse a job line of the manifest. Returns false for lines without a job.
+bool parseJob(std::string const & line, MeshFormat const format, Tile & tile) {
+    std::istringstream fields(line);
+    if(!(fields >> tile.inputFile) || tile.inputFile[0] == '#')
+        return false;
+    tile.error.clear();
+    if(!(fields >> tile.dimX >> tile.dimY >> tile.dimZ) ||
+      tile.dimX < 1 || tile.dimY < 1 || tile.dimZ < 1) {
+        tile.error = "invalid dimensions";
+        return true;
+    }
+    if(!(fields >> tile.outputFile)) {
+        tile.outputFile = tile.inputFile + getMeshFormatExtension(format);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+/// Read the raw file of a job. The bit depth is derived from the file size.
+void loadTile(Tile & tile) {
+    std::ifstream file(tile.inputFile, std::ifstream::binary);
+    if(!file) {
+        tile.error = "unable to open file";
+        return;
+    }
+    file.seekg(0, file.end);
+    size_t const fileSize = file.tellg();
+    file.seekg(0, file.beg);
+    size_t const numVoxels = size_t(tile.dimX) * size_t(tile.dimY) * size_t(tile.dimZ);
+    if(fileSize == numVoxels) {
+        tile.bitDepth = 8;
+    } else if(fileSize == numVoxels * 2) {
+        tile.bitDepth = 16;
+    } else {
+        tile.error = "file size inconsistent with dimensions";
+        return;
+    }
+    tile.data.resize(fileSize);
+    if(!file.read((char*)tile.data.data(), fileSize)) {
+        tile.error = "error while reading file";
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/// Builders of an extraction worker, which keep their memory across jobs.
+class BatchWorker {
+public:
+    /// Initialize the builders with the options of the batch.
+    explicit BatchWorker(BatchOptions const & options) : options(options) {
+        dualmc::DualPointPlacement const placement = options.useHermite ?
+            dualmc::DualPointPlacement::Hermite : dualmc::DualPointPlacement::Centroid;
+        builder8.setDualPointPlacement(placement);
+        builder16.setDualPointPlacement(placement);
+    }
+
+    /// Extract the iso surface of a loaded tile.
+    void extract(Tile & tile) {
+        if(tile.bitDepth == 8) {
+            builder8.build(tile.data.data(), tile.dimX, tile.dimY, tile.dimZ,
+                mapIsoValue<uint8_t>(options.isoValue),
+                options.generateManifold, options.generateQuadSoup, tile.vertices, tile.quads);
+        } else {
+            builder16.build((uint16_t const*)tile.data.data(), tile.dimX, tile.dimY, tile.dimZ,
+                mapIsoValue<uint16_t>(options.isoValue),
+                options.generateManifold, options.generateQuadSoup, tile.vertices, tile.quads);
+        }
+        if(options.reorderMesh) {
+            optimizer.optimize(tile.vertices, tile.quads);
+        }
+    }
+
+private:
+    BatchOptions const & options;
+    dualmc::DualMC<uint8_t> builder8;
+    dualmc::DualMC<uint16_t> builder16;
+    dualmc::MeshOptimizer optimizer;
+};
+
+} // END: anonymous namespace
+
+//------------------------------------------------------------------------------
+
+bool runBatch(std::istream & manifest, BatchOptions const & options) {
+    dualmc::ThreadExecutor const executor(options.numWorkers);
+    unsigned int const numWorkers = executor.concurrency();
+    std::cout << "Extracting batch with " << numWorkers << " workers" << std::endl;
+
+    // Each worker extracts one tile while the reader loads as many tiles
+    // ahead and the writer writes one. The pool of free tiles bounds the
+    // number of loaded volumes.
+    std::vector<std::unique_ptr<Tile>> tiles(numWorkers * 2 + 2);
+    TileQueue freeTiles;
+    for(auto & tile : tiles) {
+        tile.reset(new Tile);
+        freeTiles.push(tile.get());
+    }
+    TileQueue loadedTiles;
+    TileQueue extractedTiles;
+
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+
+    // read the jobs and load their volumes
+    std::thread reader([&]() {
+        std::string line;
+        for(size_t lineNumber = 1; std::getline(manifest, line); ++lineNumber) {
+            Tile * const tile = freeTiles.pop();
+            if(!parseJob(line, options.outputFormat, *tile)) {
+                freeTiles.push(tile);
+                continue;
+            }
+            tile->line = lineNumber;
+            if(tile->error.empty()) {
+                loadTile(*tile);
+            }
+            loadedTiles.push(tile);
+        }
+        loadedTiles.close();
+    });
+
+    // write the meshes and recycle their tiles
+    size_t numJobs = 0;
+    size_t numFailed = 0;
+    size_t numVertices = 0;
+    size_t numQuads = 0;
+    std::thread writer([&]() {
+        BufferedFile file;
+        for(Tile * tile = extractedTiles.pop(); tile; tile = extractedTiles.pop()) {
+            ++numJobs;
+            if(tile->error.empty() && !writeMesh(file, tile->outputFile, options.outputFormat, tile->vertices, tile->quads)) {
+                tile->error = "error writing output file '" + tile->outputFile + "'";
+            }
+            if(!tile->error.empty()) {
+                std::cerr << "Job in line " << tile->line << " ('" << tile->inputFile << "') failed: "
+                    << tile->error << std::endl;
+                ++numFailed;
+            } else {
+                numVertices += tile->vertices.size();
+                numQuads += tile->quads.size();
+            }
+            freeTiles.push(tile);
+        }
+    });
+
+    // extract the loaded tiles
+    executor.run(int32_t(numWorkers), [&](int32_t) {
+        BatchWorker worker(options);
+        for(Tile * tile = loadedTiles.pop(); tile; tile = loadedTiles.pop()) {
+            if(tile->error.empty()) {
+                worker.extract(*tile);
+            }
+            extractedTiles.push(tile);
+        }
+    });
+    extractedTiles.close();
+    reader.join();
+    writer.join();
+
+    high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+    duration<double> const diffTime = duration_cast<duration<double>>(endTime - startTime);
+    double const batchTime = diffTime.count();
+
+    std::cout << "Batch time: " << batchTime << "s" << std::endl;
+    std::cout << "Extracted " << numJobs - numFailed << " of " << numJobs << " tiles with "
+        << numVertices << " vertices and " << numQuads << " quads" << std::endl;
+    if(batchTime > 0.0) {
+        std::cout << "Throughput: " << double(numJobs) / batchTime << " tiles/s" << std::endl;
+    }
+    return numFailed == 0;
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+/// \file   batch.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// std includes
+#include <istream>
+
+// mesh file formats
+#include "meshwriter.h"
+
+/// Options shared by all jobs of a batch.
+struct BatchOptions {
+    float isoValue;
+    bool generateQuadSoup;
+    bool generateManifold;
+    bool useHermite;
+    bool reorderMesh;
+    /// number of extraction workers, 0 uses all hardware threads
+    unsigned int numWorkers;
+    MeshFormat outputFormat;
+};
+
+/// Extract the iso surfaces of a batch of 8 or 16-bit raw files. Each line of
+/// the manifest describes one job as
+///   FILE X Y Z [OUT]
+/// with the dimensions of the raw file and an optional output file name.
+/// Without OUT, the extension of the output format is appended to FILE.
+/// Empty lines and lines starting with # are skipped. Jobs are read while
+/// the batch is processed, so the manifest can be a stream like stdin.
+/// A reader thread loads the volumes of the next jobs while the workers
+/// extract the current ones, and a writer thread writes the meshes. Each
+/// worker reuses its builders, and the volume and mesh memory is reused for
+/// later jobs. Returns false if any job failed.
+bool runBatch(std::istream & manifest, BatchOptions const & options);
+
+#endif // BATCH_H_INCLUDED
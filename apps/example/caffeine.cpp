@@ -0,0 +1,211 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   caffeine.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cmath>
+
+// stl includes
+#include <algorithm>
+#include <limits>
+
+// executor for computing slices concurrently
+#include "dualmc_executor.h"
+
+// main include
+#include "caffeine.h"
+
+//------------------------------------------------------------------------------
+
+void computeCaffeineDensity(int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  std::vector<float> & density, unsigned int const numThreads) {
+    density.resize(size_t(dimX) * size_t(dimY) * size_t(dimZ));
+    
+    float invDimX = 1.0f / (dimX-1);
+    float invDimY = 1.0f / (dimY-1);
+    float invDimZ = 1.0f / (dimZ-1);
+    
+    CaffeineMolecule const molecule;
+    
+    // compute canoncical [0,1]^3 volume coordinates for density evaluation
+    std::vector<float> xs(dimX);
+    for(int32_t x = 0; x < dimX; ++x) {
+        xs[x] = float(x) * invDimX;
+    }
+    
+    // iterate all rows of voxels slice by slice
+    dualmc::ThreadExecutor const executor(numThreads);
+    executor.run(dimZ, [&](int32_t const z) {
+        float const nZ = float(z) * invDimZ;
+        for(int32_t y = 0; y < dimY; ++y) {
+            float const nY = float(y) * invDimY;
+            float * const row = &density[size_t(dimX) * (size_t(y) + size_t(dimY) * size_t(z))];
+            molecule.evalRow(xs.data(), dimX, nY, nZ, row);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+
+CaffeineMolecule::CaffeineMolecule() {
+    // create caffeine molecule
+    // 3D structure from https://pubchem.ncbi.nlm.nih.gov/compound/caffeine#section=Top
+    
+    // caffeine scale
+    float constexpr s = 1.0f/10.0f;
+    // caffeine offset
+    float constexpr oX = 0.5f;
+    float constexpr oY = 0.5f;
+    float constexpr oZ = 0.5f;
+    // atom scale scale
+    //float constexpr as = 0.001f/70.0f/70.0f;
+    float constexpr as = 0.025*0.025/70.0f/70.0f;
+    // atom scales
+    float const atomScales[] = {25*25*as,70*70*as,65*65*as,60*60*as};
+    enum ElementType {HYDROGEN=0,CARBON=1,NITROGEN=2,OXYGEN=3};
+    
+    atoms.reserve(24);
+    // 1 hydrogen, 6 carbon, 7 nitrogen, 8 oxygen
+    atoms.emplace_back(   0.47 * s + oX,  2.5688 * s + oY,  0.0006 * s + oZ,atomScales[OXYGEN]); // 8
+    atoms.emplace_back(-3.1271 * s + oX, -0.4436 * s + oY, -0.0003 * s + oZ,atomScales[OXYGEN]); // 8
+    atoms.emplace_back(-0.9686 * s + oX, -1.3125 * s + oY,       0 * s + oZ,atomScales[NITROGEN]); // 7
+    atoms.emplace_back( 2.2182 * s + oX,  0.1412 * s + oY, -0.0003 * s + oZ,atomScales[NITROGEN]); // 7
+    atoms.emplace_back(-1.3477 * s + oX,  1.0797 * s + oY, -0.0001 * s + oZ,atomScales[NITROGEN]); // 7
+    atoms.emplace_back( 1.4119 * s + oX, -1.9372 * s + oY,  0.0002 * s + oZ,atomScales[NITROGEN]); // 7
+    atoms.emplace_back( 0.8579 * s + oX,  0.2592 * s + oY, -0.0008 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back( 0.3897 * s + oX, -1.0264 * s + oY, -0.0004 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back(-1.9061 * s + oX, -0.2495 * s + oY, -0.0004 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back( 0.0307 * s + oX,   1.422 * s + oY, -0.0006 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back( 2.5032 * s + oX, -1.1998 * s + oY,  0.0003 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back(-1.4276 * s + oX, -2.6960 * s + oY,  0.0008 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back( 3.1926 * s + oX,  1.2061 * s + oY,  0.0003 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back(-2.2969 * s + oX,  2.1881 * s + oY,  0.0007 * s + oZ,atomScales[CARBON]); // 6
+    atoms.emplace_back( 3.5163 * s + oX, -1.5787 * s + oY,  0.0008 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-1.0451 * s + oX, -3.1973 * s + oY, -0.8937 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-2.5186 * s + oX, -2.7596 * s + oY,  0.0011 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-1.0447 * s + oX, -3.1963 * s + oY,  0.8957 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back( 4.1992 * s + oX,  0.7801 * s + oY,  0.0002 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back( 3.0468 * s + oX,  1.8092 * s + oY, -0.8992 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back( 3.0466 * s + oX,  1.8083 * s + oY,  0.9004 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-1.8087 * s + oX,  3.1651 * s + oY, -0.0003 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-2.9322 * s + oX,  2.1027 * s + oY,  0.8881 * s + oZ,atomScales[HYDROGEN]); // 1
+    atoms.emplace_back(-2.9346 * s + oX,  2.1021 * s + oY, -0.8849 * s + oZ,atomScales[HYDROGEN]); // 1
+}
+
+//------------------------------------------------------------------------------
+
+void CaffeineMolecule::evalRow(float const * xs, int32_t const numX, float y, float z,
+  float * densities) const {
+    // scale for density field
+    float constexpr postDensityScale = 2.5f;
+    // Atoms are added in the same order as by eval. Skipped atoms would add
+    // zero, so the sums are the same.
+    std::fill(densities, densities + numX, 0.0f);
+    for(auto const & a : atoms) {
+        a.addRow(xs, numX, y, z, densities);
+    }
+    for(int32_t x = 0; x < numX; ++x) {
+        float const rho = densities[x] * postDensityScale;
+        densities[x] = rho > 1.0f ? 1.0f : rho;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CaffeineMolecule::getRange(float const (&lower)[3], float const (&upper)[3],
+  float & minDensity, float & maxDensity) const {
+    // the scale and the clamping preserve the order of densities
+    float constexpr postDensityScale = 2.5f;
+    minDensity = 0.0f;
+    maxDensity = 0.0f;
+    for(auto const & a : atoms) {
+        float minValue, maxValue;
+        a.getRange(lower, upper, minValue, maxValue);
+        minDensity += minValue;
+        maxDensity += maxValue;
+    }
+    minDensity = std::min(minDensity * postDensityScale, 1.0f);
+    maxDensity = std::min(maxDensity * postDensityScale, 1.0f);
+}
+
+//------------------------------------------------------------------------------
+
+CaffeineField::CaffeineField(int32_t const dimX, int32_t const dimY, int32_t const dimZ) {
+    invDims[0] = 1.0f / (dimX-1);
+    invDims[1] = 1.0f / (dimY-1);
+    invDims[2] = 1.0f / (dimZ-1);
+}
+
+//------------------------------------------------------------------------------
+
+void CaffeineField::getRange(int32_t const (&lower)[3], int32_t const (&upper)[3],
+  uint16_t & minValue, uint16_t & maxValue) const {
+    // box corners are computed like the voxel coordinates, so they bound them
+    float nLower[3];
+    float nUpper[3];
+    for(int i = 0; i < 3; ++i) {
+        nLower[i] = float(lower[i]) * invDims[i];
+        nUpper[i] = float(upper[i]) * invDims[i];
+    }
+    float minDensity, maxDensity;
+    molecule.getRange(nLower, nUpper, minDensity, maxDensity);
+    minValue = quantize(minDensity);
+    maxValue = quantize(maxDensity);
+}
+
+//------------------------------------------------------------------------------
+
+RadialGaussian::RadialGaussian(
+    float cX,
+    float cY,
+    float cZ,
+    float variance
+    ) : cX(cX), cY(cY), cZ(cZ) {
+        float constexpr TWO_PI = 6.283185307179586f;
+        normalization = 1.0f/sqrt(TWO_PI * variance);
+        falloff = -0.5f / variance;
+        // Beyond this distance the function is below a quarter of the smallest
+        // float, so it is rounded to zero. The margin to half of the smallest
+        // float covers the rounding of the distances.
+        double const smallestFloat = std::numeric_limits<float>::denorm_min();
+        cutoffSquared = float(std::log(0.25 * smallestFloat / normalization) / falloff);
+    }
+
+//------------------------------------------------------------------------------
+
+void RadialGaussian::addRow(float const * xs, int32_t const numX, float y, float z, float * values) const {
+    // the cutoff sphere intersects the row in an interval of x coordinates
+    float const dy = y - cY;
+    float const dz = z - cZ;
+    float const remaining = cutoffSquared - dy * dy - dz * dz;
+    if(remaining <= 0.0f)
+        return;
+    float const radius = std::sqrt(remaining);
+    int32_t const begin = int32_t(std::lower_bound(xs, xs + numX, cX - radius) - xs);
+    int32_t const end = int32_t(std::upper_bound(xs, xs + numX, cX + radius) - xs);
+    for(int32_t x = begin; x < end; ++x) {
+        values[x] += eval(xs[x], y, z);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void RadialGaussian::getRange(float const (&lower)[3], float const (&upper)[3],
+  float & minValue, float & maxValue) const {
+    // The distances along each axis are computed like the ones of points in
+    // the box, so with the monotonic evaluation they bound the function.
+    float const center[3] = {cX, cY, cZ};
+    float closest[3];
+    float farthest[3];
+    for(int i = 0; i < 3; ++i) {
+        closest[i] = std::min(std::max(center[i], lower[i]), upper[i]);
+        farthest[i] = center[i] - lower[i] > upper[i] - center[i] ? lower[i] : upper[i];
+    }
+    maxValue = eval(closest[0], closest[1], closest[2]);
+    minValue = eval(farthest[0], farthest[1], farthest[2]);
+}
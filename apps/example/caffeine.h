@@ -0,0 +1,141 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef CAFFEINE_H_INCLUDED
+#define CAFFEINE_H_INCLUDED
+
+/// \file   caffeine.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cmath>
+#include <cstdint>
+
+// stl includes
+#include <limits>
+#include <vector>
+
+/// Compute the approximate electron density of a caffeine molecule centered
+/// in a volume of the given dimensions. Densities are clamped to [0,1].
+/// Slices are computed concurrently by the given number of threads, 0 uses
+/// all hardware threads.
+void computeCaffeineDensity(int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+  std::vector<float> & density, unsigned int const numThreads = 1);
+
+/// Class for a volumetric sphere with gaussian fall-off.
+class RadialGaussian {
+public:
+    /// Initialize with center coordinates and half density radius.
+    RadialGaussian(float cX, float cY, float cZ, float variance);
+    // evaluate the sphere function
+    float eval(float x, float y, float z) const;
+    // Add the sphere function to a row of points with increasing x coordinates.
+    // Points farther from the center than the cutoff radius are skipped.
+    void addRow(float const * xs, int32_t const numX, float y, float z, float * values) const;
+    // Compute the range of the sphere function in the box from lower to upper
+    // by evaluating it at the closest and farthest point of the box.
+    void getRange(float const (&lower)[3], float const (&upper)[3],
+      float & minValue, float & maxValue) const;
+private:
+    // Coordinates of the sphere center.
+    float cX;
+    float cY;
+    float cZ;
+    // precomputed factors
+    float normalization;
+    float falloff;
+    // squared distance beyond which the function evaluates to exactly zero
+    float cutoffSquared;
+    
+};
+
+/// Approximate electron density of a caffeine molecule in the canonical
+/// [0,1]^3 volume, made from one radial Gaussian per atom.
+class CaffeineMolecule {
+public:
+    /// Create the atoms of the molecule.
+    CaffeineMolecule();
+    /// Evaluate the density clamped to [0,1].
+    float eval(float x, float y, float z) const;
+    /// Evaluate the densities of a row of points with increasing x
+    /// coordinates. Only atoms close to a point are evaluated, which gives
+    /// the same densities as eval.
+    void evalRow(float const * xs, int32_t const numX, float y, float z, float * densities) const;
+    /// Compute a range containing the densities in the box from lower to
+    /// upper. The sums of the atom ranges bound the sum of the atoms.
+    void getRange(float const (&lower)[3], float const (&upper)[3],
+      float & minDensity, float & maxDensity) const;
+private:
+    // approximate electron density with radial Gaussians.
+    std::vector<RadialGaussian> atoms;
+};
+
+/// Caffeine density of a volume with the given dimensions quantized to 16
+/// bit, which is evaluated per voxel. Implements the field type of
+/// DualMC::buildImplicit and generates the same voxels as
+/// computeCaffeineDensity.
+class CaffeineField {
+public:
+    /// Initialize for a volume of the given dimensions.
+    CaffeineField(int32_t const dimX, int32_t const dimY, int32_t const dimZ);
+    /// Evaluate voxel (x,y,z).
+    uint16_t operator()(int32_t const x, int32_t const y, int32_t const z) const;
+    /// Compute a range containing the voxels in the box from lower to upper.
+    void getRange(int32_t const (&lower)[3], int32_t const (&upper)[3],
+      uint16_t & minValue, uint16_t & maxValue) const;
+private:
+    // quantize a density to 16 bit
+    static uint16_t quantize(float const density);
+    // molecule evaluated in canonical volume coordinates
+    CaffeineMolecule molecule;
+    // scales from voxel to canonical volume coordinates
+    float invDims[3];
+};
+
+//------------------------------------------------------------------------------
+
+inline float RadialGaussian::eval(float x, float y, float z) const {
+    // compute squared input point distance to gauss center
+    float const dx = x - cX;
+    float const dy = y - cY;
+    float const dz = z - cZ;
+    float const dSquared = dx * dx + dy * dy + dz * dz;
+    // the gauss is rounded to zero beyond the cutoff radius
+    if(dSquared >= cutoffSquared)
+        return 0.0f;
+    // compute gauss 
+    return normalization * exp(falloff * dSquared);
+}
+
+//------------------------------------------------------------------------------
+
+inline float CaffeineMolecule::eval(float x, float y, float z) const {
+    // scale for density field
+    float constexpr postDensityScale = 2.5f;
+    float rho = 0.0f;
+    // compute sum of electron densities
+    for(auto const & a : atoms) {
+        rho += a.eval(x,y,z);
+    }
+    rho *= postDensityScale;
+    if(rho > 1.0f)
+        rho = 1.0f;
+    return rho;
+}
+
+//------------------------------------------------------------------------------
+
+inline uint16_t CaffeineField::operator()(int32_t const x, int32_t const y, int32_t const z) const {
+    return quantize(molecule.eval(float(x) * invDims[0], float(y) * invDims[1], float(z) * invDims[2]));
+}
+
+//------------------------------------------------------------------------------
+
+inline uint16_t CaffeineField::quantize(float const density) {
+    return density * std::numeric_limits<uint16_t>::max();
+}
+
+#endif // CAFFEINE_H_INCLUDED
@@ -13,6 +13,7 @@
 #include <cstring>
 
 // std libs
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -21,9 +22,33 @@
 // stl
 #include <vector>
 
+// memory mapping
+#if defined(__unix__) || defined(__APPLE__)
+#define DUALMC_EXAMPLE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // dual mc builder
 #include "dualmc.h"
 
+// data-parallel dual mc builder
+#include "dualmc_gpu.h"
+
+// level of detail dual mc builder
+#include "dualmc_lod.h"
+
+// vertex cache optimization
+#include "dualmc_reorder.h"
+
+// batch extraction of many raw files
+#include "batch.h"
+
+// caffeine molecule density
+#include "caffeine.h"
+
 // main include
 #include "example.h"
 
@@ -33,31 +58,112 @@ using std::chrono::duration_cast;
 
 //------------------------------------------------------------------------------
 
-void DualMCExample::run(int const argc, char** argv) {
+bool DualMCExample::run(int const argc, char** argv) {
     // parse program options
     AppOptions options;
     if(!parseArgs(argc,argv,options)) {
-        return;
+        return options.printHelp;
+    }
+    
+    // extract the surfaces of many raw files listed in a manifest
+    if(!options.batchFile.empty()) {
+        if(options.generateCaffeine || !options.inputFile.empty() || !options.nrrdFile.empty() ||
+          options.streamInput || options.mapInput) {
+            std::cerr << "Batch mode reads the raw files of its manifest" << std::endl;
+            printHelpHint();
+            return false;
+        }
+        if(options.hasVoxelType || options.numChannels > 1) {
+            std::cerr << "Batch mode only supports single-channel 8 and 16-bit raw files" << std::endl;
+            return false;
+        }
+        if(options.useGPU || options.lodLevel > 0 || options.useImplicit) {
+            std::cerr << "Batch mode is not supported by the GPU, level of detail, and implicit builders" << std::endl;
+            return false;
+        }
+        return extractBatch(options);
+    }
+    
+    // extract the surface slice by slice without loading the whole volume
+    if(options.streamInput) {
+        if(options.inputFile.empty() && options.nrrdFile.empty()) {
+            std::cerr << "Streaming requires a raw or NRRD file" << std::endl;
+            printHelpHint();
+            return false;
+        }
+        if(options.outputFormat != MeshFormat::OBJ) {
+            std::cerr << "Streaming only supports OBJ output" << std::endl;
+            return false;
+        }
+        if(options.useGPU) {
+            std::cerr << "Streaming is not supported by the GPU builder" << std::endl;
+            return false;
+        }
+        if(options.lodLevel > 0) {
+            std::cerr << "Streaming does not support levels of detail" << std::endl;
+            return false;
+        }
+        if(options.reorderMesh) {
+            std::cerr << "Streaming does not support reordering the mesh" << std::endl;
+            return false;
+        }
+        VolumeLayout layout;
+        return getInputLayout(options, layout) && streamVolumeFile(options, layout);
+    }
+    
+    if(options.useGPU && options.useHermite) {
+        std::cerr << "Hermite dual points are not supported by the GPU builder" << std::endl;
+        return false;
+    }
+    if(options.lodLevel > 0 && (options.useGPU || options.useHermite)) {
+        std::cerr << "Levels of detail only support the centroid dual points of the CPU builder" << std::endl;
+        return false;
+    }
+    
+    // extract the caffeine molecule without generating its volume
+    if(options.useImplicit) {
+        if(!options.generateCaffeine) {
+            std::cerr << "Implicit extraction requires the caffeine molecule" << std::endl;
+            printHelpHint();
+            return false;
+        }
+        if(options.useGPU || options.lodLevel > 0) {
+            std::cerr << "Implicit extraction is not supported by the GPU and level of detail builders" << std::endl;
+            return false;
+        }
+        computeImplicitCaffeine(options.caffeineSize,options.isoValue,options.generateQuadSoup,options.generateManifold,options.useHermite,options.printStats);
+        if(options.reorderMesh) {
+            optimizeMesh(options.printStats);
+        }
+        return writeMeshFile(options.outputFile, options.outputFormat);
     }
     
     // load raw file or generate example volume dataset
     if(options.generateCaffeine) {
-        generateCaffeine();
-    } else if(!options.inputFile.empty()) {
-        if(!loadRawFile(options.inputFile, options.dimX, options.dimY, options.dimZ)) {
-            return;
+        generateCaffeine(options.caffeineSize, options.numThreads);
+    } else if(!options.inputFile.empty() || !options.nrrdFile.empty()) {
+        VolumeLayout layout;
+        if(!getInputLayout(options, layout) || !loadVolumeFile(layout, options.channel, options.mapInput)) {
+            return false;
         }
     } else {
         std::cerr << "No input specified" << std::endl;
         printHelpHint();
-        return;
+        return false;
     }
     
     // compute ISO surface
-    computeSurface(options.isoValue,options.generateQuadSoup,options.generateManifold);
+    if(!computeSurface(options.isoValue,options.generateQuadSoup,options.generateManifold,options.numThreads,options.useGPU,options.useHermite,options.lodLevel,options.printStats)) {
+        return false;
+    }
+    
+    // reorder the mesh for rendering
+    if(options.reorderMesh) {
+        optimizeMesh(options.printStats);
+    }
     
     // write output file
-    writeOBJ(options.outputFile);
+    return writeMeshFile(options.outputFile, options.outputFormat);
 }
 
 //------------------------------------------------------------------------------
@@ -68,11 +174,29 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
     options.dimX = -1;
     options.dimY = -1;
     options.dimZ = -1;
+    options.hasVoxelType = false;
+    options.voxelType = VoxelType::UInt8;
+    options.numChannels = 1;
+    options.channel = 0;
+    options.nrrdFile.assign("");
     options.isoValue = 0.5f;
     options.generateCaffeine = false;
+    options.caffeineSize = 128;
     options.generateQuadSoup = false;
     options.generateManifold = false;
-    options.outputFile.assign("surface.obj");
+    options.numThreads = 1;
+    options.useGPU = false;
+    options.useHermite = false;
+    options.lodLevel = 0;
+    options.useImplicit = false;
+    options.reorderMesh = false;
+    options.streamInput = false;
+    options.mapInput = false;
+    options.printStats = false;
+    options.outputFormat = MeshFormat::OBJ;
+    options.outputFile.assign("");
+    options.batchFile.assign("");
+    options.printHelp = false;
     
     // parse arguments
     for(int currentArg = 1; currentArg < argc; ++currentArg) {
@@ -82,18 +206,55 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             options.generateCaffeine = true;
         } else if(strcmp(argv[currentArg],"-manifold") == 0) {
             options.generateManifold = true;
+        } else if(strcmp(argv[currentArg],"-stream") == 0) {
+            options.streamInput = true;
+        } else if(strcmp(argv[currentArg],"-mmap") == 0) {
+            options.mapInput = true;
+        } else if(strcmp(argv[currentArg],"-stats") == 0) {
+            options.printStats = true;
+        } else if(strcmp(argv[currentArg],"-gpu") == 0) {
+            options.useGPU = true;
+        } else if(strcmp(argv[currentArg],"-hermite") == 0) {
+            options.useHermite = true;
+        } else if(strcmp(argv[currentArg],"-implicit") == 0) {
+            options.useImplicit = true;
+        } else if(strcmp(argv[currentArg],"-reorder") == 0) {
+            options.reorderMesh = true;
         } else if(strcmp(argv[currentArg],"-iso") == 0) {
             if(currentArg+1 == argc) {
                 std::cerr << "Iso value missing" << std::endl;
                 return false;
             }
-            // Read the iso value and clamp it to [0,1].
+            // The iso value is mapped to the voxel type, see mapIsoValue.
             // Invalid values are set to 0.
             options.isoValue = atof(argv[currentArg+1]);
-            if(options.isoValue > 1.0f)
-                options.isoValue = 1.0f;
-            else if(options.isoValue < 0.0f || options.isoValue != options.isoValue)
-                options.isoValue = 0.0f;
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-size") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Caffeine volume size missing" << std::endl;
+                return false;
+            }
+            options.caffeineSize = atoi(argv[currentArg+1]);
+            if(options.caffeineSize < 2) {
+                std::cerr << "Invalid caffeine volume size: " << argv[currentArg+1] << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-lod") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Level of detail missing" << std::endl;
+                return false;
+            }
+            // negative values are treated as 0, i.e. the full resolution
+            options.lodLevel = std::max(0, atoi(argv[currentArg+1]));
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-threads") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Thread count missing" << std::endl;
+                return false;
+            }
+            // negative values are treated as 0, i.e. all hardware threads
+            options.numThreads = std::max(0, atoi(argv[currentArg+1]));
             ++currentArg;
         } else if(strcmp(argv[currentArg],"-out") == 0) {
             if(currentArg+1 == argc) {
@@ -102,6 +263,17 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             }
             options.outputFile.assign(argv[currentArg+1]);
             ++currentArg;
+        } else if(strcmp(argv[currentArg],"-format") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Output format missing" << std::endl;
+                return false;
+            }
+            if(!parseMeshFormat(argv[currentArg+1], options.outputFormat)) {
+                std::cerr << "Unknown output format: " << argv[currentArg+1] << std::endl;
+                printHelpHint();
+                return false;
+            }
+            ++currentArg;
         } else if(strcmp(argv[currentArg],"-raw") == 0) {
             if(currentArg+4 >= argc) {
                 std::cerr << "Not enough arguments for raw file" << std::endl;
@@ -112,8 +284,57 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             options.dimY = atoi(argv[currentArg+3]);
             options.dimZ = atoi(argv[currentArg+4]);
             currentArg += 4;
+        } else if(strcmp(argv[currentArg],"-type") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Voxel type missing" << std::endl;
+                return false;
+            }
+            if(!parseVoxelType(argv[currentArg+1], options.voxelType)) {
+                std::cerr << "Unknown voxel type: " << argv[currentArg+1] << std::endl;
+                printHelpHint();
+                return false;
+            }
+            options.hasVoxelType = true;
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-channels") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Channel count missing" << std::endl;
+                return false;
+            }
+            options.numChannels = atoi(argv[currentArg+1]);
+            if(options.numChannels < 1) {
+                std::cerr << "Invalid channel count: " << argv[currentArg+1] << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-channel") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Channel missing" << std::endl;
+                return false;
+            }
+            options.channel = atoi(argv[currentArg+1]);
+            if(options.channel < 0) {
+                std::cerr << "Invalid channel: " << argv[currentArg+1] << std::endl;
+                return false;
+            }
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-nrrd") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "NRRD filename missing" << std::endl;
+                return false;
+            }
+            options.nrrdFile.assign(argv[currentArg+1]);
+            ++currentArg;
+        } else if(strcmp(argv[currentArg],"-batch") == 0) {
+            if(currentArg+1 == argc) {
+                std::cerr << "Batch manifest missing" << std::endl;
+                return false;
+            }
+            options.batchFile.assign(argv[currentArg+1]);
+            ++currentArg;
         } else if(strcmp(argv[currentArg],"-help") == 0) {
             printArgs();
+            options.printHelp = true;
             return false;
         } else {
             std::cerr << "Unknown argument: " << argv[currentArg] << std::endl;
@@ -121,6 +342,23 @@ bool DualMCExample::parseArgs(int const argc, char** argv, AppOptions & options)
             return false;
         }
     }
+    
+    if(!options.inputFile.empty() && !options.nrrdFile.empty()) {
+        std::cerr << "Specify either a raw or a NRRD file" << std::endl;
+        return false;
+    }
+    
+    // the default output file name depends on the format
+    if(options.outputFile.empty()) {
+        if(options.outputFormat == MeshFormat::PLY)
+            options.outputFile.assign("surface.ply");
+        else if(options.outputFormat == MeshFormat::RAW)
+            options.outputFile.assign("surface.raw");
+        else if(options.outputFormat == MeshFormat::COMPACT)
+            options.outputFile.assign("surface.dmcq");
+        else
+            options.outputFile.assign("surface.obj");
+    }
     return true;
 }
 
@@ -130,11 +368,30 @@ void DualMCExample::printArgs() const {
     std::cout << "Usage: dmc ARGS" << std::endl;
     std::cout << " -help              print this help" << std::endl;
     std::cout << " -raw FILE X Y Z    specify raw file with dimensions" << std::endl;
+    std::cout << " -type T            specify voxel type T of the raw file in {uint8,uint16,int16,float,double}." << std::endl;
+    std::cout << "                    DEFAULT: uint8 or uint16 guessed from the file size" << std::endl;
+    std::cout << " -channels N        specify number of interleaved channels of the raw file. DEFAULT: 1" << std::endl;
+    std::cout << " -channel K         extract channel K of a multi-channel volume. DEFAULT: 0" << std::endl;
+    std::cout << " -nrrd FILE         specify raw encoded NRRD file or detached .nhdr header" << std::endl;
     std::cout << " -caffeine          generate built-in caffeine molecule" << std::endl;
+    std::cout << " -size N            generate the caffeine molecule with N^3 voxels. DEFAULT: 128" << std::endl;
     std::cout << " -manifold          use Manifold Dual Marching Cubes algorithm (Rephael Wenger)" << std::endl;
-    std::cout << " -iso X             specify iso value X in [0,1]. DEFAULT: 0.5" << std::endl;
-    std::cout << " -out FILE          specify output file name. DEFAULT: surface.obj" << std::endl;
+    std::cout << " -iso X             specify iso value X in [0,1] of the integer voxel range, or the voxel" << std::endl;
+    std::cout << "                    value X of float and double volumes. DEFAULT: 0.5" << std::endl;
+    std::cout << " -out FILE          specify output file name. DEFAULT: surface.obj, .ply, .raw, or .dmcq" << std::endl;
+    std::cout << " -format F          specify output format F in {obj,ply,raw,compact}. DEFAULT: obj" << std::endl;
     std::cout << " -soup              generate a quad soup (no vertex sharing)" << std::endl;
+    std::cout << " -threads N         extract with N threads, 0 uses all hardware threads. DEFAULT: 1" << std::endl;
+    std::cout << " -mmap              memory map the raw file instead of reading it" << std::endl;
+    std::cout << " -stream            read the raw file slice by slice and write the OBJ file while extracting" << std::endl;
+    std::cout << " -stats             print extraction counters and phase timings" << std::endl;
+    std::cout << " -gpu               extract with the data-parallel GPU builder, which runs on the CPU without CUDA" << std::endl;
+    std::cout << " -hermite           place dual points with gradient planes to keep sharp features" << std::endl;
+    std::cout << " -lod L             extract from the volume downsampled L times by a factor of two. DEFAULT: 0" << std::endl;
+    std::cout << " -implicit          evaluate the caffeine molecule during extraction instead of generating its volume" << std::endl;
+    std::cout << " -reorder           reorder quads and vertices for the vertex cache of a GPU" << std::endl;
+    std::cout << " -batch FILE        extract the raw files listed in FILE, - reads the list from stdin." << std::endl;
+    std::cout << "                    Each line is 'RAW X Y Z [OUT]', -threads sets the number of workers" << std::endl;
 }
 
 //------------------------------------------------------------------------------
@@ -145,24 +402,128 @@ void DualMCExample::printHelpHint() const {
 
 //------------------------------------------------------------------------------
 
-void DualMCExample::computeSurface(float const iso, bool const generateSoup, bool const generateManifold) {
-    std::cout << "Computing surface" << std::endl;
+bool DualMCExample::extractBatch(AppOptions const & options) {
+    BatchOptions batchOptions;
+    batchOptions.isoValue = options.isoValue;
+    batchOptions.generateQuadSoup = options.generateQuadSoup;
+    batchOptions.generateManifold = options.generateManifold;
+    batchOptions.useHermite = options.useHermite;
+    batchOptions.reorderMesh = options.reorderMesh;
+    batchOptions.numWorkers = options.numThreads;
+    batchOptions.outputFormat = options.outputFormat;
+    
+    if(options.batchFile == "-") {
+        return runBatch(std::cin, batchOptions);
+    }
+    std::ifstream manifest(options.batchFile);
+    if(!manifest) {
+        std::cerr << "Unable to open batch manifest '" << options.batchFile << "'" << std::endl;
+        return false;
+    }
+    return runBatch(manifest, batchOptions);
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCExample::computeImplicitCaffeine(int32_t const size, float const iso, bool const generateSoup,
+  bool const generateManifold, bool const useHermite, bool const printStats) {
+    std::cout << "Computing implicit caffeine surface" << std::endl;
     
     // measure extraction time
     high_resolution_clock::time_point const startTime = high_resolution_clock::now();
     
-    // construct iso surface
-    if(volume.bitDepth == 8) {
-        dualmc::DualMC<uint8_t> builder;
-        builder.build(&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
-            iso * std::numeric_limits<uint8_t>::max(), generateManifold, generateSoup, vertices, quads);
-    } else if(volume.bitDepth == 16) {
-        dualmc::DualMC<uint16_t> builder;
-        builder.build((uint16_t const*)&volume.data.front(), volume.dimX, volume.dimY, volume.dimZ,
-            iso * std::numeric_limits<uint16_t>::max(), generateManifold, generateSoup, vertices, quads);
+    // same dimensions and quantization as the generated volume
+    CaffeineField const field(size, size, size);
+    dualmc::DualMC<uint16_t> builder;
+    builder.setDualPointPlacement(useHermite ?
+        dualmc::DualPointPlacement::Hermite : dualmc::DualPointPlacement::Centroid);
+    builder.buildImplicit(field, size, size, size,
+        mapIsoValue<uint16_t>(iso), generateManifold, generateSoup, vertices, quads);
+    
+    high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+    duration<double> const diffTime = duration_cast<duration<double>>(endTime - startTime);
+    std::cout << "Extraction time: " << diffTime.count() << "s" << std::endl;
+    if(printStats) {
+        printBuildStats(builder.getStats());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T>
+bool DualMCExample::computeTypedSurface(float const iso, bool const generateSoup, bool const generateManifold,
+  unsigned int const numThreads, bool const useGPU, bool const useHermite, int const lodLevel,
+  dualmc::BuildStats & stats) {
+    // The builders read the extracted channel of multi-channel volumes in
+    // place, skipping the other channels with the voxel stride.
+    T const * const voxels = (T const*)volume.voxels + volume.channel;
+    T const isoValue = mapIsoValue<T>(iso);
+    if(lodLevel > 0) {
+        dualmc::ThreadExecutor executor(numThreads);
+        dualmc::MipPyramid<T> pyramid;
+        pyramid.build(voxels, volume.dimX, volume.dimY, volume.dimZ, lodLevel + 1, executor);
+        dualmc::DualMCLod<T> builder;
+        builder.build(pyramid, lodLevel, isoValue, generateManifold, generateSoup, vertices, quads);
+    } else if(useGPU) {
+        dualmc::DualMCGPU<T> builder;
+        if(!builder.build(voxels, volume.dimX, volume.dimY, volume.dimZ,
+          isoValue, generateManifold, generateSoup, vertices, quads)) {
+            std::cerr << "GPU extraction failed" << std::endl;
+            return false;
+        }
     } else {
-        std::cerr << "Invalid volume bit depth" << std::endl;
-        return;
+        dualmc::DualMC<T> builder;
+        builder.setDualPointPlacement(useHermite ?
+            dualmc::DualPointPlacement::Hermite : dualmc::DualPointPlacement::Centroid);
+        builder.setVoxelStride(volume.numChannels);
+        if(numThreads == 1) {
+            builder.build(voxels, volume.dimX, volume.dimY, volume.dimZ,
+                isoValue, generateManifold, generateSoup, vertices, quads);
+        } else {
+            builder.buildParallel(voxels, volume.dimX, volume.dimY, volume.dimZ,
+                isoValue, generateManifold, generateSoup, vertices, quads, numThreads);
+        }
+        stats = builder.getStats();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::computeSurface(float const iso, bool const generateSoup, bool const generateManifold,
+  unsigned int const numThreads, bool const useGPU, bool const useHermite, int const lodLevel,
+  bool const printStats) {
+    if((useGPU || lodLevel > 0) && volume.numChannels > 1) {
+        std::cerr << "The GPU and level of detail builders only support single-channel volumes" << std::endl;
+        return false;
+    }
+    std::cout << "Computing surface" << std::endl;
+    
+    // measure extraction time
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+    
+    // construct iso surface with the builders of the voxel type
+    dualmc::BuildStats stats;
+    bool success = false;
+    switch(volume.type) {
+        case VoxelType::UInt8:
+            success = computeTypedSurface<uint8_t>(iso, generateSoup, generateManifold, numThreads, useGPU, useHermite, lodLevel, stats);
+            break;
+        case VoxelType::UInt16:
+            success = computeTypedSurface<uint16_t>(iso, generateSoup, generateManifold, numThreads, useGPU, useHermite, lodLevel, stats);
+            break;
+        case VoxelType::Int16:
+            success = computeTypedSurface<int16_t>(iso, generateSoup, generateManifold, numThreads, useGPU, useHermite, lodLevel, stats);
+            break;
+        case VoxelType::Float:
+            success = computeTypedSurface<float>(iso, generateSoup, generateManifold, numThreads, useGPU, useHermite, lodLevel, stats);
+            break;
+        case VoxelType::Double:
+            success = computeTypedSurface<double>(iso, generateSoup, generateManifold, numThreads, useGPU, useHermite, lodLevel, stats);
+            break;
+    }
+    if(!success) {
+        return false;
     }
         
     high_resolution_clock::time_point const endTime = high_resolution_clock::now();
@@ -170,147 +531,190 @@ void DualMCExample::computeSurface(float const iso, bool const generateSoup, boo
     double const extractionTime = diffTime.count();
     
     std::cout << "Extraction time: " << extractionTime << "s" << std::endl;
+    if(printStats && (useGPU || lodLevel > 0)) {
+        std::cout << "Statistics are not available for the GPU and level of detail builders" << std::endl;
+    } else if(printStats) {
+        printBuildStats(stats);
+    }
+    return true;
 }
 
 //------------------------------------------------------------------------------
 
-void DualMCExample::generateCaffeine() {
+void DualMCExample::optimizeMesh(bool const printStats) {
+    std::cout << "Reordering mesh" << std::endl;
+    
+    // cache misses per triangle of the extraction order
+    std::vector<dualmc::QuadIndexType> triangles;
+    if(printStats) {
+        dualmc::MeshOptimizer::triangulate(quads.data(), quads.size(), triangles);
+        std::cout << "Cache misses per triangle before: "
+            << dualmc::MeshOptimizer::getCacheMissRatio(triangles.data(), triangles.size(), 32) << std::endl;
+    }
+    
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+    dualmc::MeshOptimizer optimizer;
+    if(printStats) {
+        optimizer.optimize(vertices, quads, triangles);
+    } else {
+        optimizer.optimize(vertices, quads);
+    }
+    high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+    duration<double> const diffTime = duration_cast<duration<double>>(endTime - startTime);
+    std::cout << "Reordering time: " << diffTime.count() << "s" << std::endl;
+    
+    if(printStats) {
+        std::cout << "Cache misses per triangle after: "
+            << dualmc::MeshOptimizer::getCacheMissRatio(triangles.data(), triangles.size(), 32) << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCExample::printBuildStats(dualmc::BuildStats const & stats) const {
+    if(!dualmc::BuildStats::isEnabled()) {
+        std::cout << "Statistics are not available, build with DUALMC_ENABLE_STATS" << std::endl;
+        return;
+    }
+    std::cout << "Crossed edges: " << stats.crossedEdges << std::endl;
+    std::cout << "Dual points computed: " << stats.dualPointsComputed << std::endl;
+    std::cout << "Dual points reused: " << stats.dualPointsReused << std::endl;
+    std::cout << "Manifold inversions: " << stats.manifoldInversions << std::endl;
+    std::cout << "Classification time: " << stats.classificationTime << "s" << std::endl;
+    std::cout << "Quad generation time: " << stats.quadGenerationTime << "s" << std::endl;
+    std::cout << "Slab merge time: " << stats.mergeTime << "s" << std::endl;
+    std::cout << "Total build time: " << stats.totalTime << "s" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCExample::generateCaffeine(int32_t const size, unsigned int const numThreads) {
     std::cout << "Generating caffeine volume" << std::endl;
     
     // initialize volume dimensions and memory
-    volume.dimX = 128;
-    volume.dimY = 128;
-    volume.dimZ = 128;
-    size_t const numDataPoints = volume.dimX * volume.dimY * volume.dimZ;
+    volume.dimX = size;
+    volume.dimY = size;
+    volume.dimZ = size;
+    size_t const numDataPoints = size_t(volume.dimX) * size_t(volume.dimY) * size_t(volume.dimZ);
     volume.data.resize(numDataPoints*2);
-    volume.bitDepth = 16;
-    
-    float invDimX = 1.0f / (volume.dimX-1);
-    float invDimY = 1.0f / (volume.dimY-1);
-    float invDimZ = 1.0f / (volume.dimZ-1);
-    
-    // create caffeine molecule
-    // 3D structure from https://pubchem.ncbi.nlm.nih.gov/compound/caffeine#section=Top
-    
-    // caffeine scale
-    float constexpr s = 1.0f/10.0f;
-    // caffeine offset
-    float constexpr oX = 0.5f;
-    float constexpr oY = 0.5f;
-    float constexpr oZ = 0.5f;
-    // atom scale scale
-    //float constexpr as = 0.001f/70.0f/70.0f;
-    float constexpr as = 0.025*0.025/70.0f/70.0f;
-    // atom scales
-    float const atomScales[] = {25*25*as,70*70*as,65*65*as,60*60*as};
-    enum ElementType {HYDROGEN=0,CARBON=1,NITROGEN=2,OXYGEN=3};
-    
-    // approximate electron density with radial Gaussians.
-    std::vector<RadialGaussian> atoms;
-    atoms.reserve(24);
-    // 1 hydrogen, 6 carbon, 7 nitrogen, 8 oxygen
-    atoms.emplace_back(   0.47 * s + oX,  2.5688 * s + oY,  0.0006 * s + oZ,atomScales[OXYGEN]); // 8
-    atoms.emplace_back(-3.1271 * s + oX, -0.4436 * s + oY, -0.0003 * s + oZ,atomScales[OXYGEN]); // 8
-    atoms.emplace_back(-0.9686 * s + oX, -1.3125 * s + oY,       0 * s + oZ,atomScales[NITROGEN]); // 7
-    atoms.emplace_back( 2.2182 * s + oX,  0.1412 * s + oY, -0.0003 * s + oZ,atomScales[NITROGEN]); // 7
-    atoms.emplace_back(-1.3477 * s + oX,  1.0797 * s + oY, -0.0001 * s + oZ,atomScales[NITROGEN]); // 7
-    atoms.emplace_back( 1.4119 * s + oX, -1.9372 * s + oY,  0.0002 * s + oZ,atomScales[NITROGEN]); // 7
-    atoms.emplace_back( 0.8579 * s + oX,  0.2592 * s + oY, -0.0008 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back( 0.3897 * s + oX, -1.0264 * s + oY, -0.0004 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back(-1.9061 * s + oX, -0.2495 * s + oY, -0.0004 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back( 0.0307 * s + oX,   1.422 * s + oY, -0.0006 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back( 2.5032 * s + oX, -1.1998 * s + oY,  0.0003 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back(-1.4276 * s + oX, -2.6960 * s + oY,  0.0008 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back( 3.1926 * s + oX,  1.2061 * s + oY,  0.0003 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back(-2.2969 * s + oX,  2.1881 * s + oY,  0.0007 * s + oZ,atomScales[CARBON]); // 6
-    atoms.emplace_back( 3.5163 * s + oX, -1.5787 * s + oY,  0.0008 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-1.0451 * s + oX, -3.1973 * s + oY, -0.8937 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-2.5186 * s + oX, -2.7596 * s + oY,  0.0011 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-1.0447 * s + oX, -3.1963 * s + oY,  0.8957 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back( 4.1992 * s + oX,  0.7801 * s + oY,  0.0002 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back( 3.0468 * s + oX,  1.8092 * s + oY, -0.8992 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back( 3.0466 * s + oX,  1.8083 * s + oY,  0.9004 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-1.8087 * s + oX,  3.1651 * s + oY, -0.0003 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-2.9322 * s + oX,  2.1027 * s + oY,  0.8881 * s + oZ,atomScales[HYDROGEN]); // 1
-    atoms.emplace_back(-2.9346 * s + oX,  2.1021 * s + oY, -0.8849 * s + oZ,atomScales[HYDROGEN]); // 1
+    volume.voxels = &volume.data.front();
+    volume.type = VoxelType::UInt16;
+    volume.numChannels = 1;
+    volume.channel = 0;
     
+    // compute electron density and quantize it to 16 bit
+    std::vector<float> density;
+    computeCaffeineDensity(volume.dimX, volume.dimY, volume.dimZ, density, numThreads);
     uint16_t * data16Bit = (uint16_t*)&volume.data.front();
-    
-    // scale for density field
-    float constexpr postDensityScale = 2.5f;
-    
-    // volume write position
-    int32_t p = 0;
-    // iterate all voxels
-    // compute canoncical [0,1]^3 volume coordinates for density evaluation
-    for(int32_t z = 0; z < volume.dimZ; ++z) {
-        float const nZ = float(z) * invDimZ;
-        for(int32_t y = 0; y < volume.dimY; ++y) {
-            float const nY = float(y) * invDimY;
-            for(int32_t x = 0; x < volume.dimX; ++x, ++p) {
-                float const nX = float(x) * invDimX;
-                float rho = 0.0f;
-                // compute sum of electron densities
-                for(auto const & a : atoms) {
-                    rho += a.eval(nX,nY,nZ);
-                }
-                rho *= postDensityScale;
-                if(rho > 1.0f)
-                    rho = 1.0f;
-                data16Bit[p] = rho * std::numeric_limits<uint16_t>::max();
-            }
-        }
+    for(size_t p = 0; p < numDataPoints; ++p) {
+        data16Bit[p] = density[p] * std::numeric_limits<uint16_t>::max();
     }
 }
 
 //------------------------------------------------------------------------------
 
-bool DualMCExample::loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ) {
-    // check provided dimensions
-    if(dimX < 1 || dimY < 1 || dimZ < 1) {
-        std::cerr << "Invalid RAW file dimensions specified" << std::endl;
-        return false;
+bool DualMCExample::getInputLayout(AppOptions const & options, VolumeLayout & layout) const {
+    if(!options.nrrdFile.empty()) {
+        std::string error;
+        if(!readNrrdHeader(options.nrrdFile, layout, error)) {
+            std::cerr << "Invalid NRRD file '" << options.nrrdFile << "': " << error << std::endl;
+            return false;
+        }
+    } else {
+        // check provided dimensions
+        if(options.dimX < 1 || options.dimY < 1 || options.dimZ < 1) {
+            std::cerr << "Invalid RAW file dimensions specified" << std::endl;
+            return false;
+        }
+        layout.dataFile = options.inputFile;
+        layout.dimX = options.dimX;
+        layout.dimY = options.dimY;
+        layout.dimZ = options.dimZ;
+        layout.numChannels = options.numChannels;
+        layout.type = options.voxelType;
+        layout.dataOffset = 0;
+        
+        // without a voxel type, 16-bit files are recognized by their size
+        if(!options.hasVoxelType) {
+            std::ifstream file(options.inputFile, std::ifstream::binary | std::ifstream::ate);
+            if(!file) {
+                std::cerr << "Unable to open file '" << options.inputFile << "'" << std::endl;
+                return false;
+            }
+            size_t const fileSize = file.tellg();
+            size_t const numValues = size_t(layout.numChannels) * size_t(layout.dimX) *
+                size_t(layout.dimY) * size_t(layout.dimZ);
+            if(fileSize != numValues && fileSize == numValues * 2) {
+                std::cout << "Assuming 16-bit RAW file" << std::endl;
+                layout.type = VoxelType::UInt16;
+            }
+        }
     }
-    
-    // open raw file
-    std::ifstream file(fileName, std::ifstream::binary);
-    if(!file) {
-        std::cerr << "Unable to open file '" << fileName << "'" << std::endl;
+    if(options.channel >= layout.numChannels) {
+        std::cerr << "Channel " << options.channel << " exceeds the " << layout.numChannels
+            << " channels of the volume" << std::endl;
         return false;
     }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::loadVolumeFile(VolumeLayout const & layout, int32_t const channel, bool const mapFile) {
+    size_t const typeSize = getVoxelTypeSize(layout.type);
+    size_t const dataSize = size_t(layout.numChannels) * size_t(layout.dimX) *
+        size_t(layout.dimY) * size_t(layout.dimZ) * typeSize;
     
-    // check consistency of file size and volume dimensions
-    size_t const expectedFileSize = size_t(dimX) * size_t(dimY) * size_t(dimZ);
-    file.seekg (0, file.end);
-    size_t const fileSize = file.tellg();
-    file.seekg (0, file.beg);
+    // Map the volume file, which avoids copying the data. The mapping is
+    // passed directly to the dual mc builder, which requires the voxels to
+    // be aligned to their size.
+    volume.mappedFile.unmap();
+    bool mapped = mapFile && volume.mappedFile.map(layout.dataFile);
+    if(mapFile && !mapped) {
+        std::cout << "Unable to map file, reading it instead" << std::endl;
+    } else if(mapped && layout.dataOffset % typeSize != 0) {
+        std::cout << "Voxels of mapped file are not aligned, reading it instead" << std::endl;
+        volume.mappedFile.unmap();
+        mapped = false;
+    }
     
-    if(expectedFileSize != fileSize) {
-        if(expectedFileSize * 2 == fileSize) {
-            std::cout << "Assuming 16-bit RAW file" << std::endl;
-            volume.bitDepth = 16;
-        } else {
-            std::cerr << "File size inconsistent with specified dimensions" << std::endl;
+    // open volume file
+    std::ifstream file;
+    size_t fileSize = volume.mappedFile.size();
+    if(!mapped) {
+        file.open(layout.dataFile, std::ifstream::binary);
+        if(!file) {
+            std::cerr << "Unable to open file '" << layout.dataFile << "'" << std::endl;
             return false;
         }
-    } else {
-        volume.bitDepth = 8;
+        file.seekg (0, file.end);
+        fileSize = file.tellg();
+        file.seekg (layout.dataOffset, file.beg);
     }
-
-    //
-    if(expectedFileSize >= 0xffffffffu) {
-        std::cerr << "Too many voxels. Please improve the dual mc implementation." << std::endl;
+    
+    // check consistency of file size and volume dimensions
+    if(fileSize < layout.dataOffset || fileSize - layout.dataOffset != dataSize) {
+        std::cerr << "File size inconsistent with specified dimensions" << std::endl;
         return false;
     }
     
     // initialize volume dimensions and memory
-    volume.dimX = dimX;
-    volume.dimY = dimY;
-    volume.dimZ = dimZ;
-    volume.data.resize(fileSize);
+    volume.dimX = layout.dimX;
+    volume.dimY = layout.dimY;
+    volume.dimZ = layout.dimZ;
+    volume.type = layout.type;
+    volume.numChannels = layout.numChannels;
+    volume.channel = channel;
+    if(mapped) {
+        std::vector<uint8_t>().swap(volume.data);
+        volume.voxels = volume.mappedFile.data() + layout.dataOffset;
+        return true;
+    }
+    volume.data.resize(dataSize);
+    volume.voxels = &volume.data.front();
     
     // read data
-    file.read((char*)&volume.data[0], fileSize);
+    file.read((char*)&volume.data[0], dataSize);
     
     if(!file) {
         std::cerr << "Error while reading file" << std::endl;
@@ -322,58 +726,189 @@ bool DualMCExample::loadRawFile(std::string const & fileName, int32_t dimX, int3
 
 //------------------------------------------------------------------------------
 
-void DualMCExample::writeOBJ(std::string const & fileName) const {
-    std::cout << "Writing OBJ file" << std::endl;
-    // check if we actually have an ISO surface
-    if(vertices.size () == 0 || quads.size() == 0) {
-        std::cout << "No ISO surface generated. Skipping OBJ generation." << std::endl;
-        return;
+template<class T>
+bool DualMCExample::streamSurface(AppOptions const & options, VolumeLayout const & layout,
+  std::istream & file, OBJWriter & sink, dualmc::BuildStats & stats) {
+    size_t const sliceSize = size_t(layout.dimX) * size_t(layout.dimY) * sizeof(T);
+    auto const readSlice = [&](int32_t, T * slice) {
+        return bool(file.read((char*)slice, sliceSize));
+    };
+    dualmc::DualMC<T> builder;
+    builder.setDualPointPlacement(options.useHermite ?
+        dualmc::DualPointPlacement::Hermite : dualmc::DualPointPlacement::Centroid);
+    bool const success = builder.buildStreaming(readSlice, layout.dimX, layout.dimY, layout.dimZ,
+        mapIsoValue<T>(options.isoValue), options.generateManifold, options.generateQuadSoup, sink);
+    stats = builder.getStats();
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::streamVolumeFile(AppOptions const & options, VolumeLayout const & layout) {
+    if(layout.numChannels > 1) {
+        std::cerr << "Streaming only supports single-channel volumes" << std::endl;
+        return false;
     }
     
-    // open output file
-    std::ofstream file(fileName);
+    // open volume file
+    std::ifstream file(layout.dataFile, std::ifstream::binary);
     if(!file) {
+        std::cerr << "Unable to open file '" << layout.dataFile << "'" << std::endl;
+        return false;
+    }
+    
+    // check consistency of file size and volume dimensions
+    size_t const expectedSize = size_t(layout.dimX) * size_t(layout.dimY) * size_t(layout.dimZ) *
+        getVoxelTypeSize(layout.type);
+    file.seekg (0, file.end);
+    size_t const fileSize = file.tellg();
+    file.seekg (layout.dataOffset, file.beg);
+    if(fileSize < layout.dataOffset || fileSize - layout.dataOffset != expectedSize) {
+        std::cerr << "File size inconsistent with specified dimensions" << std::endl;
+        return false;
+    }
+    
+    // open output file
+    BufferedFile objFile;
+    if(!objFile.open(options.outputFile)) {
         std::cout << "Error opening output file" << std::endl;
-        return;
+        return false;
     }
     
-    std::cout << "Generating OBJ mesh with " << vertices.size() << " vertices and "
-      << quads.size() << " quads" << std::endl;
+    std::cout << "Streaming surface" << std::endl;
     
-    // write vertices
-    for(auto const & v : vertices) {
-        file << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+    // measure extraction time
+    high_resolution_clock::time_point const startTime = high_resolution_clock::now();
+    
+    // Slices are read in order, so the file is read sequentially. Quads only
+    // reference vertices of earlier chunks, so each chunk can be written
+    // to the OBJ file right away.
+    OBJWriter sink(objFile);
+    
+    bool success = false;
+    dualmc::BuildStats stats;
+    switch(layout.type) {
+        case VoxelType::UInt8:
+            success = streamSurface<uint8_t>(options, layout, file, sink, stats);
+            break;
+        case VoxelType::UInt16:
+            success = streamSurface<uint16_t>(options, layout, file, sink, stats);
+            break;
+        case VoxelType::Int16:
+            success = streamSurface<int16_t>(options, layout, file, sink, stats);
+            break;
+        case VoxelType::Float:
+            success = streamSurface<float>(options, layout, file, sink, stats);
+            break;
+        case VoxelType::Double:
+            success = streamSurface<double>(options, layout, file, sink, stats);
+            break;
+    }
+    
+    if(!success) {
+        std::cerr << "Error while reading file" << std::endl;
+        return false;
+    }
+    
+    high_resolution_clock::time_point const endTime = high_resolution_clock::now();
+    duration<double> const diffTime = duration_cast<duration<double>>(endTime - startTime);
+    
+    std::cout << "Extraction time: " << diffTime.count() << "s" << std::endl;
+    if(options.printStats) {
+        printBuildStats(stats);
     }
+    std::cout << "Generated OBJ mesh with " << sink.getNumVertices() << " vertices and "
+      << sink.getNumQuads() << " quads" << std::endl;
     
-    // write quad indices
-    for(auto const & q : quads) {
-        file << "f " << (q.i0+1) << ' ' << (q.i1+1) << ' ' << (q.i2+1) << ' ' << (q.i3+1) << '\n';
+    if(!objFile.close()) {
+        std::cerr << "Error while writing output file" << std::endl;
+        return false;
     }
     
-    file.close();
+    return true;
 }
 
 //------------------------------------------------------------------------------
 
-DualMCExample::RadialGaussian::RadialGaussian(
-    float cX,
-    float cY,
-    float cZ,
-    float variance
-    ) : cX(cX), cY(cY), cZ(cZ) {
-        float constexpr TWO_PI = 6.283185307179586f;
-        normalization = 1.0f/sqrt(TWO_PI * variance);
-        falloff = -0.5f / variance;
+bool DualMCExample::writeMeshFile(std::string const & fileName, MeshFormat const format) const {
+    char const * const formatName = getMeshFormatName(format);
+    std::cout << "Writing " << formatName << " file" << std::endl;
+    // check if we actually have an ISO surface
+    if(vertices.size () == 0 || quads.size() == 0) {
+        std::cout << "No ISO surface generated. Skipping " << formatName << " generation." << std::endl;
+        return true;
     }
+    
+    std::cout << "Generating " << formatName << " mesh with " << vertices.size() << " vertices and "
+      << quads.size() << " quads" << std::endl;
+    
+    if(!writeMesh(fileName, format, vertices, quads)) {
+        std::cout << "Error writing output file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+DualMCExample::MappedFile::MappedFile() : address(nullptr), length(0) {}
+
+//------------------------------------------------------------------------------
+
+DualMCExample::MappedFile::~MappedFile() {
+    unmap();
+}
+
+//------------------------------------------------------------------------------
+
+bool DualMCExample::MappedFile::map(std::string const & fileName) {
+    unmap();
+#ifdef DUALMC_EXAMPLE_MMAP
+    int const fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat fileStatus;
+    if(fstat(fd, &fileStatus) != 0 || fileStatus.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t const fileSize = size_t(fileStatus.st_size);
+    void * const mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after closing the file
+    close(fd);
+    if(mapping == MAP_FAILED)
+        return false;
+    // the builder reads the volume slice by slice
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+    address = mapping;
+    length = fileSize;
+    return true;
+#else
+    (void)fileName;
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void DualMCExample::MappedFile::unmap() {
+#ifdef DUALMC_EXAMPLE_MMAP
+    if(address) {
+        munmap(address, length);
+    }
+#endif
+    address = nullptr;
+    length = 0;
+}
+
+//------------------------------------------------------------------------------
+
+uint8_t const * DualMCExample::MappedFile::data() const {
+    return static_cast<uint8_t const *>(address);
+}
 
 //------------------------------------------------------------------------------
 
-float DualMCExample::RadialGaussian::eval(float x, float y, float z) const {
-    // compute squared input point distance to gauss center
-    float const dx = x - cX;
-    float const dy = y - cY;
-    float const dz = z - cZ;
-    float const dSquared = dx * dx + dy * dy + dz * dz;
-    // compute gauss 
-    return normalization * exp(falloff * dSquared);
+size_t DualMCExample::MappedFile::size() const {
+    return length;
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 /// \date   2009
 
 // std includes
+#include <istream>
 #include <string>
 
 // stl includes
@@ -19,11 +20,18 @@
 // dual mc builder vertex and quad definitions
 #include "dualmc.h"
 
+// mesh file writers
+#include "meshwriter.h"
+
+// voxel types and volume file headers
+#include "volumefile.h"
+
 /// Example application for demonstrating the dual marching cubes builder.
 class DualMCExample {
 public:
-    /// run example
-    void run(int const argc, char** argv); 
+    /// run example. Returns false if the arguments are invalid or the
+    /// extraction failed, e.g. if any job of a batch failed.
+    bool run(int const argc, char** argv); 
     
 private:
 
@@ -33,29 +41,102 @@ private:
         int32_t dimX;
         int32_t dimY;
         int32_t dimZ;
+        /// voxel type of the raw file, which is guessed from its size if not given
+        bool hasVoxelType;
+        VoxelType voxelType;
+        /// number of interleaved channels of the raw file
+        int32_t numChannels;
+        /// extracted channel
+        int32_t channel;
+        std::string nrrdFile;
         float isoValue;
         bool generateCaffeine;
+        int32_t caffeineSize;
         bool generateQuadSoup;
         bool generateManifold;
+        unsigned int numThreads;
+        bool useGPU;
+        bool useHermite;
+        int lodLevel;
+        bool useImplicit;
+        bool reorderMesh;
+        bool streamInput;
+        bool mapInput;
+        bool printStats;
+        MeshFormat outputFormat;
         std::string outputFile;
+        std::string batchFile;
+        /// set if the help was printed instead of parsing all arguments
+        bool printHelp;
     };
 
     /// Parse program arguments.
     bool parseArgs(int const argc, char** argv, AppOptions & options);
 
-    /// Generate an example volume for the dual mc builder.
-    void generateCaffeine();
+    /// Generate an example volume for the dual mc builder with size^3 voxels.
+    /// The density is computed by the given number of threads.
+    void generateCaffeine(int32_t const size, unsigned int const numThreads);
     
-    /// Load volume from raw file.
-    bool loadRawFile(std::string const & fileName, int32_t dimX, int32_t dimY, int32_t dimZ);
+    /// Get the voxel layout of the input volume from the raw file options or
+    /// the NRRD header.
+    bool getInputLayout(AppOptions const & options, VolumeLayout & layout) const;
+
+    /// Load volume from a raw or NRRD file. Optionally, the file is memory
+    /// mapped instead of being read into memory. Multi-channel volumes keep
+    /// their interleaved channels, and the given channel is only selected
+    /// for the extraction, which reads it with a voxel stride, see
+    /// computeTypedSurface.
+    bool loadVolumeFile(VolumeLayout const & layout, int32_t const channel, bool const mapFile);
+
+    /// Extract the iso surface of a single-channel raw or NRRD file slice by
+    /// slice and write the OBJ file while extracting. The volume is never
+    /// loaded as a whole. Other output formats are not supported, as they
+    /// require the number of vertices and quads in advance.
+    bool streamVolumeFile(AppOptions const & options, VolumeLayout const & layout);
+
+    /// Stream the iso surface of a volume file with voxels of type T.
+    template<class T>
+    bool streamSurface(AppOptions const & options, VolumeLayout const & layout,
+      std::istream & file, OBJWriter & sink, dualmc::BuildStats & stats);
+
+    /// Extract the iso surfaces of the jobs of a batch manifest, which is
+    /// read from stdin for the file name "-". See runBatch.
+    bool extractBatch(AppOptions const & options);
+
+    /// Compute the iso surface of the caffeine molecule with size^3 voxels by
+    /// evaluating its density during extraction instead of generating the volume.
+    void computeImplicitCaffeine(int32_t const size, float const iso, bool const generateSoup,
+      bool const generateManifold, bool const useHermite, bool const printStats);
 
     /// Compute the iso surface for the specified iso value. Optionally generate
-    /// a quad soup.
-    void computeSurface(float const iso, bool const generateSoup, bool const generateManifold);
+    /// a quad soup. More than one thread selects the parallel builder, useGPU
+    /// the data-parallel GPU builder. useHermite places the dual points with
+    /// Hermite data. A positive lodLevel extracts that level of a pyramid of
+    /// downsampled volumes instead of the volume itself. Returns false if the
+    /// extraction failed.
+    bool computeSurface(float const iso, bool const generateSoup, bool const generateManifold,
+      unsigned int const numThreads, bool const useGPU, bool const useHermite, int const lodLevel,
+      bool const printStats);
+
+    /// Compute the iso surface of the loaded volume with voxels of type T.
+    /// The selected channel of multi-channel volumes is read in place with
+    /// the number of channels as voxel stride. See computeSurface.
+    template<class T>
+    bool computeTypedSurface(float const iso, bool const generateSoup, bool const generateManifold,
+      unsigned int const numThreads, bool const useGPU, bool const useHermite, int const lodLevel,
+      dualmc::BuildStats & stats);
+    
+    /// Reorder the quads and vertices of the extracted ISO surface for the
+    /// vertex cache of a GPU.
+    void optimizeMesh(bool const printStats);
     
-    /// Write a Wavefront OBJ model for the extracted ISO surface.
-    void writeOBJ(std::string const & fileName) const;
+    /// Write a mesh file in the given format for the extracted ISO surface.
+    /// Returns false if the file could not be written.
+    bool writeMeshFile(std::string const & fileName, MeshFormat const format) const;
     
+    /// Print the statistics of an extraction.
+    void printBuildStats(dualmc::BuildStats const & stats) const;
+
     /// Print program arguments.
     void printArgs() const;
     
@@ -63,39 +144,53 @@ private:
     void printHelpHint() const;
    
 private:
+    /// Read-only memory mapping of a file.
+    class MappedFile {
+    public:
+        /// Create an empty mapping.
+        MappedFile();
+        /// Unmap the file.
+        ~MappedFile();
+        /// Map the whole file. Returns false if the file could not be mapped
+        /// or memory mapping is not supported on this platform.
+        bool map(std::string const & fileName);
+        /// Unmap the file.
+        void unmap();
+        /// Get the mapped file contents.
+        uint8_t const * data() const;
+        /// Get the size of the mapped file.
+        size_t size() const;
+    private:
+        // mappings are not copyable
+        MappedFile(MappedFile const &);
+        MappedFile & operator=(MappedFile const &);
+        // mapped memory and its size
+        void * address;
+        size_t length;
+    };
+
     /// struct for volume data information
     struct Volume {
         // volume grid extents
         int32_t dimX;
         int32_t dimY;
         int32_t dimZ;
-        // bit depth, should be 8 or 16
-        int32_t bitDepth;
-        /// volume data
+        /// voxel type
+        VoxelType type;
+        /// number of interleaved channels and the extracted channel
+        int32_t numChannels;
+        int32_t channel;
+        /// volume data with all channels, unless the volume is memory mapped
         std::vector<uint8_t> data;
+        /// memory mapped raw file
+        MappedFile mappedFile;
+        /// first voxel, which either points into data or the mapped file
+        uint8_t const * voxels;
     };
        
     /// example volume
     Volume volume;
     
-    /// Class for a volumetric sphere with gaussian fall-off.
-    class RadialGaussian {
-    public:
-        /// Initialize with center coordinates and half density radius.
-        RadialGaussian(float cX, float cY, float cZ, float variance);
-        // evaluate the sphere function
-        float eval(float x, float y, float z) const;
-    private:
-        // Coordinates of the sphere center.
-        float cX;
-        float cY;
-        float cZ;
-        // precomputed factors
-        float normalization;
-        float falloff;
-        
-    };
-
     /// array of vertices for the extracted surface
     std::vector<dualmc::Vertex> vertices;
     
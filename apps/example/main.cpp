@@ -13,6 +13,5 @@
 
 int main( int argc, char** argv) {
     DualMCExample example;
-    example.run(argc, argv);
-    return 0;
+    return example.run(argc, argv) ? 0 : 1;
 }
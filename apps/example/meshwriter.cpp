@@ -0,0 +1,390 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   meshwriter.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// compact mesh encoder
+#include "dualmc_compact.h"
+
+// main include
+#include "meshwriter.h"
+
+namespace {
+
+/// size of the file buffer
+size_t constexpr BUFFER_SIZE = 1 << 20;
+
+/// maximum number of characters of a formatted number
+size_t constexpr MAX_NUMBER_LENGTH = 32;
+
+//------------------------------------------------------------------------------
+
+/// Format an unsigned integer and return the end of the formatted number.
+char * formatUnsigned(uint64_t value, char * out) {
+    char digits[20];
+    int numDigits = 0;
+    do {
+        digits[numDigits++] = char('0' + value % 10);
+        value /= 10;
+    } while(value != 0);
+    while(numDigits > 0) {
+        *out++ = digits[--numDigits];
+    }
+    return out;
+}
+
+//------------------------------------------------------------------------------
+
+/// Format a float like std::ostream with default settings, i.e. like
+/// printf with %g, and return the end of the formatted number.
+char * formatFloat(float const value, char * out) {
+    // six significant digits
+    static double const powersOfTen[] = {1e-5,1e-4,1e-3,1e-2,1e-1,1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9};
+    double const v = value;
+    if(v == 0.0 && !std::signbit(v)) {
+        *out++ = '0';
+        return out;
+    }
+
+    // Vertex coordinates are positive and in the fixed point range of %g.
+    // All other values are left to printf.
+    if(!(v >= 1e-4 && v < 1e6)) {
+        return out + std::snprintf(out, MAX_NUMBER_LENGTH, "%g", v);
+    }
+
+    // decimal exponent of the leading digit
+    int exponent = -4;
+    while(v >= powersOfTen[exponent + 6]) {
+        ++exponent;
+    }
+
+    // Round to six significant digits. The scaled value is exact for the
+    // decimal ties of floats, so rounding to nearest even matches printf.
+    double scaled = std::nearbyint(v * powersOfTen[10 - exponent]);
+    if(scaled >= 1e6) {
+        ++exponent;
+        if(exponent >= 6) {
+            return out + std::snprintf(out, MAX_NUMBER_LENGTH, "%g", v);
+        }
+        scaled = std::nearbyint(v * powersOfTen[10 - exponent]);
+    }
+
+    // the digits after the decimal point without trailing zeros
+    uint64_t digits = uint64_t(scaled);
+    int numFractionDigits = 5 - exponent;
+    while(numFractionDigits > 0 && digits % 10 == 0) {
+        digits /= 10;
+        --numFractionDigits;
+    }
+    if(numFractionDigits == 0) {
+        return formatUnsigned(digits, out);
+    }
+
+    // insert the decimal point
+    char buffer[24];
+    char * const end = formatUnsigned(digits, buffer);
+    int const numDigits = int(end - buffer);
+    if(numDigits <= numFractionDigits) {
+        *out++ = '0';
+        *out++ = '.';
+        for(int i = numDigits; i < numFractionDigits; ++i) {
+            *out++ = '0';
+        }
+        std::memcpy(out, buffer, numDigits);
+        return out + numDigits;
+    }
+    int const numIntegerDigits = numDigits - numFractionDigits;
+    std::memcpy(out, buffer, numIntegerDigits);
+    out += numIntegerDigits;
+    *out++ = '.';
+    std::memcpy(out, buffer + numIntegerDigits, numFractionDigits);
+    return out + numFractionDigits;
+}
+
+//------------------------------------------------------------------------------
+
+/// Check whether the machine stores numbers in little endian byte order.
+bool isLittleEndian() {
+    uint16_t const value = 1;
+    uint8_t firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    return firstByte == 1;
+}
+
+//------------------------------------------------------------------------------
+
+/// Write a binary PLY file.
+void writePLY(
+    BufferedFile & file,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    ) {
+    std::string header("ply\nformat ");
+    header += isLittleEndian() ? "binary_little_endian" : "binary_big_endian";
+    header += " 1.0\nelement vertex ";
+    header += std::to_string(vertices.size());
+    header += "\nproperty float x\nproperty float y\nproperty float z\nelement face ";
+    header += std::to_string(quads.size());
+    header += "\nproperty list uchar int vertex_indices\nend_header\n";
+    file.write(header.data(), header.size());
+
+    // vertices have the layout of the PLY vertex element
+    static_assert(sizeof(dualmc::Vertex) == 3 * sizeof(float), "Unexpected vertex layout");
+    file.write(vertices.data(), vertices.size() * sizeof(dualmc::Vertex));
+
+    // faces are prefixed by their number of indices
+    size_t constexpr faceSize = 1 + 4 * sizeof(int32_t);
+    for(auto const & q : quads) {
+        char * const face = file.reserve(faceSize);
+        int32_t const indices[4] = {q.i0, q.i1, q.i2, q.i3};
+        face[0] = 4;
+        std::memcpy(face + 1, indices, sizeof(indices));
+        file.commit(faceSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/// Write a raw dump of the vertex and quad arrays.
+void writeRaw(
+    BufferedFile & file,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    ) {
+    uint64_t const counts[2] = {vertices.size(), quads.size()};
+    file.write(counts, sizeof(counts));
+    file.write(vertices.data(), vertices.size() * sizeof(dualmc::Vertex));
+    file.write(quads.data(), quads.size() * sizeof(dualmc::Quad));
+}
+
+//------------------------------------------------------------------------------
+
+/// Write a compact mesh stream with 8-bit vertex offsets.
+void writeCompact(
+    BufferedFile & file,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    ) {
+    std::vector<uint8_t> stream;
+    dualmc::CompactMeshSink sink(stream);
+    sink.addVertices(vertices.data(), vertices.size());
+    sink.addQuads(quads.data(), quads.size());
+    file.write(stream.data(), stream.size());
+}
+
+} // END: anonymous namespace
+
+//------------------------------------------------------------------------------
+
+bool parseMeshFormat(char const * name, MeshFormat & format) {
+    if(std::strcmp(name, "obj") == 0) {
+        format = MeshFormat::OBJ;
+    } else if(std::strcmp(name, "ply") == 0) {
+        format = MeshFormat::PLY;
+    } else if(std::strcmp(name, "raw") == 0) {
+        format = MeshFormat::RAW;
+    } else if(std::strcmp(name, "compact") == 0) {
+        format = MeshFormat::COMPACT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+char const * getMeshFormatName(MeshFormat const format) {
+    switch(format) {
+        case MeshFormat::OBJ: return "OBJ";
+        case MeshFormat::PLY: return "PLY";
+        case MeshFormat::RAW: return "RAW";
+        case MeshFormat::COMPACT: return "compact";
+    }
+    return "";
+}
+
+//------------------------------------------------------------------------------
+
+bool writeMesh(
+    std::string const & fileName,
+    MeshFormat const format,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    ) {
+    BufferedFile file;
+    return writeMesh(file, fileName, format, vertices, quads);
+}
+
+//------------------------------------------------------------------------------
+
+bool writeMesh(
+    BufferedFile & file,
+    std::string const & fileName,
+    MeshFormat const format,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    ) {
+    if(!file.open(fileName))
+        return false;
+    if(format == MeshFormat::OBJ) {
+        OBJWriter writer(file);
+        writer.addVertices(vertices.data(), vertices.size());
+        writer.addQuads(quads.data(), quads.size());
+    } else if(format == MeshFormat::PLY) {
+        writePLY(file, vertices, quads);
+    } else if(format == MeshFormat::COMPACT) {
+        writeCompact(file, vertices, quads);
+    } else {
+        writeRaw(file, vertices, quads);
+    }
+    return file.close();
+}
+
+//------------------------------------------------------------------------------
+
+BufferedFile::BufferedFile() : file(nullptr), used(0), failed(false) {}
+
+//------------------------------------------------------------------------------
+
+BufferedFile::~BufferedFile() {
+    close();
+}
+
+//------------------------------------------------------------------------------
+
+bool BufferedFile::open(std::string const & fileName) {
+    close();
+    file = std::fopen(fileName.c_str(), "wb");
+    if(!file)
+        return false;
+    buffer.resize(BUFFER_SIZE);
+    used = 0;
+    failed = false;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+bool BufferedFile::close() {
+    if(!file)
+        return false;
+    flush();
+    if(std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    return !failed;
+}
+
+//------------------------------------------------------------------------------
+
+void BufferedFile::write(void const * data, size_t const size) {
+    if(used + size <= buffer.size()) {
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+        return;
+    }
+    flush();
+    if(size >= buffer.size()) {
+        if(std::fwrite(data, 1, size, file) != size) {
+            failed = true;
+        }
+        return;
+    }
+    std::memcpy(buffer.data(), data, size);
+    used = size;
+}
+
+//------------------------------------------------------------------------------
+
+char * BufferedFile::reserve(size_t const size) {
+    if(used + size > buffer.size()) {
+        flush();
+        if(size > buffer.size()) {
+            buffer.resize(size);
+        }
+    }
+    return buffer.data() + used;
+}
+
+//------------------------------------------------------------------------------
+
+void BufferedFile::commit(size_t const size) {
+    used += size;
+}
+
+//------------------------------------------------------------------------------
+
+void BufferedFile::flush() {
+    if(used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+        failed = true;
+    }
+    used = 0;
+}
+
+//------------------------------------------------------------------------------
+
+OBJWriter::OBJWriter(BufferedFile & file) : file(file), numVertices(0), numQuads(0) {}
+
+//------------------------------------------------------------------------------
+
+void OBJWriter::addVertices(dualmc::Vertex const * vertices, size_t const numVertices) {
+    for(size_t i = 0; i < numVertices; ++i) {
+        dualmc::Vertex const & v = vertices[i];
+        char * const line = file.reserve(4 * MAX_NUMBER_LENGTH);
+        char * out = line;
+        *out++ = 'v';
+        *out++ = ' ';
+        out = formatFloat(v.x, out);
+        *out++ = ' ';
+        out = formatFloat(v.y, out);
+        *out++ = ' ';
+        out = formatFloat(v.z, out);
+        *out++ = '\n';
+        file.commit(out - line);
+    }
+    this->numVertices += numVertices;
+}
+
+//------------------------------------------------------------------------------
+
+void OBJWriter::addQuads(dualmc::Quad const * quads, size_t const numQuads) {
+    for(size_t i = 0; i < numQuads; ++i) {
+        dualmc::Quad const & q = quads[i];
+        char * const line = file.reserve(5 * MAX_NUMBER_LENGTH);
+        char * out = line;
+        *out++ = 'f';
+        *out++ = ' ';
+        out = formatUnsigned(uint64_t(q.i0) + 1, out);
+        *out++ = ' ';
+        out = formatUnsigned(uint64_t(q.i1) + 1, out);
+        *out++ = ' ';
+        out = formatUnsigned(uint64_t(q.i2) + 1, out);
+        *out++ = ' ';
+        out = formatUnsigned(uint64_t(q.i3) + 1, out);
+        *out++ = '\n';
+        file.commit(out - line);
+    }
+    this->numQuads += numQuads;
+}
+
+//------------------------------------------------------------------------------
+
+size_t OBJWriter::getNumVertices() const {
+    return numVertices;
+}
+
+//------------------------------------------------------------------------------
+
+size_t OBJWriter::getNumQuads() const {
+    return numQuads;
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef MESHWRITER_H_INCLUDED
+#define MESHWRITER_H_INCLUDED
+
+/// \file   meshwriter.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cstdio>
+
+// std includes
+#include <string>
+
+// stl includes
+#include <vector>
+
+// dual mc builder vertex and quad definitions
+#include "dualmc.h"
+
+/// Supported mesh file formats.
+enum class MeshFormat {
+    /// Wavefront OBJ text file
+    OBJ,
+    /// binary PLY file in native byte order
+    PLY,
+    /// Raw dump of the vertex and quad arrays in native byte order: the
+    /// number of vertices and quads as 64-bit unsigned integers followed by
+    /// three 32-bit floats per vertex and four 32-bit indices per quad.
+    RAW,
+    /// compact stream with quantized vertices and predicted quad indices,
+    /// see dualmc::CompactMeshState
+    COMPACT
+};
+
+/// Parse a mesh format name, which is one of obj, ply, raw, or compact.
+bool parseMeshFormat(char const * name, MeshFormat & format);
+
+/// Get the name of a mesh format.
+char const * getMeshFormatName(MeshFormat const format);
+
+/// Write a mesh file in the given format.
+bool writeMesh(
+    std::string const & fileName,
+    MeshFormat const format,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    );
+
+/// \class  BufferedFile
+/// Output file, which collects small writes in a large buffer. Writes larger
+/// than the buffer are passed directly to the file.
+class BufferedFile {
+public:
+    /// Create a closed file.
+    BufferedFile();
+
+    /// Close the file.
+    ~BufferedFile();
+
+    /// Open a file for writing.
+    bool open(std::string const & fileName);
+
+    /// Flush the buffer and close the file. Returns false if any write failed.
+    bool close();
+
+    /// Write a block of memory.
+    void write(void const * data, size_t const size);
+
+    /// Get a pointer to at least size bytes of buffer space. The space is
+    /// appended to the file by commit.
+    char * reserve(size_t const size);
+
+    /// Append size bytes of the space returned by the last reserve call.
+    void commit(size_t const size);
+
+private:
+    // files are not copyable
+    BufferedFile(BufferedFile const &);
+    BufferedFile & operator=(BufferedFile const &);
+
+    /// Write the buffer to the file.
+    void flush();
+
+    /// output file
+    std::FILE * file;
+    /// buffered data
+    std::vector<char> buffer;
+    /// number of used bytes in the buffer
+    size_t used;
+    /// set if a write failed
+    bool failed;
+};
+
+/// Write a mesh file in the given format with the given file, whose buffer is
+/// reused when writing many files.
+bool writeMesh(
+    BufferedFile & file,
+    std::string const & fileName,
+    MeshFormat const format,
+    std::vector<dualmc::Vertex> const & vertices,
+    std::vector<dualmc::Quad> const & quads
+    );
+
+/// \class  OBJWriter
+/// Mesh sink, which writes vertices and quads to an OBJ file as soon as they
+/// are extracted. Numbers are formatted like std::ostream does by default,
+/// but without the overhead of stream formatting.
+class OBJWriter {
+public:
+    /// Initialize with the output file.
+    explicit OBJWriter(BufferedFile & file);
+
+    /// write vertices
+    void addVertices(dualmc::Vertex const * vertices, size_t const numVertices);
+
+    /// write quads
+    void addQuads(dualmc::Quad const * quads, size_t const numQuads);
+
+    /// Get the number of written vertices.
+    size_t getNumVertices() const;
+
+    /// Get the number of written quads.
+    size_t getNumQuads() const;
+
+private:
+    /// output file
+    BufferedFile & file;
+    /// number of written vertices
+    size_t numVertices;
+    /// number of written quads
+    size_t numQuads;
+};
+
+#endif // MESHWRITER_H_INCLUDED
@@ -0,0 +1,259 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+/// \file   volumefile.cpp
+/// \author Dominik Wodniok
+/// \date   2026
+
+// C libs
+#include <cstdlib>
+#include <cstring>
+
+// std libs
+#include <fstream>
+#include <sstream>
+
+// main include
+#include "volumefile.h"
+
+namespace {
+
+/// Remove leading and trailing white space.
+std::string trim(std::string const & text) {
+    size_t const first = text.find_first_not_of(" \t\r");
+    if(first == std::string::npos)
+        return std::string();
+    size_t const last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+//------------------------------------------------------------------------------
+
+/// Parse a NRRD type name. NRRD allows several spellings of each type.
+bool parseNrrdType(std::string const & name, VoxelType & type) {
+    char const * const uint8Names[] = {"uchar", "unsigned char", "uint8", "uint8_t"};
+    char const * const uint16Names[] = {"ushort", "unsigned short", "unsigned short int", "uint16", "uint16_t"};
+    char const * const int16Names[] = {"short", "short int", "signed short", "signed short int", "int16", "int16_t"};
+    for(char const * typeName : uint8Names) {
+        if(name == typeName) {
+            type = VoxelType::UInt8;
+            return true;
+        }
+    }
+    for(char const * typeName : uint16Names) {
+        if(name == typeName) {
+            type = VoxelType::UInt16;
+            return true;
+        }
+    }
+    for(char const * typeName : int16Names) {
+        if(name == typeName) {
+            type = VoxelType::Int16;
+            return true;
+        }
+    }
+    if(name == "float") {
+        type = VoxelType::Float;
+    } else if(name == "double") {
+        type = VoxelType::Double;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+/// Check if the platform stores multi-byte values in little endian order.
+bool isLittleEndian() {
+    uint16_t const one = 1;
+    return *reinterpret_cast<uint8_t const *>(&one) == 1;
+}
+
+//------------------------------------------------------------------------------
+
+/// Get the size of a file in bytes, or -1 if it cannot be opened.
+long long getFileSize(std::string const & fileName) {
+    std::ifstream file(fileName, std::ifstream::binary | std::ifstream::ate);
+    if(!file)
+        return -1;
+    return (long long)file.tellg();
+}
+
+} // END: anonymous namespace
+
+//------------------------------------------------------------------------------
+
+bool parseVoxelType(char const * name, VoxelType & type) {
+    if(std::strcmp(name, "uint8") == 0) {
+        type = VoxelType::UInt8;
+    } else if(std::strcmp(name, "uint16") == 0) {
+        type = VoxelType::UInt16;
+    } else if(std::strcmp(name, "int16") == 0) {
+        type = VoxelType::Int16;
+    } else if(std::strcmp(name, "float") == 0) {
+        type = VoxelType::Float;
+    } else if(std::strcmp(name, "double") == 0) {
+        type = VoxelType::Double;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+char const * getVoxelTypeName(VoxelType const type) {
+    switch(type) {
+        case VoxelType::UInt8: return "uint8";
+        case VoxelType::UInt16: return "uint16";
+        case VoxelType::Int16: return "int16";
+        case VoxelType::Float: return "float";
+        case VoxelType::Double: return "double";
+    }
+    return "";
+}
+
+//------------------------------------------------------------------------------
+
+size_t getVoxelTypeSize(VoxelType const type) {
+    switch(type) {
+        case VoxelType::UInt8: return 1;
+        case VoxelType::UInt16: return 2;
+        case VoxelType::Int16: return 2;
+        case VoxelType::Float: return 4;
+        case VoxelType::Double: return 8;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+bool readNrrdHeader(std::string const & fileName, VolumeLayout & layout, std::string & error) {
+    std::ifstream file(fileName, std::ifstream::binary);
+    if(!file) {
+        error = "unable to open file";
+        return false;
+    }
+    std::string line;
+    if(!std::getline(file, line) || line.compare(0, 7, "NRRD000") != 0) {
+        error = "missing NRRD magic";
+        return false;
+    }
+
+    // The fields end with an empty line, which is followed by the data of
+    // attached headers, or with the end of detached headers.
+    bool hasType = false;
+    int dimension = 0;
+    std::string sizes;
+    std::string encoding = "raw";
+    std::string endian;
+    std::string dataFile;
+    long long byteSkip = 0;
+    bool attached = false;
+    while(std::getline(file, line)) {
+        line = trim(line);
+        if(line.empty()) {
+            attached = true;
+            break;
+        }
+        if(line[0] == '#')
+            continue;
+        size_t const separator = line.find(": ");
+        // key/value pairs with := carry no layout information
+        if(separator == std::string::npos)
+            continue;
+        std::string const field = line.substr(0, separator);
+        std::string const value = trim(line.substr(separator + 2));
+        if(field == "type") {
+            if(!parseNrrdType(value, layout.type)) {
+                error = "unsupported type '" + value + "'";
+                return false;
+            }
+            hasType = true;
+        } else if(field == "dimension") {
+            dimension = std::atoi(value.c_str());
+        } else if(field == "sizes") {
+            sizes = value;
+        } else if(field == "encoding") {
+            encoding = value;
+        } else if(field == "endian") {
+            endian = value;
+        } else if(field == "data file" || field == "datafile") {
+            dataFile = value;
+        } else if(field == "byte skip" || field == "byteskip") {
+            byteSkip = std::atoll(value.c_str());
+        } else if(field == "line skip" || field == "lineskip") {
+            if(std::atoi(value.c_str()) != 0) {
+                error = "line skip is not supported";
+                return false;
+            }
+        }
+    }
+
+    // check the layout of the voxels
+    if(!hasType) {
+        error = "missing type";
+        return false;
+    }
+    if(encoding != "raw") {
+        error = "unsupported encoding '" + encoding + "'";
+        return false;
+    }
+    if(getVoxelTypeSize(layout.type) > 1 && !endian.empty() &&
+      endian != (isLittleEndian() ? "little" : "big")) {
+        error = "byte order differs from the platform";
+        return false;
+    }
+    if(dimension != 3 && dimension != 4) {
+        error = "only three and four dimensional volumes are supported";
+        return false;
+    }
+    std::istringstream sizeValues(sizes);
+    layout.numChannels = 1;
+    if(dimension == 4)
+        sizeValues >> layout.numChannels;
+    sizeValues >> layout.dimX >> layout.dimY >> layout.dimZ;
+    if(!sizeValues || layout.numChannels < 1 || layout.dimX < 1 || layout.dimY < 1 || layout.dimZ < 1) {
+        error = "invalid sizes '" + sizes + "'";
+        return false;
+    }
+
+    // locate the voxels
+    long long headerSize = 0;
+    if(dataFile.empty()) {
+        if(!attached) {
+            error = "missing data";
+            return false;
+        }
+        layout.dataFile = fileName;
+        headerSize = (long long)file.tellg();
+    } else if(dataFile == "LIST" || dataFile.find('%') != std::string::npos) {
+        error = "multiple data files are not supported";
+        return false;
+    } else if(dataFile[0] == '/') {
+        layout.dataFile = dataFile;
+    } else {
+        // relative data files are located next to the header
+        size_t const directoryEnd = fileName.find_last_of("/\\");
+        layout.dataFile = directoryEnd == std::string::npos ?
+            dataFile : fileName.substr(0, directoryEnd + 1) + dataFile;
+    }
+    if(byteSkip == -1) {
+        // the voxels are stored at the end of the data file
+        long long const fileSize = getFileSize(layout.dataFile);
+        long long const dataSize = (long long)(size_t(layout.numChannels) * size_t(layout.dimX) *
+            size_t(layout.dimY) * size_t(layout.dimZ) * getVoxelTypeSize(layout.type));
+        byteSkip = fileSize < 0 ? -1 : fileSize - dataSize;
+    } else if(byteSkip >= 0) {
+        byteSkip += headerSize;
+    }
+    if(byteSkip < 0) {
+        error = "invalid byte skip";
+        return false;
+    }
+    layout.dataOffset = size_t(byteSkip);
+    return true;
+}
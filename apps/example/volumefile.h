@@ -0,0 +1,93 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef VOLUMEFILE_H_INCLUDED
+#define VOLUMEFILE_H_INCLUDED
+
+/// \file   volumefile.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// std includes
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+/// Supported voxel data types.
+enum class VoxelType {
+    UInt8,
+    UInt16,
+    Int16,
+    Float,
+    Double
+};
+
+/// Parse a voxel type name, which is one of uint8, uint16, int16, float, or double.
+bool parseVoxelType(char const * name, VoxelType & type);
+
+/// Get the name of a voxel type.
+char const * getVoxelTypeName(VoxelType const type);
+
+/// Get the size of a voxel type in bytes.
+size_t getVoxelTypeSize(VoxelType const type);
+
+/// Layout of the voxels in a volume file. Multi-channel volumes store the
+/// channels of each voxel next to each other.
+struct VolumeLayout {
+    /// file containing the voxels, which may differ from the header file
+    std::string dataFile;
+    int32_t dimX;
+    int32_t dimY;
+    int32_t dimZ;
+    int32_t numChannels;
+    VoxelType type;
+    /// offset of the first voxel in the data file in bytes
+    size_t dataOffset;
+};
+
+/// Read the header of a NRRD file (.nrrd) or detached NRRD header (.nhdr).
+/// Only raw encoded volumes in native byte order with three dimensions, or
+/// four dimensions with the channels as first axis, are supported. Returns
+/// false and sets error if the header is invalid or not supported.
+bool readNrrdHeader(std::string const & fileName, VolumeLayout & layout, std::string & error);
+
+/// Map an iso value to the voxel type of a volume. Integer types map [0,1]
+/// to their whole value range, and the iso value is clamped to [0,1].
+/// Floating point types use the iso value as is.
+template<class T>
+T mapIsoValue(float const iso);
+
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+template<class T> inline
+T mapIsoValue(float iso, std::true_type) {
+    // invalid iso values are mapped to the lowest value
+    if(iso > 1.0f)
+        iso = 1.0f;
+    else if(iso < 0.0f || iso != iso)
+        iso = 0.0f;
+    float const lowest = std::numeric_limits<T>::lowest();
+    float const highest = std::numeric_limits<T>::max();
+    return T(lowest + iso * (highest - lowest));
+}
+
+template<class T> inline
+T mapIsoValue(float const iso, std::false_type) {
+    return T(iso);
+}
+
+} // END: namespace detail
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T mapIsoValue(float const iso) {
+    return detail::mapIsoValue<T>(iso, std::is_integral<T>());
+}
+
+#endif // VOLUMEFILE_H_INCLUDED
@@ -216,22 +216,7 @@ void GenerateTablesApp::writeDualMCTable(std::vector<uint32_t> const & dualPoint
         for(int i = 0; i < 4; ++i) {
             if(i > 0)
                 file << ", ";
-            uint32_t code = codes[i];
-            if(code != 0) {
-                // extract edge codes
-                bool wroteFirstEdge = false;
-                int edge = 0;
-                for(; code != 0; code >>= 1, ++edge) {
-                    if((code & 1) == 1) {
-                        if(wroteFirstEdge)
-                            file << '|';
-                        file << "EDGE" << edge;
-                        wroteFirstEdge = true;
-                    }
-                }
-            } else {
-                file << '0';
-            }
+            writeDualPointCode(file, codes[i]);
         }
         if(cube < 255)
             file << "},";
@@ -243,6 +228,26 @@ void GenerateTablesApp::writeDualMCTable(std::vector<uint32_t> const & dualPoint
     file.close();
 }
 
+//------------------------------------------------------------------------------
+
+void GenerateTablesApp::writeDualPointCode(std::ostream & file, uint32_t code) {
+    if(code != 0) {
+        // extract edge codes
+        bool wroteFirstEdge = false;
+        int edge = 0;
+        for(; code != 0; code >>= 1, ++edge) {
+            if((code & 1) == 1) {
+                if(wroteFirstEdge)
+                    file << '|';
+                file << "EDGE" << edge;
+                wroteFirstEdge = true;
+            }
+        }
+    } else {
+        file << '0';
+    }
+}
+
 //------------------------------------------------------------------------------
 // Code for auxiliary manifold dual marching cubes tables
 
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <map>
+#include <ostream>
 #include <vector>
 
 /// Application class for generating the dual marching cubes and manifold
@@ -53,6 +54,9 @@ private:
     void generateDualMCTable(std::vector<uint32_t> & dualPointsList);
     void writeDualMCTable(std::vector<uint32_t> const & dualPointsList);
     
+    /// Write a dual point code as disjunction of its edge codes.
+    static void writeDualPointCode(std::ostream & file, uint32_t code);
+    
     /// Table for retrieving the edges adjacent to a cube corner.
     static uint32_t const cornerEdges[8][3];
 };
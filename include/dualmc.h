@@ -11,16 +11,42 @@
 /// \date   2009
 
 // c includes
+#include <cstddef>
 #include <cstdint>
 
 // stl includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+// executor used by the parallel build functions
+#include "dualmc_executor.h"
+
+// vectorized cell classification kernels
+#include "dualmc_simd.h"
+
+// min/max bricks for skipping empty regions
+#include "dualmc_bricks.h"
+
+// sparse volumes made from bricks
+#include "dualmc_sparse.h"
+
+// quadratic error functions for Hermite dual points
+#include "dualmc_qef.h"
+
+// lookup tables generated at compile time
+#include "dualmc_tables.h"
+
 namespace dualmc {
     
 
 typedef float VertexComponentsType;
+/// default vertex index type of quads
 typedef int32_t QuadIndexType;
 
 /// vertex structure for dual points
@@ -33,24 +59,152 @@ struct Vertex {
     
     /// initializing constructor
     Vertex(Vertex const & v);
+
+    /// assignment operator
+    Vertex & operator=(Vertex const & v);
     
     // components
     VertexComponentsType x,y,z;
 };
 
-/// quad indices structure
-struct Quad {
+/// quad indices structure for a given vertex index type
+template<class IndexType> struct BasicQuad {
     /// non-initializing constructor
-    Quad();
+    BasicQuad();
     
     /// initializing constructor
-    Quad(QuadIndexType i0, QuadIndexType i1,QuadIndexType i2, QuadIndexType i3);
+    BasicQuad(IndexType i0, IndexType i1,IndexType i2, IndexType i3);
     
     // quad indices
-    QuadIndexType i0,i1,i2,i3;
+    IndexType i0,i1,i2,i3;
     
 };
 
+/// quad with the default 32-bit vertex indices
+typedef BasicQuad<QuadIndexType> Quad;
+
+/// \class  BasicVectorMeshSink
+/// Mesh sink, which appends the vertices and quads to vectors.
+///
+/// The build functions taking a mesh sink pass the mesh in chunks as soon as
+/// they are complete, so it can be written to its final destination without
+/// keeping the whole mesh in memory. Any type can be used as mesh sink as
+/// long as it provides the same two functions, where IndexType is the vertex
+/// index type of the DualMC builder:
+///  - void addVertices(Vertex const * vertices, size_t numVertices)
+///  - void addQuads(BasicQuad<IndexType> const * quads, size_t numQuads)
+/// Chunks are passed in order. Quads refer to vertices by their index among
+/// all vertices passed so far and only reference vertices, which have
+/// already been passed.
+template<class IndexType> class BasicVectorMeshSink {
+public:
+    /// Initializing constructor. The vectors should be empty, as quad indices
+    /// count from the first vertex passed to the sink.
+    BasicVectorMeshSink(std::vector<Vertex> & vertices, std::vector<BasicQuad<IndexType>> & quads);
+
+    /// Append vertices.
+    void addVertices(Vertex const * vertices, size_t const numVertices);
+
+    /// Append quads.
+    void addQuads(BasicQuad<IndexType> const * quads, size_t const numQuads);
+
+    /// Get the vertex list.
+    std::vector<Vertex> & getVertices();
+
+    /// Get the quad list.
+    std::vector<BasicQuad<IndexType>> & getQuads();
+
+private:
+    /// vertex list the vertices are appended to
+    std::vector<Vertex> & vertices;
+    /// quad list the quads are appended to
+    std::vector<BasicQuad<IndexType>> & quads;
+};
+
+/// mesh sink for quads with the default 32-bit vertex indices
+typedef BasicVectorMeshSink<QuadIndexType> VectorMeshSink;
+
+/// Statistics are only collected if DUALMC_ENABLE_STATS is defined before
+/// including this file. Otherwise the counting code is compiled out.
+#ifdef DUALMC_ENABLE_STATS
+#define DUALMC_STATS(statement) statement
+#else
+#define DUALMC_STATS(statement)
+#endif
+
+/// \class  BuildStats
+/// Counters and phase timings of an extraction, see DualMC::getStats.
+/// For parallel builds the phase times are summed over all slabs, so they
+/// may exceed the total wall time.
+struct BuildStats {
+    /// clock used for the phase timings
+    typedef std::chrono::steady_clock Clock;
+
+    /// Initialize all counters and times with zero.
+    BuildStats();
+
+    /// Check whether statistics are compiled in.
+    static bool isEnabled();
+
+    /// Get the seconds passed since the given time point.
+    static double secondsSince(Clock::time_point const start);
+
+    /// Set all counters and times to zero.
+    void reset();
+
+    /// Add the counters and times of other statistics.
+    void add(BuildStats const & other);
+
+    /// number of cell edges crossed by the iso surface, i.e. generated quads
+    uint64_t crossedEdges;
+    /// number of computed dual points
+    uint64_t dualPointsComputed;
+    /// number of shared dual points, which were looked up instead of computed
+    uint64_t dualPointsReused;
+    /// number of cube codes inverted by manifold dual marching cubes
+    uint64_t manifoldInversions;
+    /// seconds spent on classifying cells
+    double classificationTime;
+    /// seconds spent on computing dual points and generating quads
+    double quadGenerationTime;
+    /// seconds spent on stitching the slabs of a parallel build
+    double mergeTime;
+    /// wall time of the whole extraction in seconds
+    double totalTime;
+};
+
+/// Methods for finding the shared index of an already computed dual point.
+enum class SharedVertexEngine {
+    /// Dense index array covering the two cell layers, which can be
+    /// referenced by the quads of a single layer of cell edges.
+    SliceCache,
+    /// Hash map over all dual points. Only kept for benchmarking.
+    HashMap
+};
+
+/// Methods for placing the dual point of a patch inside its cell.
+enum class DualPointPlacement {
+    /// Mean of the edge intersections of the patch.
+    Centroid,
+    /// Minimizer of the quadratic error function of the planes through the
+    /// edge intersections, whose normals are interpolated from central
+    /// difference gradients, as in Dual Contouring of Hermite Data.
+    /// Reproduces sharp features, which the centroid rounds off.
+    Hermite
+};
+
+// data-parallel builder sharing the lookup tables, see dualmc_gpu.h
+template<class T, class IndexType> class DualMCGPU;
+
+// builder re-extracting edited bricks, see dualmc_incremental.h
+template<class T, class IndexType> class DualMCIncremental;
+
+// builder extracting levels of a volume pyramid, see dualmc_lod.h
+template<class T, class IndexType> class DualMCLod;
+
+// table of the dual point kernels, see dualmc_tables.tpp
+template<class Builder, class Sequence> struct DualPointKernelTable;
+
 /// \class  DualMC
 /// \author Dominik Wodniok
 /// \date   2009
@@ -63,10 +217,70 @@ struct Quad {
 /// The class optionally can guarantee manifold meshes by taking the Manifold
 /// Dual Marching Cubes approach from Rephael Wenger as described in
 /// chapter 3.3.5 of his book "Isosurfaces: Geometry, Topology, and Algorithms".
-template<class T> class DualMC {
+/// The vertex index type of the generated quads can be selected with
+/// IndexType. The default are 32-bit indices. For meshes with more than
+/// 2^31 vertices, a 64-bit type like int64_t has to be used.
+template<class T, class IndexType = QuadIndexType> class DualMC {
 public:
     // typedefs
     typedef T VolumeDataType;
+    typedef IndexType QuadIndexType;
+    typedef BasicQuad<IndexType> Quad;
+    typedef BasicVectorMeshSink<IndexType> VectorMeshSink;
+
+    /// Default constructor.
+    DualMC();
+
+    /// Select the method for finding shared dual points.
+    /// The default is SharedVertexEngine::SliceCache.
+    void setSharedVertexEngine(SharedVertexEngine const engine);
+
+    /// Select the method for placing dual points.
+    /// The default is DualPointPlacement::Centroid. Hermite placement is not
+    /// supported by DualMCGPU.
+    void setDualPointPlacement(DualPointPlacement const placement);
+
+    /// Set optional min/max bricks, which allow to skip regions of the volume
+    /// that are not intersected by the iso surface. The bricks are only used
+    /// by extractions of the volume they were built for and have to outlive
+    /// them. Passing nullptr disables empty region skipping.
+    void setMinMaxBricks(MinMaxBricks<T> const * bricks);
+
+    /// Set the number of values from one voxel to the next in the volumes of
+    /// the build functions. A channel of an interleaved multi-channel volume
+    /// is extracted in place by passing a pointer to the channel of the first
+    /// voxel and the number of channels as stride. Min/max bricks are not
+    /// used for strided volumes, and streaming builds ignore the stride, as
+    /// they read contiguous slices. The default is 1.
+    void setVoxelStride(size_t const stride);
+
+    /// Enable reserving the vertex and quad vectors of build before the
+    /// extraction, so they are allocated once with their final size instead
+    /// of being regrown. This avoids the copies and the unused capacity of
+    /// regrowing, but the sizes are computed by estimateMeshSize, which
+    /// classifies all cells in an additional pass. Disabled by default.
+    /// Builders keep their internal buffers across extractions, so reusing a
+    /// builder and the output vectors for many volumes avoids most
+    /// allocations without it.
+    void setReserveOutput(bool const reserve);
+
+    /// Compute the number of quads and an upper bound of the number of
+    /// vertices of an extraction without generating the mesh. Quad soups
+    /// have exactly four vertices per quad.
+    void estimateMeshSize(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        size_t & numVertices,
+        size_t & numQuads
+        );
+
+    /// Get the statistics of the last extraction. Multi iso builds report
+    /// the sum over all iso values. All values are zero, unless
+    /// DUALMC_ENABLE_STATS is defined.
+    BuildStats const & getStats() const;
 
     /// Extracts the iso surface for a given volume and iso value.
     /// Output is a list of vertices and a list of indices, which connect
@@ -83,22 +297,366 @@ public:
         std::vector<Quad> & quads
         );
 
+    /// Version of build, which passes the mesh in chunks to the given mesh
+    /// sink. See VectorMeshSink for the requirements on the sink type.
+    template<class MeshSink>
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink
+        );
+
+    /// Parallel version of build. The volume is split into z-slabs, which are
+    /// extracted concurrently by the given executor into private buffers.
+    /// There are several slabs per concurrent task, so tasks finishing slabs
+    /// without surface take over the remaining slabs of the others. Slabs
+    /// are only split along z and span at least eight layers of cell edges,
+    /// so a surface confined to a thin band of z layers is extracted by a
+    /// few tasks, however many are available.
+    /// Afterwards, the dual points shared by neighboring slabs are stitched.
+    /// The resulting mesh is identical to the one generated by build, so it
+    /// does not depend on the executor and the number of threads.
+    /// See ThreadExecutor for the requirements on the executor type.
+    template<class Executor>
+    typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+    buildParallel(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads,
+        Executor & executor
+        );
+
+    /// Parallel version of build, which uses the given number of threads.
+    /// A thread count of 0 uses all hardware threads.
+    void buildParallel(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads,
+        unsigned int const numThreads
+        );
+
+    /// Version of buildParallel, which passes the mesh in chunks to the
+    /// given mesh sink. Each chunk holds the output of one slab.
+    template<class MeshSink, class Executor>
+    typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+    buildParallel(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink,
+        Executor & executor
+        );
+
+    /// Extracts the iso surfaces for a list of iso values of the same volume
+    /// into separate meshes. Min/max bricks are built once and shared by all
+    /// extractions, unless matching bricks were set with setMinMaxBricks.
+    /// Iso values are extracted concurrently by the given executor. If there
+    /// are fewer iso values than concurrent tasks, each iso value is
+    /// extracted with buildParallel instead. The meshes are identical to the
+    /// ones generated by build.
+    template<class Executor>
+    typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+    buildMultiIso(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        std::vector<VolumeDataType> const & isoValues,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<std::vector<Vertex>> & vertices,
+        std::vector<std::vector<Quad>> & quads,
+        Executor & executor
+        );
+
+    /// Multi iso version of build, which uses the given number of threads.
+    /// A thread count of 0 uses all hardware threads.
+    void buildMultiIso(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        std::vector<VolumeDataType> const & isoValues,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<std::vector<Vertex>> & vertices,
+        std::vector<std::vector<Quad>> & quads,
+        unsigned int const numThreads = 1
+        );
+
+    /// Streaming version of build for volumes, which do not fit into memory.
+    /// Slices are requested in increasing z order from the slice reader by
+    /// readSlice(z, slice), which has to fill slice with the dimX*dimY
+    /// voxels of slice z and return false on failure. Only four slices are
+    /// resident at any time.
+    /// The mesh is passed to the given mesh sink in chunks, one for each
+    /// layer of cell edges. The concatenated chunks are identical to the mesh
+    /// generated by build.
+    /// Returns false if reading a slice failed.
+    template<class SliceReader, class MeshSink>
+    bool buildStreaming(
+        SliceReader & readSlice,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink
+        );
+
+    /// Version of build for sparse volumes made from bricks of voxels, in
+    /// which absent bricks have a constant background value. See SparseVolume
+    /// for the requirements on the volume type. The volume is never
+    /// densified. Like buildStreaming, only four slices are resident, and
+    /// they are only filled around bricks intersected by the iso surface.
+    /// Cells of all other bricks are classified without reading voxels.
+    /// The mesh is passed to the given mesh sink in chunks, one for each layer
+    /// of cell edges. The mesh is identical to the one build generates for
+    /// the dense volume. Min/max bricks set by setMinMaxBricks are not used.
+    template<class SparseVolumeType, class MeshSink>
+    void buildSparse(
+        SparseVolumeType const & volume,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink
+        );
+
+    /// Version of buildSparse, which generates a list of vertices and quads.
+    template<class SparseVolumeType>
+    void buildSparse(
+        SparseVolumeType const & volume,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads
+        );
+
+    /// Version of build for volumes given by an implicit scalar field, which
+    /// is evaluated during extraction instead of being stored as a volume.
+    /// The field type has to provide:
+    ///  - VolumeDataType operator()(int32_t x, int32_t y, int32_t z) const,
+    ///    the value of voxel (x,y,z)
+    ///  - void getRange(int32_t const (&lower)[3], int32_t const (&upper)[3],
+    ///    VolumeDataType & minValue, VolumeDataType & maxValue) const, a
+    ///    range containing the values of all voxels in the box from lower
+    ///    to upper, including both
+    /// A coarse pass computes the value ranges of bricks of brickSize^3 cells
+    /// with getRange. Like buildSparse, four slices are resident, and the
+    /// field is only evaluated around bricks intersected by the iso surface.
+    /// Ranges larger than the exact ones only cost additional evaluations, so
+    /// the mesh is identical to the one build generates for the sampled field
+    /// as long as the ranges are conservative.
+    /// The mesh is passed to the given mesh sink in chunks, one for each layer
+    /// of cell edges. Min/max bricks set by setMinMaxBricks are not used.
+    template<class FieldType, class MeshSink>
+    void buildImplicit(
+        FieldType const & field,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink,
+        int32_t const brickSize = 8
+        );
+
+    /// Version of buildImplicit, which generates a list of vertices and quads.
+    template<class FieldType>
+    void buildImplicit(
+        FieldType const & field,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads,
+        int32_t const brickSize = 8
+        );
+
 private:
 
-    /// Extract quad mesh with shared vertex indices.
+    /// Set the volume and algorithm members for a following extraction.
+    void initialize(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        bool const generateManifold
+        );
+
+    /// Count the quads and dual points of the initialized volume by
+    /// classifying all cell layers.
+    void computeMeshSize(
+        VolumeDataType const iso,
+        bool const generateSoup,
+        size_t & numVertices,
+        size_t & numQuads
+        );
+
+    /// Extract quad mesh with shared vertex indices for all quads generated
+    /// by cell edges with z in [zBegin,zEnd).
     void buildSharedVerticesQuads(
         VolumeDataType const iso,
+        int32_t const zBegin, int32_t const zEnd,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads
+        );
+
+    /// Prepare the shared dual point lookup for a shared vertices
+    /// extraction starting at the edge layer zBegin.
+    void beginSharedVerticesQuads(int32_t const zBegin);
+
+    /// Extract the quads with shared vertex indices generated by the cell
+    /// edge layer z. Layers have to be processed in increasing order
+    /// starting at zBegin.
+    void buildSharedVerticesQuadsLayer(
+        VolumeDataType const iso,
+        int32_t const z, int32_t const zBegin,
         std::vector<Vertex> & vertices,
         std::vector<Quad> & quads
         );
         
-    /// Extract quad soup.
+    /// Extract quad soup for all quads generated by cell edges with z in
+    /// [zBegin,zEnd).
     void buildQuadSoup(
         VolumeDataType const iso,
+        int32_t const zBegin, int32_t const zEnd,
         std::vector<Vertex> & vertices,
         std::vector<Quad> & quads
         );
 
+    /// Prepare the dual point cache for a quad soup extraction starting at
+    /// the edge layer zBegin.
+    void beginQuadSoup(int32_t const zBegin);
+
+    /// Extract the quad soup vertices generated by the cell edge layer z.
+    /// Layers have to be processed in increasing order starting at zBegin.
+    void buildQuadSoupLayer(
+        VolumeDataType const iso,
+        int32_t const z, int32_t const zBegin,
+        std::vector<Vertex> & vertices
+        );
+
+    /// Add the quads connecting numVertices quad soup vertices, which start
+    /// at vertexIndexOffset.
+    void addQuadSoupQuads(size_t const numVertices, std::vector<Quad> & quads) const;
+
+    /// Extract all edge layers of the volume and pass the mesh of each layer
+    /// to the mesh sink. prepareLayer(z) is called before extracting the edge
+    /// layer z and stops the extraction by returning false.
+    template<class MeshSink, class LayerPreparation>
+    bool buildEdgeLayers(
+        VolumeDataType const iso,
+        bool const generateSoup,
+        MeshSink & sink,
+        LayerPreparation const & prepareLayer
+        );
+
+    /// Extract all edge layers of a volume, whose slices are read in
+    /// increasing z order into a ring of four slices. The given min/max
+    /// bricks are used for classification, if not null.
+    template<class SliceReader, class MeshSink>
+    bool buildSliceRing(
+        SliceReader & readSlice,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        MeshSink & sink,
+        MinMaxBricks<T> const * bricks
+        );
+
+    /// Fill the regions of slice z of a sparse volume, which are read by the
+    /// extraction. These are the regions around intersected sparseBricks.
+    template<class SparseVolumeType>
+    void readSparseSlice(SparseVolumeType const & volume, int32_t const z,
+      VolumeDataType const iso, VolumeDataType * slice) const;
+
+    /// Evaluate an implicit field in the regions of slice z, which are read
+    /// by the extraction, see readSparseSlice.
+    template<class FieldType>
+    void readImplicitSlice(FieldType const & field, int32_t const z,
+      VolumeDataType const iso, VolumeDataType * slice) const;
+
+    /// Check whether the extraction reads the voxels of the brick of
+    /// brickSize^3 voxels with the coordinates (bx,by,bz). These are the
+    /// bricks touched by the cells of intersected sparseBricks.
+    bool isVoxelBrickRead(int32_t const bx, int32_t const by, int32_t const bz,
+      VolumeDataType const iso) const;
+
+    /// Shared dual point of a slab's lower boundary cell layer together with
+    /// its slab local vertex index.
+    struct BoundaryDualPoint {
+        int32_t cx,cy,cz;
+        int pointCode;
+        int slot;
+        QuadIndexType index;
+    };
+
+    /// Output of a single slab of a parallel build.
+    struct SlabMesh {
+        /// slab local vertices
+        std::vector<Vertex> vertices;
+        /// quads with slab local vertex indices
+        std::vector<Quad> quads;
+        /// dual points of the cell layer below the slab, which are
+        /// potentially also generated by the previous slab
+        std::vector<BoundaryDualPoint> boundaryDualPoints;
+        /// keys and slab local vertex indices of the dual points of the
+        /// slab's last cell layer sorted by key
+        std::vector<std::pair<size_t,QuadIndexType>> topDualPoints;
+        /// mapping of slab local to final vertex indices
+        std::vector<QuadIndexType> localToGlobal;
+        /// pairs of slab local vertex indices and vertex indices of the previous
+        /// slab, which refer to the same dual point
+        std::vector<std::pair<QuadIndexType,QuadIndexType>> sharedWithPrevious;
+        /// offset of the first new vertex of this slab in the final vertex list
+        size_t vertexOffset;
+        /// offset of the first quad of this slab in the final quad list
+        size_t quadOffset;
+        /// statistics of the slab's extraction
+        BuildStats stats;
+    };
+
+    /// Extract the slab s of numSlabs slabs of a parallel build with one of
+    /// the pooled slab builders.
+    void buildSlab(
+        VolumeDataType const * data,
+        VolumeDataType const iso,
+        bool const generateSoup,
+        int32_t const s, int32_t const numSlabs,
+        SlabMesh & slab,
+        std::vector<DualMC *> & freeBuilders,
+        std::mutex & poolMutex,
+        std::condition_variable & poolCondition
+        );
+
+    /// Merge the slab meshes of a parallel build into the final mesh, which
+    /// is passed slab by slab to the mesh sink.
+    template<class MeshSink, class Executor>
+    void mergeSlabs(
+        std::vector<SlabMesh> & slabs,
+        MeshSink & sink,
+        Executor & executor
+        ) const;
+
+    /// Pass the merged slab meshes one after another to the mesh sink.
+    template<class MeshSink, class Executor>
+    void passSlabs(std::vector<SlabMesh> const & slabs, MeshSink & sink, Executor & executor) const;
+
+    /// Copy the merged slab meshes concurrently into the vectors of the sink.
+    template<class Executor>
+    void passSlabs(std::vector<SlabMesh> const & slabs, VectorMeshSink & sink, Executor & executor) const;
+
 
 private:
 
@@ -120,21 +678,76 @@ private:
         FORCE_32BIT = 0xffffffff
     };
 
-    /// get the 8-bit in-out mask for the voxel corners of the cell cube at (cx,cy,cz)
-    /// and the given iso value
-    int getCellCode(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso) const;
+    /// Compute the 8-bit in-out masks for the voxel corners of the cell cubes
+    /// [cxBegin,cxEnd) in the row (cy,cz) and the given iso value. The codes
+    /// are indexed by the x coordinate of the cells.
+    void classifyCellRow(int32_t const cxBegin, int32_t const cxEnd,
+      int32_t const cy, int32_t const cz, VolumeDataType const iso, uint8_t * codes) const;
+
+    /// Compute the cube codes of the cell row (cy,cz) using the min/max
+    /// bricks. Cells of bricks, which are not intersected by the iso surface,
+    /// are classified without reading the volume.
+    void classifyCellRowBricks(int32_t const cy, int32_t const cz, VolumeDataType const iso, uint8_t * codes) const;
+
+    /// Compute the cube codes of the cell layer cz.
+    void computeCellCodeLayer(int32_t const cz, VolumeDataType const iso);
+
+    /// Compute the dual point cube codes of the cell layer cz.
+    /// This is where the manifold dual marching cubes algorithm is
+    /// implemented. Returns the number of inverted cube codes.
+    size_t resolveCellCodeLayer(int32_t const cz);
+
+    /// Make sure that all cube codes needed for the quads of the cell edge
+    /// layer z are cached. Edge layers have to be processed in increasing
+    /// order starting at zBegin.
+    void updateCellCodes(int32_t const z, int32_t const zBegin, VolumeDataType const iso);
+
+    /// Compact the crossed edges of the cell edge layer z into crossedEdges
+    /// with simd::compactCrossedEdges and return their number, which is the
+    /// number of quads of the layer. Edges on the lower volume boundary are
+    /// skipped, as their quads would need cells outside the volume. The
+    /// cube codes of the layer have to be computed.
+    size_t compactCrossedEdgeLayer(int32_t const z);
+
+    /// Get the index of a cell in the cube codes cache.
+    size_t getCellCodeIndex(int32_t const cx, int32_t const cy, int32_t const cz) const;
+
+    /// Get the cached cube code used for looking up the dual points of a cell.
+    int getDualPointsCellCode(int32_t const cx, int32_t const cy, int32_t const cz) const;
+
+    /// Get the index of the dual point in the dualPointsList entry of the
+    /// given cube code, which belongs to the given edge.
+    int getDualPointSlot(int const cubeCode, DMCEdgeCode const edge) const;
 
     /// Get the 12-bit dual point code mask, which encodes the traditional
     /// marching cube vertices of the traditional marching cubes face which
     /// corresponds to the dual point.
-    /// This is also where the manifold dual marching cubes algorithm is
-    /// implemented.
     int getDualPointCode(int32_t const cx, int32_t const cy, int32_t const cz,
-      VolumeDataType const iso, DMCEdgeCode const edge) const;
+      DMCEdgeCode const edge) const;
 
-    /// Given a dual point code and iso value, compute the dual point.
+    /// Given a cube code, the slot of a dual point in its dualPointsList
+    /// entry, and the iso value, compute the dual point.
     void calculateDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
-      VolumeDataType const iso, int const pointCode, Vertex &v) const;
+      VolumeDataType const iso, int const cubeCode, int const slot, Vertex &v);
+
+    /// Compute the dual point of a dual point code by minimizing the
+    /// quadratic error function of its edge intersections. The point is
+    /// clamped to its cell.
+    void calculateHermiteDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
+      VolumeDataType const iso, int const pointCode, Vertex &v);
+
+    /// Get the central difference gradient of a voxel. Gradients are
+    /// computed on first use and cached for the four most recent slices.
+    Vertex const & getGradient(int32_t const x, int32_t const y, int32_t const z);
+
+    /// Compute the dual point of the dual point code PointCode. The edge tests
+    /// and the number of edges are resolved at compile time.
+    template<int PointCode>
+    void calculateDualPointKernel(int32_t const cx, int32_t const cy, int32_t const cz,
+      VolumeDataType const iso, Vertex &v) const;
+
+    /// Get the number of edges of a dual point code.
+    static constexpr int getDualPointCodeNumEdges(int const pointCode);
 
     /// Get the shared index of a dual point which is uniquly identified by its
     /// cell cube index and a cube edge. The dual point is computed,
@@ -142,23 +755,101 @@ private:
     QuadIndexType getSharedDualPointIndex(int32_t const cx, int32_t const cy, int32_t const cz,
       VolumeDataType const iso, DMCEdgeCode const edge,
       std::vector<Vertex> & vertices);
+
+    /// Compute a new dual point and register it as boundary point if it
+    /// belongs to the cell layer below the current slab.
+    QuadIndexType addSharedDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
+      VolumeDataType const iso, int const cubeCode, int const slot,
+      std::vector<Vertex> & vertices);
+
+    /// Get a quad soup dual point, which is uniquely identified by its cell
+    /// cube index and a cube edge. Each dual point is only computed once and
+    /// then copied from the dual points of its cell layer.
+    void getSoupDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
+      VolumeDataType const iso, DMCEdgeCode const edge, Vertex & v);
+
+    /// Get the index of a dual point in the slice cache.
+    size_t getSliceCacheIndex(int32_t const cx, int32_t const cy, int32_t const cz, int const slot) const;
+
+    /// Prepare the slice cache for the cell layer cz. Entries still
+    /// referring to the layer cz-2 are invalidated.
+    void resetSliceCacheLayer(int32_t const cz);
+
+    /// Collect the shared dual points of the cell layer cz, which is the last
+    /// layer of the current slab, sorted by their keys.
+    void getTopDualPoints(int32_t const cz, std::vector<std::pair<size_t,QuadIndexType>> & points) const;
+
+    /// Compute the key of a dual point in its cell layer.
+    size_t getLayerDualPointKey(int32_t const cx, int32_t const cy, int const pointCode) const;
     
     /// Compute a linearized cell cube index.
-    int32_t gA(int32_t const x, int32_t const y, int32_t const z) const;
+    size_t gA(int32_t const x, int32_t const y, int32_t const z) const;
+
+    /// Compute the index of a voxel in the resident volume data. The index
+    /// is computed with size_t to support volumes with more than 2^31 voxels
+    /// and includes the voxel stride.
+    size_t gV(int32_t const x, int32_t const y, int32_t const z) const;
 
 private:
+    // the GPU builder copies the lookup tables
+    friend class DualMCGPU<T,IndexType>;
+    // the incremental builder uses the classification and dual point kernels
+    friend class DualMCIncremental<T,IndexType>;
+    // the level of detail builder runs the kernels on bricks of samples
+    friend class DualMCLod<T,IndexType>;
+
     // static lookup tables needed for (manifold) dual marching cubes
 
     /// Dual Marching Cubes table
     /// Encodes the edge vertices for the 256 marching cubes cases.
     /// A marching cube case produces up to four faces and ,thus, up to four
     /// dual points.
-    static int32_t const dualPointsList[256][4];
+    static constexpr int32_t const (&dualPointsList)[256][4] = tables::Tables::dualPointsList;
     
     /// Table which encodes the ambiguous face of cube configurations, which
     /// can cause non-manifold meshes.
     /// Needed for manifold dual marching cubes.
-    static uint8_t const problematicConfigs[256];
+    static constexpr uint8_t const (&problematicConfigs)[256] = tables::Tables::problematicConfigs;
+
+    /// number of dual points of each dualPointsList entry
+    static constexpr uint8_t const (&numDualPoints)[256] = tables::Tables::numDualPoints;
+
+    /// slot of the dual point of each cube code and edge index in its
+    /// dualPointsList entry
+    static constexpr uint8_t const (&dualPointSlots)[256][12] = tables::Tables::dualPointSlots;
+
+    /// offset of the neighbor cell sharing the ambiguous face for each
+    /// problematicConfigs direction
+    static constexpr int8_t const (&problematicNeighborOffsets)[6][3] = tables::Tables::neighborOffsets;
+
+    /// Dual point kernel computing the dual point of one point code
+    typedef void (DualMC::*DualPointKernel)(int32_t const cx, int32_t const cy, int32_t const cz,
+      VolumeDataType const iso, Vertex &v) const;
+
+    // the kernel table takes the addresses of the kernels
+    template<class Builder, class Sequence> friend struct DualPointKernelTable;
+
+    /// Table of the dual point kernels of the dualPointsList entries.
+    /// Unused entries are null.
+    static DualPointKernel const (&dualPointKernels)[256][4];
+
+    /// offset of the first voxel of each cell edge from the cell origin
+    static uint8_t const edgeVoxels[12][3];
+
+    /// axis of each cell edge
+    static uint8_t const edgeAxes[12];
+
+    /// cells of the four dual points of the quad of a crossed edge along
+    /// each axis, relative to the cell of the first voxel of the edge
+    static int8_t const crossedEdgeCells[3][4][3];
+
+    /// cell edges of the four dual points of the quad of a crossed edge
+    static DMCEdgeCode const crossedEdgeDualPoints[3][4];
+
+    /// classification of the first voxel of a crossed edge along each axis,
+    /// for which the quad corners are oriented in the order of the tables
+    /// above. Otherwise the second and fourth corner are swapped.
+    static uint8_t const crossedEdgeInside[3];
     
 private:
 
@@ -167,16 +858,62 @@ private:
 
     /// convenience volume data point
     VolumeDataType const * data;
+
+    /// mask applied to the z coordinate of voxel accesses. All bits are set
+    /// for volumes in memory. Streaming builds keep a ring of slices.
+    int32_t sliceMask;
+
+    /// voxel stride set by the user
+    size_t voxelStride;
+
+    /// voxel stride of the current extraction, which is 1 for the slice ring
+    /// of streaming builds
+    size_t dataStride;
     
     /// store whether the manifold dual marching cubes algorithm should be
     /// applied.
     bool generateManifold;
+
+    /// method for finding shared dual points
+    SharedVertexEngine sharedVertexEngine;
+
+    /// method for placing dual points
+    DualPointPlacement dualPointPlacement;
+
+    /// gradients of the four most recent slices for Hermite dual points
+    /// stored by the lowest two bits of their z coordinate
+    std::vector<Vertex> gradientCache;
+
+    /// extraction and z coordinate plus one of each cached gradient. Zero
+    /// marks gradients that were never computed.
+    std::vector<uint64_t> gradientStamps;
+
+    /// counter of the extractions, which invalidates the cached gradients
+    uint32_t gradientGeneration;
+
+    /// optional min/max bricks set by the user
+    MinMaxBricks<T> const * minMaxBricks;
+
+    /// min/max bricks used by the current extraction. Only set if the user
+    /// bricks match the volume.
+    MinMaxBricks<T> const * activeBricks;
+
+    /// value ranges of the bricks of the current sparse or implicit build
+    MinMaxBricks<T> sparseBricks;
+
+    /// store whether build reserves its output vectors
+    bool reserveOutput;
+
+    /// first z coordinate of the cell edges processed by the current build.
+    /// Dual points of cells below are shared with the previous slab in
+    /// parallel builds.
+    int32_t slabBeginZ;
     
     /// Dual point key structure for hashing of shared vertices
     struct DualPointKey {
         // a dual point can be uniquely identified by ite linearized volume cell
         // id and point code
-        int32_t linearizedCellID;
+        size_t linearizedCellID;
         int pointCode;
         /// Equal operator for unordered map
         bool operator==(DualPointKey const & other) const;
@@ -185,12 +922,70 @@ private:
     /// Functor for dual point key hash generation
     struct DualPointKeyHash {
         size_t operator()(DualPointKey const & k) const {
-            return size_t(k.linearizedCellID) | (size_t(k.pointCode) << 32u);
+            return k.linearizedCellID ^ (size_t(k.pointCode) << 32u);
         }
     };
     
     /// Hash map for shared vertex index computations
     std::unordered_map<DualPointKey,QuadIndexType,DualPointKeyHash> pointToIndex;
+
+    /// Shared vertex indices of the two most recent cell layers for the
+    /// slice cache engine. Each cell has four slots, one for each of its
+    /// dualPointsList entries. Layers are stored by the parity of their z
+    /// coordinate. Unused slots are set to -1.
+    /// Quad soup extractions store indices into soupDualPoints instead.
+    std::vector<QuadIndexType> sliceCache;
+
+    /// Dual points of the two most recent cell layers of a quad soup
+    /// extraction stored by the parity of their z coordinate.
+    std::vector<Vertex> soupDualPoints[2];
+
+    /// number of cells in a cell layer
+    size_t cellLayerSize;
+
+    /// Cube codes of the four most recent cell layers stored by the lowest
+    /// two bits of their z coordinate.
+    std::vector<uint8_t> cellCodes;
+
+    /// Cube codes used for looking up the dual points of the two most recent
+    /// cell layers stored by the parity of their z coordinate. These only
+    /// differ from cellCodes for manifold dual marching cubes.
+    std::vector<uint8_t> dualPointsCellCodes;
+
+    /// Dual points, which were generated for the cell layer below slabBeginZ.
+    /// Those are potentially also generated by the previous slab.
+    std::vector<BoundaryDualPoint> boundaryDualPoints;
+
+    /// index of the first vertex in the current vertex list. Only non-zero
+    /// for streaming builds, which hand out the vertices in chunks.
+    QuadIndexType vertexIndexOffset;
+
+    /// resident voxel slices of a streaming build
+    std::vector<VolumeDataType> sliceRing;
+
+    /// vertices of the edge layer, which is currently extracted
+    std::vector<Vertex> chunkVertices;
+
+    /// quads of the edge layer, which is currently extracted
+    std::vector<Quad> chunkQuads;
+
+    /// crossed edges of the current edge layer ordered by cell row, cell,
+    /// and axis, see simd::compactCrossedEdges
+    std::vector<uint32_t> crossedEdges;
+
+    /// start of the crossed edges of each cell row of the current edge
+    /// layer in crossedEdges, followed by their end
+    std::vector<size_t> crossedEdgeRows;
+
+    /// builders of a parallel build, one per concurrent slab. Kept with
+    /// their buffers for the following parallel builds.
+    std::vector<DualMC> slabBuilders;
+
+    /// meshes of the slabs of a parallel build
+    std::vector<SlabMesh> slabMeshes;
+
+    /// statistics of the last extraction
+    BuildStats stats;
 };
 
 // inline function definitions
@@ -217,28 +1012,134 @@ Vertex::Vertex(Vertex const & v) : x(v.x), y(v.y), z(v.z) {}
 //------------------------------------------------------------------------------
 
 inline
-Quad::Quad(){}
+Vertex & Vertex::operator=(Vertex const & v) {
+    x = v.x;
+    y = v.y;
+    z = v.z;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+BuildStats::BuildStats() {
+    reset();
+}
+
+//------------------------------------------------------------------------------
+
+inline
+bool BuildStats::isEnabled() {
+#ifdef DUALMC_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double BuildStats::secondsSince(Clock::time_point const start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void BuildStats::reset() {
+    crossedEdges = 0;
+    dualPointsComputed = 0;
+    dualPointsReused = 0;
+    manifoldInversions = 0;
+    classificationTime = 0.0;
+    quadGenerationTime = 0.0;
+    mergeTime = 0.0;
+    totalTime = 0.0;
+}
 
 //------------------------------------------------------------------------------
 
 inline
-Quad::Quad(
-    QuadIndexType i0,
-    QuadIndexType i1,
-    QuadIndexType i2,
-    QuadIndexType i3
+void BuildStats::add(BuildStats const & other) {
+    crossedEdges += other.crossedEdges;
+    dualPointsComputed += other.dualPointsComputed;
+    dualPointsReused += other.dualPointsReused;
+    manifoldInversions += other.manifoldInversions;
+    classificationTime += other.classificationTime;
+    quadGenerationTime += other.quadGenerationTime;
+    mergeTime += other.mergeTime;
+    totalTime += other.totalTime;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+BasicQuad<IndexType>::BasicQuad(){}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+BasicQuad<IndexType>::BasicQuad(
+    IndexType i0,
+    IndexType i1,
+    IndexType i2,
+    IndexType i3
     ) : i0(i0),i1(i1),i2(i2),i3(i3) {}
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-int32_t DualMC<T>::gA(int32_t const x, int32_t const y, int32_t const z) const {
-    return x + dims[0] * (y + dims[1] * z);
+template<class IndexType> inline
+BasicVectorMeshSink<IndexType>::BasicVectorMeshSink(
+    std::vector<Vertex> & vertices,
+    std::vector<BasicQuad<IndexType>> & quads
+    ) : vertices(vertices), quads(quads) {}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicVectorMeshSink<IndexType>::addVertices(Vertex const * vertices, size_t const numVertices) {
+    this->vertices.insert(this->vertices.end(), vertices, vertices + numVertices);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicVectorMeshSink<IndexType>::addQuads(BasicQuad<IndexType> const * quads, size_t const numQuads) {
+    this->quads.insert(this->quads.end(), quads, quads + numQuads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+std::vector<Vertex> & BasicVectorMeshSink<IndexType>::getVertices() {
+    return vertices;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+std::vector<BasicQuad<IndexType>> & BasicVectorMeshSink<IndexType>::getQuads() {
+    return quads;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::gA(int32_t const x, int32_t const y, int32_t const z) const {
+    return size_t(x) + size_t(dims[0]) * (size_t(y) + size_t(dims[1]) * size_t(z));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::gV(int32_t const x, int32_t const y, int32_t const z) const {
+    return (size_t(x) + size_t(dims[0]) * (size_t(y) + size_t(dims[1]) * size_t(z & sliceMask))) * dataStride;
 }
 
 //------------------------------------------------------------------------------
-template<class T> inline
-bool DualMC<T>::DualPointKey::operator==(typename DualMC<T>::DualPointKey const & other) const {
+template<class T, class IndexType> inline
+bool DualMC<T,IndexType>::DualPointKey::operator==(typename DualMC<T,IndexType>::DualPointKey const & other) const {
     return linearizedCellID == other.linearizedCellID && pointCode == other.pointCode;
 }
 
@@ -8,87 +8,397 @@
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-int DualMC<T>::getCellCode(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso) const {
-    // determine for each cube corner if it is outside or inside
-    int code = 0;
-    if(data[gA(cx,cy,cz)] >= iso)
-        code |= 1;
-    if(data[gA(cx+1,cy,cz)] >= iso)
-        code |= 2;
-    if(data[gA(cx,cy+1,cz)] >= iso)
-        code |= 4;
-    if(data[gA(cx+1,cy+1,cz)] >= iso)
-        code |= 8;
-    if(data[gA(cx,cy,cz+1)] >= iso)
-        code |= 16;
-    if(data[gA(cx+1,cy,cz+1)] >= iso)
-        code |= 32;
-    if(data[gA(cx,cy+1,cz+1)] >= iso)
-        code |= 64;
-    if(data[gA(cx+1,cy+1,cz+1)] >= iso)
-        code |= 128;
-    return code;
-}
-
-//------------------------------------------------------------------------------
-
-template<class T> inline
-int DualMC<T>::getDualPointCode(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso, DMCEdgeCode const edge) const {
-    int cubeCode = getCellCode(cx, cy, cz, iso);
+template<class T, class IndexType> inline
+DualMC<T,IndexType>::DualMC() :
+    voxelStride(1),
+    dataStride(1),
+    sharedVertexEngine(SharedVertexEngine::SliceCache),
+    dualPointPlacement(DualPointPlacement::Centroid),
+    gradientGeneration(0),
+    minMaxBricks(nullptr),
+    activeBricks(nullptr),
+    reserveOutput(false),
+    vertexIndexOffset(0) {}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::setSharedVertexEngine(SharedVertexEngine const engine) {
+    sharedVertexEngine = engine;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::setDualPointPlacement(DualPointPlacement const placement) {
+    dualPointPlacement = placement;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::setMinMaxBricks(MinMaxBricks<T> const * bricks) {
+    minMaxBricks = bricks;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::setVoxelStride(size_t const stride) {
+    voxelStride = std::max<size_t>(1, stride);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::setReserveOutput(bool const reserve) {
+    reserveOutput = reserve;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::estimateMeshSize(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    size_t & numVertices,
+    size_t & numQuads
+    ) {
+    initialize(data, dimX, dimY, dimZ, generateManifold);
+    computeMeshSize(iso, generateSoup, numVertices, numQuads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+BuildStats const & DualMC<T,IndexType>::getStats() const {
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::classifyCellRow(int32_t const cxBegin, int32_t const cxEnd,
+  int32_t const cy, int32_t const cz, VolumeDataType const iso, uint8_t * codes) const {
+    // the four voxel rows spanning the cell row
+    VolumeDataType const * const row00 = data + gV(0,cy,cz);
+    VolumeDataType const * const row10 = data + gV(0,cy+1,cz);
+    VolumeDataType const * const row01 = data + gV(0,cy,cz+1);
+    VolumeDataType const * const row11 = data + gV(0,cy+1,cz+1);
     
-    // is manifold dual marching cubes desired?
-    if(generateManifold) {
-        // The Manifold Dual Marching Cubes approach from Rephael Wenger as described in
-        // chapter 3.3.5 of his book "Isosurfaces: Geometry, Topology, and Algorithms"
-        // is implemente here.
-        // If a problematic C16 or C19 configuration shares the ambiguous face 
-        // with another C16 or C19 configuration we simply invert the cube code
-        // before looking up dual points. Doing this for these pairs ensures
-        // manifold meshes.
-        // But this removes the dualism to marching cubes.
-        
-        // check if we have a potentially problematic configuration
-        uint8_t const direction = problematicConfigs[uint8_t(cubeCode)];
-        // If the direction code is in {0,...,5} we have a C16 or C19 configuration.
-        if(direction != 255) {
-            // We have to check the neighboring cube, which shares the ambiguous
-            // face. For this we decode the direction. This could also be done
-            // with another lookup table.
-            // copy current cube coordinates into an array.
-            int32_t neighborCoords[] = {cx,cy,cz};
-            // get the dimension of the non-zero coordinate axis
-            unsigned int const component = direction >> 1;
-            // get the sign of the direction
-            int32_t delta = (direction & 1) == 1 ? 1 : -1;
-            // modify the correspong cube coordinate
-            neighborCoords[component] += delta;
-            // have we left the volume in this direction?
-            if(neighborCoords[component] >= 0 && neighborCoords[component] < (dims[component]-1)) {
-                // get the cube configuration of the relevant neighbor
-                int neighborCubeCode = getCellCode(neighborCoords[0], neighborCoords[1], neighborCoords[2], iso);
-                // Look up the neighbor configuration ambiguous face direction.
-                // If the direction is valid we have a C16 or C19 neighbor.
-                // As C16 and C19 have exactly one ambiguous face this face is
-                // guaranteed to be shared for the pair.
-                if(problematicConfigs[uint8_t(neighborCubeCode)] != 255) {
-                    // replace the cube configuration with its inverse.
-                    cubeCode ^= 0xff;
+    // classify as many cells as possible with the vectorized kernels, which
+    // need contiguous rows
+    int32_t cx = cxBegin;
+    if(dataStride == 1) {
+        cx += simd::classifyCellRow(
+            row00 + cxBegin, row10 + cxBegin, row01 + cxBegin, row11 + cxBegin,
+            cxEnd - cxBegin, iso, codes + cxBegin);
+    }
+    if(cx >= cxEnd)
+        return;
+    size_t const stride = dataStride;
+    
+    // Determine for each cube corner of the remaining cells if it is outside
+    // or inside. The corners with lower x coordinate of a cell are the corners
+    // with higher x coordinate of the previous cell, so each voxel is only
+    // classified once.
+    int lowerCorners = 
+        (row00[cx * stride] >= iso ? 1 : 0) |
+        (row10[cx * stride] >= iso ? 4 : 0) |
+        (row01[cx * stride] >= iso ? 16 : 0) |
+        (row11[cx * stride] >= iso ? 64 : 0);
+    for(; cx < cxEnd; ++cx) {
+        size_t const upper = size_t(cx + 1) * stride;
+        int const upperCorners =
+            (row00[upper] >= iso ? 1 : 0) |
+            (row10[upper] >= iso ? 4 : 0) |
+            (row01[upper] >= iso ? 16 : 0) |
+            (row11[upper] >= iso ? 64 : 0);
+        codes[cx] = uint8_t(lowerCorners | (upperCorners << 1));
+        lowerCorners = upperCorners;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::computeCellCodeLayer(int32_t const cz, VolumeDataType const iso) {
+    // only layers of existing cells are computed
+    if(cz < 0 || cz >= dims[2] - 1)
+        return;
+    for(int32_t cy = 0; cy < dims[1] - 1; ++cy) {
+        uint8_t * const codes = cellCodes.data() + getCellCodeIndex(0, cy, cz);
+        if(activeBricks) {
+            classifyCellRowBricks(cy, cz, iso, codes);
+        } else {
+            classifyCellRow(0, dims[0] - 1, cy, cz, iso, codes);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::classifyCellRowBricks(int32_t const cy, int32_t const cz, VolumeDataType const iso, uint8_t * codes) const {
+    int32_t const numCells = dims[0] - 1;
+    int32_t const brickSize = activeBricks->getBrickSize();
+    int32_t const by = cy / brickSize;
+    int32_t const bz = cz / brickSize;
+    
+    // Consecutive intersected bricks are classified as a single run of
+    // cells. Cells of the other bricks are either all outside or all inside.
+    int32_t runBegin = 0;
+    for(int32_t bx = 0; bx < activeBricks->getNumBricks(0); ++bx) {
+        BrickState const state = activeBricks->getBrickState(bx, by, bz, iso);
+        if(state == BrickState::Intersected)
+            continue;
+        int32_t const cxBegin = bx * brickSize;
+        int32_t const cxEnd = std::min(cxBegin + brickSize, numCells);
+        if(runBegin < cxBegin) {
+            classifyCellRow(runBegin, cxBegin, cy, cz, iso, codes);
+        }
+        std::fill(codes + cxBegin, codes + cxEnd, uint8_t(state == BrickState::Inside ? 255 : 0));
+        runBegin = cxEnd;
+    }
+    if(runBegin < numCells) {
+        classifyCellRow(runBegin, numCells, cy, cz, iso, codes);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::resolveCellCodeLayer(int32_t const cz) {
+    if(cz < 0 || cz >= dims[2] - 1)
+        return 0;
+    
+    uint8_t const * const layerCodes = cellCodes.data() + getCellCodeIndex(0, 0, cz);
+    uint8_t * const resolvedCodes = dualPointsCellCodes.data() + size_t(cz & 1) * cellLayerSize;
+    
+    // without manifold dual marching cubes the cube codes are used as they are
+    if(!generateManifold) {
+        std::copy(layerCodes, layerCodes + cellLayerSize, resolvedCodes);
+        return 0;
+    }
+    
+    // The Manifold Dual Marching Cubes approach from Rephael Wenger as described in
+    // chapter 3.3.5 of his book "Isosurfaces: Geometry, Topology, and Algorithms"
+    // is implemente here.
+    // If a problematic C16 or C19 configuration shares the ambiguous face 
+    // with another C16 or C19 configuration we simply invert the cube code
+    // before looking up dual points. Doing this for these pairs ensures
+    // manifold meshes.
+    // But this removes the dualism to marching cubes.
+    size_t numInversions = 0;
+    size_t cellIndex = 0;
+    for(int32_t cy = 0; cy < dims[1] - 1; ++cy) {
+        for(int32_t cx = 0; cx < dims[0] - 1; ++cx, ++cellIndex) {
+            int cubeCode = layerCodes[cellIndex];
+            // check if we have a potentially problematic configuration
+            uint8_t const direction = problematicConfigs[uint8_t(cubeCode)];
+            // If the direction code is in {0,...,5} we have a C16 or C19 configuration.
+            if(direction != 255) {
+                // We have to check the neighboring cube, which shares the ambiguous
+                // face. Its offset is looked up by the direction.
+                int8_t const * const offset = problematicNeighborOffsets[direction];
+                int32_t const neighborCoords[] = {cx + offset[0], cy + offset[1], cz + offset[2]};
+                // get the dimension of the non-zero coordinate axis
+                unsigned int const component = direction >> 1;
+                // have we left the volume in this direction?
+                if(neighborCoords[component] >= 0 && neighborCoords[component] < (dims[component]-1)) {
+                    // get the cube configuration of the relevant neighbor
+                    int neighborCubeCode = cellCodes[getCellCodeIndex(neighborCoords[0], neighborCoords[1], neighborCoords[2])];
+                    // Look up the neighbor configuration ambiguous face direction.
+                    // If the direction is valid we have a C16 or C19 neighbor.
+                    // As C16 and C19 have exactly one ambiguous face this face is
+                    // guaranteed to be shared for the pair.
+                    if(problematicConfigs[uint8_t(neighborCubeCode)] != 255) {
+                        // replace the cube configuration with its inverse.
+                        cubeCode ^= 0xff;
+                        ++numInversions;
+                    }
                 }
             }
+            resolvedCodes[cellIndex] = uint8_t(cubeCode);
         }
     }
-    for(int i = 0; i < 4; ++i)
-        if(dualPointsList[cubeCode][i] & edge) {
-            return dualPointsList[cubeCode][i];
+    return numInversions;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::updateCellCodes(int32_t const z, int32_t const zBegin, VolumeDataType const iso) {
+    // The quads of edge layer z need the dual point cube codes of the cell
+    // layers z-1 and z. Manifold dual marching cubes additionally looks at
+    // the cube codes of the neighboring layers z-2 and z+1.
+    int32_t const lastLayer = generateManifold ? z + 1 : z;
+    int32_t const firstLayer = z > zBegin ? lastLayer : (generateManifold ? z - 2 : z - 1);
+    for(int32_t cz = firstLayer; cz <= lastLayer; ++cz) {
+        computeCellCodeLayer(cz, iso);
+    }
+    // The layer below zBegin is also resolved by the previous slab of a
+    // parallel build, so only inversions of layer z are counted.
+    if(z == zBegin) {
+        resolveCellCodeLayer(z - 1);
+    }
+    size_t const numInversions = resolveCellCodeLayer(z);
+    DUALMC_STATS(stats.manifoldInversions += numInversions);
+    (void)numInversions;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::compactCrossedEdgeLayer(int32_t const z) {
+    int32_t const reducedX = dims[0] - 2;
+    int32_t const reducedY = std::max(0, dims[1] - 2);
+    crossedEdgeRows.resize(size_t(reducedY) + 1);
+    size_t numEdges = 0;
+    for(int32_t y = 0; y < reducedY; ++y) {
+        crossedEdgeRows[y] = numEdges;
+        // The quads of x edges need the cells below and behind the edge,
+        // the quads of y and z edges the cells left of it and below or
+        // behind it.
+        uint32_t const axes = (z > 0 && y > 0 ? 1u : 0u) | (z > 0 ? 2u : 0u) | (y > 0 ? 4u : 0u);
+        if(reducedX <= 0 || axes == 0)
+            continue;
+        // the compaction may write three edges per cell
+        size_t const maxNumEdges = numEdges + 3 * size_t(reducedX);
+        if(crossedEdges.size() < maxNumEdges) {
+            crossedEdges.resize(std::max(maxNumEdges, crossedEdges.size() * 2));
         }
-    return 0;
+        uint8_t const * const rowCodes = cellCodes.data() + getCellCodeIndex(0,y,z);
+        uint32_t * const edges = crossedEdges.data() + numEdges;
+        size_t const numFirstEdges = simd::compactCrossedEdges(rowCodes, 0, 1, axes & 1u, edges);
+        numEdges += numFirstEdges + simd::compactCrossedEdges(rowCodes, 1, reducedX, axes, edges + numFirstEdges);
+    }
+    crossedEdgeRows[reducedY] = numEdges;
+    return numEdges;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::getCellCodeIndex(int32_t const cx, int32_t const cy, int32_t const cz) const {
+    return size_t(cz & 3) * cellLayerSize + size_t(cx) + size_t(dims[0] - 1) * size_t(cy);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMC<T,IndexType>::getDualPointsCellCode(int32_t const cx, int32_t const cy, int32_t const cz) const {
+    return dualPointsCellCodes[size_t(cz & 1) * cellLayerSize + size_t(cx) + size_t(dims[0] - 1) * size_t(cy)];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMC<T,IndexType>::getDualPointSlot(int const cubeCode, DMCEdgeCode const edge) const {
+    // edge codes have a single bit set
+    return dualPointSlots[cubeCode][simd::detail::lowestBit(uint32_t(edge))];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMC<T,IndexType>::getDualPointCode(int32_t const cx, int32_t const cy, int32_t const cz, DMCEdgeCode const edge) const {
+    int const cubeCode = getDualPointsCellCode(cx, cy, cz);
+    return dualPointsList[cubeCode][getDualPointSlot(cubeCode, edge)];
 }
 
+
 //------------------------------------------------------------------------------
 
-template<class T> inline
-void DualMC<T>::calculateDualPoint(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso, int const pointCode, Vertex & v) const {
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::calculateDualPoint(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso, int const cubeCode, int const slot, Vertex & v) {
+    if(dualPointPlacement == DualPointPlacement::Hermite) {
+        calculateHermiteDualPoint(cx,cy,cz,iso,dualPointsList[cubeCode][slot],v);
+        return;
+    }
+    // dispatch to the kernel specialized for the dual point code
+    (this->*dualPointKernels[cubeCode][slot])(cx,cy,cz,iso,v);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::calculateHermiteDualPoint(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso, int const pointCode, Vertex & v) {
+    // add the plane of each edge intersection in cell local coordinates
+    qef::QEF qef;
+    for(int edge = 0; edge < 12; ++edge) {
+        if((pointCode & (1 << edge)) == 0)
+            continue;
+        uint8_t const * const voxel = edgeVoxels[edge];
+        int const axis = edgeAxes[edge];
+        int32_t const x0 = cx + voxel[0];
+        int32_t const y0 = cy + voxel[1];
+        int32_t const z0 = cz + voxel[2];
+        int32_t const x1 = x0 + (axis == 0 ? 1 : 0);
+        int32_t const y1 = y0 + (axis == 1 ? 1 : 0);
+        int32_t const z1 = z0 + (axis == 2 ? 1 : 0);
+        float const v0 = (float)data[gV(x0,y0,z0)];
+        float const v1 = (float)data[gV(x1,y1,z1)];
+        float const t = ((float)iso - v0)/(v1 - v0);
+        float p[3] = {(float)voxel[0], (float)voxel[1], (float)voxel[2]};
+        p[axis] += t;
+
+        // the normal is the interpolated gradient of the edge voxels
+        Vertex const g0 = getGradient(x0,y0,z0);
+        Vertex const & g1 = getGradient(x1,y1,z1);
+        float n[3] = {
+            g0.x + t * (g1.x - g0.x),
+            g0.y + t * (g1.y - g0.y),
+            g0.z + t * (g1.z - g0.z)
+        };
+        float const length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float const invLength = length > 0.0f ? 1.0f / length : 0.0f;
+        for(int i = 0; i < 3; ++i) {
+            n[i] *= invLength;
+        }
+        qef.add(p, n);
+    }
+
+    // keep the dual point inside its cell
+    float x[3];
+    qef.solve(x);
+    v.x = (float)cx + std::min(std::max(x[0], 0.0f), 1.0f);
+    v.y = (float)cy + std::min(std::max(x[1], 0.0f), 1.0f);
+    v.z = (float)cz + std::min(std::max(x[2], 0.0f), 1.0f);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+Vertex const & DualMC<T,IndexType>::getGradient(int32_t const x, int32_t const y, int32_t const z) {
+    size_t const index = size_t(z & 3) * size_t(dims[0]) * size_t(dims[1]) + size_t(x) + size_t(dims[0]) * size_t(y);
+    uint64_t const stamp = (uint64_t(gradientGeneration) << 32) | uint64_t(uint32_t(z + 1));
+    Vertex & gradient = gradientCache[index];
+    if(gradientStamps[index] != stamp) {
+        // central differences, which are one-sided at the volume boundary
+        int32_t const coords[3] = {x, y, z};
+        float g[3];
+        for(int axis = 0; axis < 3; ++axis) {
+            int32_t lower[3] = {x, y, z};
+            int32_t upper[3] = {x, y, z};
+            lower[axis] = std::max(coords[axis] - 1, 0);
+            upper[axis] = std::min(coords[axis] + 1, dims[axis] - 1);
+            float const difference = (float)data[gV(upper[0],upper[1],upper[2])] - (float)data[gV(lower[0],lower[1],lower[2])];
+            g[axis] = upper[axis] > lower[axis] ? difference / float(upper[axis] - lower[axis]) : 0.0f;
+        }
+        gradient = Vertex(g[0], g[1], g[2]);
+        gradientStamps[index] = stamp;
+    }
+    return gradient;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<int PointCode> inline
+void DualMC<T,IndexType>::calculateDualPointKernel(int32_t const cx, int32_t const cy, int32_t const cz, VolumeDataType const iso, Vertex & v) const {
     // initialize the point with lower voxel coordinates
     v.x = cx;
     v.y = cy;
@@ -100,83 +410,71 @@ void DualMC<T>::calculateDualPoint(int32_t const cx, int32_t const cy, int32_t c
     p.x=0;
     p.y=0;
     p.z=0;
-    int points = 0;
 
-    // sum edge intersection vertices using the point code
-    if(pointCode & EDGE0) {
-        p.x += ((float)iso - (float)data[gA(cx,cy,cz)])/((float)data[gA(cx+1,cy,cz)]-(float)data[gA(cx,cy,cz)]);
-        points++;
+    // sum edge intersection vertices using the point code, the tests are
+    // resolved at compile time
+    if(PointCode & EDGE0) {
+        p.x += ((float)iso - (float)data[gV(cx,cy,cz)])/((float)data[gV(cx+1,cy,cz)]-(float)data[gV(cx,cy,cz)]);
     }
 
-    if(pointCode & EDGE1) {
+    if(PointCode & EDGE1) {
         p.x += 1.0f;
-        p.z += ((float)iso - (float)data[gA(cx+1,cy,cz)])/((float)data[gA(cx+1,cy,cz+1)]-(float)data[gA(cx+1,cy,cz)]);
-        points++;
+        p.z += ((float)iso - (float)data[gV(cx+1,cy,cz)])/((float)data[gV(cx+1,cy,cz+1)]-(float)data[gV(cx+1,cy,cz)]);
     }
 
-    if(pointCode & EDGE2) {
-        p.x += ((float)iso - (float)data[gA(cx,cy,cz+1)])/((float)data[gA(cx+1,cy,cz+1)]-(float)data[gA(cx,cy,cz+1)]);
+    if(PointCode & EDGE2) {
+        p.x += ((float)iso - (float)data[gV(cx,cy,cz+1)])/((float)data[gV(cx+1,cy,cz+1)]-(float)data[gV(cx,cy,cz+1)]);
         p.z += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE3) {
-        p.z += ((float)iso - (float)data[gA(cx,cy,cz)])/((float)data[gA(cx,cy,cz+1)]-(float)data[gA(cx,cy,cz)]);
-        points++;
+    if(PointCode & EDGE3) {
+        p.z += ((float)iso - (float)data[gV(cx,cy,cz)])/((float)data[gV(cx,cy,cz+1)]-(float)data[gV(cx,cy,cz)]);
     }
 
-    if(pointCode & EDGE4) {
-        p.x += ((float)iso - (float)data[gA(cx,cy+1,cz)])/((float)data[gA(cx+1,cy+1,cz)]-(float)data[gA(cx,cy+1,cz)]);
+    if(PointCode & EDGE4) {
+        p.x += ((float)iso - (float)data[gV(cx,cy+1,cz)])/((float)data[gV(cx+1,cy+1,cz)]-(float)data[gV(cx,cy+1,cz)]);
         p.y += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE5) {
+    if(PointCode & EDGE5) {
         p.x += 1.0f;
-        p.z += ((float)iso - (float)data[gA(cx+1,cy+1,cz)])/((float)data[gA(cx+1,cy+1,cz+1)]-(float)data[gA(cx+1,cy+1,cz)]);
+        p.z += ((float)iso - (float)data[gV(cx+1,cy+1,cz)])/((float)data[gV(cx+1,cy+1,cz+1)]-(float)data[gV(cx+1,cy+1,cz)]);
         p.y += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE6) {
-        p.x += ((float)iso - (float)data[gA(cx,cy+1,cz+1)])/((float)data[gA(cx+1,cy+1,cz+1)]-(float)data[gA(cx,cy+1,cz+1)]);
+    if(PointCode & EDGE6) {
+        p.x += ((float)iso - (float)data[gV(cx,cy+1,cz+1)])/((float)data[gV(cx+1,cy+1,cz+1)]-(float)data[gV(cx,cy+1,cz+1)]);
         p.z += 1.0f;
         p.y += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE7) {
-        p.z += ((float)iso - (float)data[gA(cx,cy+1,cz)])/((float)data[gA(cx,cy+1,cz+1)]-(float)data[gA(cx,cy+1,cz)]);
+    if(PointCode & EDGE7) {
+        p.z += ((float)iso - (float)data[gV(cx,cy+1,cz)])/((float)data[gV(cx,cy+1,cz+1)]-(float)data[gV(cx,cy+1,cz)]);
         p.y += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE8) {
-        p.y += ((float)iso - (float)data[gA(cx,cy,cz)])/((float)data[gA(cx,cy+1,cz)]-(float)data[gA(cx,cy,cz)]);
-        points++;
+    if(PointCode & EDGE8) {
+        p.y += ((float)iso - (float)data[gV(cx,cy,cz)])/((float)data[gV(cx,cy+1,cz)]-(float)data[gV(cx,cy,cz)]);
     }
 
-    if(pointCode & EDGE9) {
+    if(PointCode & EDGE9) {
         p.x += 1.0f;
-        p.y += ((float)iso - (float)data[gA(cx+1,cy,cz)])/((float)data[gA(cx+1,cy+1,cz)]-(float)data[gA(cx+1,cy,cz)]);
-        points++;
+        p.y += ((float)iso - (float)data[gV(cx+1,cy,cz)])/((float)data[gV(cx+1,cy+1,cz)]-(float)data[gV(cx+1,cy,cz)]);
     }
 
-    if(pointCode & EDGE10) {
+    if(PointCode & EDGE10) {
         p.x += 1.0f;
-        p.y += ((float)iso - (float)data[gA(cx+1,cy,cz+1)])/((float)data[gA(cx+1,cy+1,cz+1)]-(float)data[gA(cx+1,cy,cz+1)]);
+        p.y += ((float)iso - (float)data[gV(cx+1,cy,cz+1)])/((float)data[gV(cx+1,cy+1,cz+1)]-(float)data[gV(cx+1,cy,cz+1)]);
         p.z += 1.0f;
-        points++;
     }
 
-    if(pointCode & EDGE11) {
+    if(PointCode & EDGE11) {
         p.z += 1.0f;
-        p.y += ((float)iso - (float)data[gA(cx,cy,cz+1)])/((float)data[gA(cx,cy+1,cz+1)]-(float)data[gA(cx,cy,cz+1)]);
-        points++;
+        p.y += ((float)iso - (float)data[gV(cx,cy,cz+1)])/((float)data[gV(cx,cy+1,cz+1)]-(float)data[gV(cx,cy,cz+1)]);
     }
 
     // divide by number of accumulated points
-    float invPoints = 1.0f / (float)points;
+    float constexpr invPoints = 1.0f / (float)getDualPointCodeNumEdges(PointCode);
     p.x*= invPoints;
     p.y*= invPoints;
     p.z*= invPoints;
@@ -189,27 +487,83 @@ void DualMC<T>::calculateDualPoint(int32_t const cx, int32_t const cy, int32_t c
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-QuadIndexType DualMC<T>::getSharedDualPointIndex(
+template<class T, class IndexType> inline
+constexpr int DualMC<T,IndexType>::getDualPointCodeNumEdges(int const pointCode) {
+    return pointCode == 0 ? 0 : (pointCode & 1) + getDualPointCodeNumEdges(pointCode >> 1);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType>
+uint8_t const DualMC<T,IndexType>::edgeVoxels[12][3] = {
+    {0,0,0},{1,0,0},{0,0,1},{0,0,0},
+    {0,1,0},{1,1,0},{0,1,1},{0,1,0},
+    {0,0,0},{1,0,0},{1,0,1},{0,0,1}
+};
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType>
+uint8_t const DualMC<T,IndexType>::edgeAxes[12] = {0,2,0,2, 0,2,0,2, 1,1,1,1};
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType>
+int8_t const DualMC<T,IndexType>::crossedEdgeCells[3][4][3] = {
+    {{0,0,0}, {0,0,-1}, {0,-1,-1}, {0,-1,0}},
+    {{0,0,0}, {0,0,-1}, {-1,0,-1}, {-1,0,0}},
+    {{0,0,0}, {-1,0,0}, {-1,-1,0}, {0,-1,0}}};
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType>
+typename DualMC<T,IndexType>::DMCEdgeCode const DualMC<T,IndexType>::crossedEdgeDualPoints[3][4] = {
+    {EDGE0, EDGE2, EDGE6, EDGE4},
+    {EDGE8, EDGE11, EDGE10, EDGE9},
+    {EDGE3, EDGE1, EDGE5, EDGE7}};
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType>
+uint8_t const DualMC<T,IndexType>::crossedEdgeInside[3] = {0,1,1};
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMC<T,IndexType>::QuadIndexType DualMC<T,IndexType>::getSharedDualPointIndex(
     int32_t const cx, int32_t const cy, int32_t const cz,
     VolumeDataType const iso, DMCEdgeCode const edge,
     std::vector<Vertex> & vertices
     ) {
+    if(sharedVertexEngine == SharedVertexEngine::SliceCache) {
+        // look up the dual point in the slot of its cell
+        int const cubeCode = getDualPointsCellCode(cx,cy,cz);
+        int const slot = getDualPointSlot(cubeCode, edge);
+        QuadIndexType & index = sliceCache[getSliceCacheIndex(cx,cy,cz,slot)];
+        if(index < 0) {
+            index = addSharedDualPoint(cx,cy,cz,iso,cubeCode,slot,vertices);
+        } else {
+            DUALMC_STATS(++stats.dualPointsReused);
+        }
+        return index;
+    }
+
     // create a key for the dual point from its linearized cell ID and point code
     DualPointKey key;
     key.linearizedCellID = gA(cx,cy,cz);
-    key.pointCode = getDualPointCode(cx,cy,cz,iso,edge);
+    key.pointCode = getDualPointCode(cx,cy,cz,edge);
     
     // have we already computed the dual point?
     auto iterator = pointToIndex.find(key);
     if(iterator != pointToIndex.end()) {
         // just return the dual point index
+        DUALMC_STATS(++stats.dualPointsReused);
         return iterator->second;
     } else {
         // create new vertex and vertex id
-        QuadIndexType newVertexId = vertices.size();
-        vertices.emplace_back();
-        calculateDualPoint(cx,cy,cz,iso,key.pointCode, vertices.back());
+        int const cubeCode = getDualPointsCellCode(cx,cy,cz);
+        QuadIndexType const newVertexId = addSharedDualPoint(cx,cy,cz,iso,cubeCode,
+            getDualPointSlot(cubeCode, edge),vertices);
         // insert vertex ID into map and also return it
         pointToIndex[key] = newVertexId;
         return newVertexId;
@@ -218,244 +572,1017 @@ QuadIndexType DualMC<T>::getSharedDualPointIndex(
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-void DualMC<T>::build(
+template<class T, class IndexType> inline
+typename DualMC<T,IndexType>::QuadIndexType DualMC<T,IndexType>::addSharedDualPoint(
+    int32_t const cx, int32_t const cy, int32_t const cz,
+    VolumeDataType const iso, int const cubeCode, int const slot,
+    std::vector<Vertex> & vertices
+    ) {
+    // create new vertex and vertex id
+    QuadIndexType const newVertexId = vertexIndexOffset + QuadIndexType(vertices.size());
+    vertices.emplace_back();
+    calculateDualPoint(cx,cy,cz,iso,cubeCode,slot, vertices.back());
+    DUALMC_STATS(++stats.dualPointsComputed);
+    // remember dual points of the lower boundary layer for stitching slabs
+    if(cz < slabBeginZ) {
+        BoundaryDualPoint boundaryPoint;
+        boundaryPoint.cx = cx;
+        boundaryPoint.cy = cy;
+        boundaryPoint.cz = cz;
+        boundaryPoint.pointCode = dualPointsList[cubeCode][slot];
+        boundaryPoint.slot = slot;
+        boundaryPoint.index = newVertexId;
+        boundaryDualPoints.push_back(boundaryPoint);
+    }
+    return newVertexId;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::getSoupDualPoint(
+    int32_t const cx, int32_t const cy, int32_t const cz,
+    VolumeDataType const iso, DMCEdgeCode const edge,
+    Vertex & v
+    ) {
+    // look up the dual point in the slot of its cell
+    int const cubeCode = getDualPointsCellCode(cx,cy,cz);
+    int const slot = getDualPointSlot(cubeCode, edge);
+    QuadIndexType & index = sliceCache[getSliceCacheIndex(cx,cy,cz,slot)];
+    std::vector<Vertex> & layerDualPoints = soupDualPoints[cz & 1];
+    if(index < 0) {
+        index = QuadIndexType(layerDualPoints.size());
+        calculateDualPoint(cx,cy,cz,iso,cubeCode,slot, v);
+        layerDualPoints.push_back(v);
+        DUALMC_STATS(++stats.dualPointsComputed);
+    } else {
+        v = layerDualPoints[index];
+        DUALMC_STATS(++stats.dualPointsReused);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::getSliceCacheIndex(int32_t const cx, int32_t const cy, int32_t const cz, int const slot) const {
+    size_t const cellIndex = size_t(cz & 1) * cellLayerSize + size_t(cx) + size_t(dims[0] - 1) * size_t(cy);
+    return cellIndex * 4 + slot;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::resetSliceCacheLayer(int32_t const cz) {
+    auto const layerBegin = sliceCache.begin() + size_t(cz & 1) * cellLayerSize * 4;
+    std::fill(layerBegin, layerBegin + cellLayerSize * 4, -1);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::getTopDualPoints(int32_t const cz, std::vector<std::pair<size_t,QuadIndexType>> & points) const {
+    points.clear();
+    if(cz < 0)
+        return;
+    if(sharedVertexEngine == SharedVertexEngine::SliceCache) {
+        // The slice cache still holds the last cell layer of the slab
+        for(int32_t cy = 0; cy < dims[1] - 1; ++cy) {
+            for(int32_t cx = 0; cx < dims[0] - 1; ++cx) {
+                for(int slot = 0; slot < 4; ++slot) {
+                    QuadIndexType const index = sliceCache[getSliceCacheIndex(cx,cy,cz,slot)];
+                    if(index >= 0) {
+                        int const pointCode = dualPointsList[getDualPointsCellCode(cx,cy,cz)][slot];
+                        points.emplace_back(getLayerDualPointKey(cx,cy,pointCode), index);
+                    }
+                }
+            }
+        }
+    } else {
+        size_t const layerBegin = gA(0,0,cz);
+        size_t const layerEnd = gA(0,0,cz+1);
+        for(auto const & entry : pointToIndex) {
+            size_t const cellID = entry.first.linearizedCellID;
+            if(cellID >= layerBegin && cellID < layerEnd) {
+                int32_t const cx = int32_t((cellID - layerBegin) % size_t(dims[0]));
+                int32_t const cy = int32_t((cellID - layerBegin) / size_t(dims[0]));
+                points.emplace_back(getLayerDualPointKey(cx,cy,entry.first.pointCode), entry.second);
+            }
+        }
+    }
+    std::sort(points.begin(), points.end());
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMC<T,IndexType>::getLayerDualPointKey(int32_t const cx, int32_t const cy, int const pointCode) const {
+    // point codes are 12-bit edge masks
+    return (size_t(cx) + size_t(dims[0] - 1) * size_t(cy)) * 4096 + size_t(pointCode);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::initialize(
     VolumeDataType const * data,
     int32_t const dimX, int32_t const dimY, int32_t const dimZ,
-    VolumeDataType const iso,
-    bool const generateManifold,
-    bool const generateSoup,
-    std::vector<Vertex> & vertices,
-    std::vector<Quad> & quads
+    bool const generateManifold
     ) {
-
     // set members
     this->dims[0] = dimX;
     this->dims[1] = dimY;
     this->dims[2] = dimZ;
     this->data = data;
+    this->sliceMask = -1;
+    this->dataStride = voxelStride;
     this->generateManifold = generateManifold;
+    DUALMC_STATS(stats.reset());
+    
+    // only use bricks, which were built for this volume
+    activeBricks = dataStride == 1 && minMaxBricks && minMaxBricks->isBuiltFor(data, dimX, dimY, dimZ) ?
+        minMaxBricks : nullptr;
+    
+    // cube code caches for the cell layers of the volume
+    cellLayerSize = size_t(std::max(0, dimX - 1)) * size_t(std::max(0, dimY - 1));
+    cellCodes.resize(cellLayerSize * 4);
+    dualPointsCellCodes.resize(cellLayerSize * 2);
+
+    // gradients cached by a previous extraction are invalid
+    if(dualPointPlacement == DualPointPlacement::Hermite) {
+        ++gradientGeneration;
+        size_t const sliceSize = size_t(std::max(0, dimX)) * size_t(std::max(0, dimY));
+        gradientCache.resize(sliceSize * 4);
+        gradientStamps.resize(sliceSize * 4, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::computeMeshSize(
+    VolumeDataType const iso,
+    bool const generateSoup,
+    size_t & numVertices,
+    size_t & numQuads
+    ) {
+    // Bound the number of dual points of each cube code. Manifold dual
+    // marching cubes may look up the points of the inverted cube code.
+    uint8_t maxDualPoints[256];
+    for(int code = 0; code < 256; ++code) {
+        bool const invertible = generateManifold && problematicConfigs[code] != 255;
+        maxDualPoints[code] = invertible ?
+            std::max(numDualPoints[code], numDualPoints[code ^ 0xff]) : numDualPoints[code];
+    }
+
+    // Every crossed edge of the build generates one quad, so the quads are
+    // counted exactly by the compaction of the build. Each cell contributes
+    // at most the dual points of its cube code.
+    int32_t const reducedZ = dims[2] - 2;
+    size_t numPoints = 0;
+    numQuads = 0;
+    for(int32_t z = 0; z < dims[2] - 1; ++z) {
+        computeCellCodeLayer(z, iso);
+        if(!generateSoup) {
+            uint8_t const * const layerCodes = cellCodes.data() + getCellCodeIndex(0,0,z);
+            for(size_t i = 0; i < cellLayerSize; ++i) {
+                numPoints += maxDualPoints[layerCodes[i]];
+            }
+        }
+        if(z < reducedZ) {
+            numQuads += compactCrossedEdgeLayer(z);
+        }
+    }
+    numVertices = generateSoup ? numQuads * 4 : numPoints;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+    
+    initialize(data, dimX, dimY, dimZ, generateManifold);
     
     // clear vertices and quad indices
     vertices.clear();
     quads.clear();
+    if(reserveOutput) {
+        size_t numVertices, numQuads;
+        computeMeshSize(iso, generateSoup, numVertices, numQuads);
+        vertices.reserve(numVertices);
+        quads.reserve(numQuads);
+    }
+    
+    // Generate quad soup or shared vertices quad list. The result is the
+    // same as passing a VectorMeshSink, but the vertices and quads are
+    // generated in place instead of being copied chunk by chunk.
+    int32_t const reducedZ = dims[2] - 2;
+    if(generateSoup) {
+        buildQuadSoup(iso,0,reducedZ,vertices,quads);
+    } else {
+        buildSharedVerticesQuads(iso,0,reducedZ,vertices,quads);
+    }
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class MeshSink> inline
+void DualMC<T,IndexType>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+
+    initialize(data, dimX, dimY, dimZ, generateManifold);
     
     // generate quad soup or shared vertices quad list
+    buildEdgeLayers(iso, generateSoup, sink, [](int32_t) { return true; });
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class MeshSink, class LayerPreparation> inline
+bool DualMC<T,IndexType>::buildEdgeLayers(
+    VolumeDataType const iso,
+    bool const generateSoup,
+    MeshSink & sink,
+    LayerPreparation const & prepareLayer
+    ) {
+    int32_t const reducedZ = dims[2] - 2;
     if(generateSoup) {
-        buildQuadSoup(iso,vertices,quads);
+        beginQuadSoup(0);
     } else {
-        buildSharedVerticesQuads(iso,vertices,quads);
+        beginSharedVerticesQuads(0);
+    }
+    for(int32_t z = 0; z < reducedZ; ++z) {
+        if(!prepareLayer(z))
+            return false;
+        
+        // extract the edge layer and pass its vertices and quads to the sink
+        chunkVertices.clear();
+        chunkQuads.clear();
+        if(generateSoup) {
+            buildQuadSoupLayer(iso, z, 0, chunkVertices);
+            addQuadSoupQuads(chunkVertices.size(), chunkQuads);
+        } else {
+            buildSharedVerticesQuadsLayer(iso, z, 0, chunkVertices, chunkQuads);
+        }
+        if(!chunkVertices.empty()) {
+            sink.addVertices(chunkVertices.data(), chunkVertices.size());
+        }
+        if(!chunkQuads.empty()) {
+            sink.addQuads(chunkQuads.data(), chunkQuads.size());
+        }
+        vertexIndexOffset += QuadIndexType(chunkVertices.size());
     }
+    return true;
 }
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-void DualMC<T>::buildQuadSoup(
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildParallel(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
     VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads,
+    unsigned int const numThreads
+    ) {
+    ThreadExecutor executor(numThreads);
+    buildParallel(data, dimX, dimY, dimZ, iso, generateManifold, generateSoup,
+        vertices, quads, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class Executor> inline
+typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+DualMC<T,IndexType>::buildParallel(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads,
+    Executor & executor
+    ) {
+
+    // clear vertices and quad indices
+    vertices.clear();
+    quads.clear();
+
+    VectorMeshSink sink(vertices, quads);
+    buildParallel(data, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class MeshSink, class Executor> inline
+typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+DualMC<T,IndexType>::buildParallel(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink,
+    Executor & executor
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+
+    initialize(data, dimX, dimY, dimZ, generateManifold);
+
+    // Surfaces are rarely distributed evenly over the slabs, so each task
+    // gets several slabs, which tasks fetch as soon as they are idle. Each
+    // slab repeats the classification of up to three cell layers, so slabs
+    // have at least minSlabLayers layers of cell edges. Dual points are only
+    // shared across z boundaries, so slabs are not split along x and y.
+    int32_t const reducedZ = dims[2] - 2;
+    if(reducedZ <= 0)
+        return;
+    int32_t const slabsPerTask = 4;
+    int32_t const minSlabLayers = 8;
+    int64_t const concurrency = std::max(1u, executor.concurrency());
+    int32_t const numSlabs = concurrency == 1 ? 1 : int32_t(std::max(
+        std::min<int64_t>(concurrency, reducedZ),
+        std::min<int64_t>(concurrency * slabsPerTask, reducedZ / minSlabLayers)));
+
+    // Slabs are extracted into private buffers by pooled builders, one per
+    // concurrent slab. The builders and buffers are kept, so repeated builds
+    // reuse their memory.
+    slabBuilders.resize(size_t(std::min<int64_t>(concurrency, numSlabs)));
+    slabMeshes.resize(numSlabs);
+    std::vector<DualMC *> freeBuilders;
+    for(auto & builder : slabBuilders) {
+        builder.setSharedVertexEngine(sharedVertexEngine);
+        builder.setDualPointPlacement(dualPointPlacement);
+        builder.setMinMaxBricks(minMaxBricks);
+        builder.setVoxelStride(voxelStride);
+        freeBuilders.push_back(&builder);
+    }
+    std::mutex poolMutex;
+    std::condition_variable poolCondition;
+    std::vector<SlabMesh> & slabs = slabMeshes;
+    executor.run(numSlabs, [&](int32_t const s) {
+        buildSlab(data, iso, generateSoup, s, numSlabs, slabs[s], freeBuilders, poolMutex, poolCondition);
+    });
+    DUALMC_STATS(for(auto const & slab : slabs) stats.add(slab.stats));
+
+    DUALMC_STATS(BuildStats::Clock::time_point const mergeStartTime = BuildStats::Clock::now());
+    mergeSlabs(slabs, sink, executor);
+    DUALMC_STATS(stats.mergeTime = BuildStats::secondsSince(mergeStartTime));
+
+    // the serial build reuses the dual points shared with the previous slab
+    DUALMC_STATS(for(auto const & slab : slabs) {
+        stats.dualPointsComputed -= slab.sharedWithPrevious.size();
+        stats.dualPointsReused += slab.sharedWithPrevious.size();
+    });
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildMultiIso(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    std::vector<VolumeDataType> const & isoValues,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<std::vector<Vertex>> & vertices,
+    std::vector<std::vector<Quad>> & quads,
+    unsigned int const numThreads
+    ) {
+    ThreadExecutor executor(numThreads);
+    buildMultiIso(data, dimX, dimY, dimZ, isoValues, generateManifold, generateSoup,
+        vertices, quads, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class Executor> inline
+typename std::enable_if<!std::is_arithmetic<Executor>::value>::type
+DualMC<T,IndexType>::buildMultiIso(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    std::vector<VolumeDataType> const & isoValues,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<std::vector<Vertex>> & vertices,
+    std::vector<std::vector<Quad>> & quads,
+    Executor & executor
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+    DUALMC_STATS(BuildStats totalStats);
+    int32_t const numIsoValues = int32_t(isoValues.size());
+    vertices.resize(numIsoValues);
+    quads.resize(numIsoValues);
+
+    // the bricks are the only state shared by all iso values, strided
+    // volumes do not use bricks
+    MinMaxBricks<T> ownBricks;
+    MinMaxBricks<T> const * bricks = minMaxBricks;
+    if(voxelStride == 1 && (!bricks || !bricks->isBuiltFor(data, dimX, dimY, dimZ))) {
+        ownBricks.build(data, dimX, dimY, dimZ, 8, executor);
+        bricks = &ownBricks;
+    }
+
+    // Few iso values do not keep all tasks busy. Those are extracted one
+    // after another with the slab parallel build instead.
+    if(numIsoValues < int64_t(executor.concurrency())) {
+        MinMaxBricks<T> const * const previousBricks = minMaxBricks;
+        setMinMaxBricks(bricks);
+        for(int32_t i = 0; i < numIsoValues; ++i) {
+            buildParallel(data, dimX, dimY, dimZ, isoValues[i], generateManifold, generateSoup,
+                vertices[i], quads[i], executor);
+            DUALMC_STATS(totalStats.add(stats));
+        }
+        setMinMaxBricks(previousBricks);
+        DUALMC_STATS(stats = totalStats);
+        DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+        return;
+    }
+
+    // otherwise each iso value is extracted by its own builder
+    DUALMC_STATS(std::vector<BuildStats> isoStats(numIsoValues));
+    executor.run(numIsoValues, [&](int32_t const i) {
+        DualMC builder;
+        builder.setSharedVertexEngine(sharedVertexEngine);
+        builder.setDualPointPlacement(dualPointPlacement);
+        builder.setMinMaxBricks(bricks);
+        builder.setVoxelStride(voxelStride);
+        builder.build(data, dimX, dimY, dimZ, isoValues[i], generateManifold, generateSoup,
+            vertices[i], quads[i]);
+        DUALMC_STATS(isoStats[i] = builder.getStats());
+    });
+    DUALMC_STATS(for(auto const & isoStat : isoStats) totalStats.add(isoStat));
+    DUALMC_STATS(stats = totalStats);
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class SliceReader, class MeshSink> inline
+bool DualMC<T,IndexType>::buildStreaming(
+    SliceReader & readSlice,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+    bool const success = buildSliceRing(readSlice, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink, nullptr);
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+    return success;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class SparseVolumeType, class MeshSink> inline
+void DualMC<T,IndexType>::buildSparse(
+    SparseVolumeType const & volume,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+
+    // the value ranges of the bricks select the regions, which are read
+    sparseBricks.buildSparse(volume, dimX, dimY, dimZ);
+    auto readSlice = [&](int32_t const z, VolumeDataType * slice) {
+        readSparseSlice(volume, z, iso, slice);
+        return true;
+    };
+    buildSliceRing(readSlice, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink, &sparseBricks);
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class SparseVolumeType> inline
+void DualMC<T,IndexType>::buildSparse(
+    SparseVolumeType const & volume,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
     std::vector<Vertex> & vertices,
     std::vector<Quad> & quads
     ) {
-    
-    int32_t const reducedX = dims[0] - 2;
-    int32_t const reducedY = dims[1] - 2;
+    vertices.clear();
+    quads.clear();
+    VectorMeshSink sink(vertices, quads);
+    buildSparse(volume, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class FieldType, class MeshSink> inline
+void DualMC<T,IndexType>::buildImplicit(
+    FieldType const & field,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink,
+    int32_t const brickSize
+    ) {
+    DUALMC_STATS(BuildStats::Clock::time_point const startTime = BuildStats::Clock::now());
+
+    // the bounded value ranges of the bricks select the regions, which are evaluated
+    sparseBricks.buildImplicit(field, dimX, dimY, dimZ, brickSize);
+    auto readSlice = [&](int32_t const z, VolumeDataType * slice) {
+        readImplicitSlice(field, z, iso, slice);
+        return true;
+    };
+    buildSliceRing(readSlice, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink, &sparseBricks);
+    DUALMC_STATS(stats.totalTime = BuildStats::secondsSince(startTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class FieldType> inline
+void DualMC<T,IndexType>::buildImplicit(
+    FieldType const & field,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads,
+    int32_t const brickSize
+    ) {
+    vertices.clear();
+    quads.clear();
+    VectorMeshSink sink(vertices, quads);
+    buildImplicit(field, dimX, dimY, dimZ, iso, generateManifold, generateSoup, sink, brickSize);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class SliceReader, class MeshSink> inline
+bool DualMC<T,IndexType>::buildSliceRing(
+    SliceReader & readSlice,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    MeshSink & sink,
+    MinMaxBricks<T> const * bricks
+    ) {
+    // The quads of edge layer z need the voxels of the dual point cells in
+    // the layers z-1 and z, and classify the cells of layer z+1 for the
+    // manifold neighbor check. Slices z-1,...,z+2 are therefore resident.
+    // The gradients of Hermite dual points also need slice z-2, so the ring
+    // is extended to the next power of two.
+    int32_t const ringSize = dualPointPlacement == DualPointPlacement::Hermite ? 8 : 4;
+    size_t const sliceSize = size_t(dimX) * size_t(dimY);
+    sliceRing.resize(sliceSize * size_t(ringSize));
+    initialize(sliceRing.data(), dimX, dimY, dimZ, generateManifold);
+    sliceMask = ringSize - 1;
+    dataStride = 1;
+    activeBricks = bricks;
+
+    // read the slices up to z+2, which replace the ones before z-1
+    int32_t numSlicesRead = 0;
+    return buildEdgeLayers(iso, generateSoup, sink, [&](int32_t const z) {
+        int32_t const numSlicesNeeded = std::min(z + 3, dims[2]);
+        for(; numSlicesRead < numSlicesNeeded; ++numSlicesRead) {
+            if(!readSlice(numSlicesRead, &sliceRing[size_t(numSlicesRead & sliceMask) * sliceSize]))
+                return false;
+        }
+        return true;
+    });
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class SparseVolumeType> inline
+void DualMC<T,IndexType>::readSparseSlice(SparseVolumeType const & volume, int32_t const z,
+  VolumeDataType const iso, VolumeDataType * slice) const {
+    int32_t const brickSize = sparseBricks.getBrickSize();
+    int32_t const numBricksX = (dims[0] + brickSize - 1) / brickSize;
+    int32_t const numBricksY = (dims[1] + brickSize - 1) / brickSize;
+    int32_t const bz = z / brickSize;
+    int32_t const brickZ = z - bz * brickSize;
+    VolumeDataType const background = volume.getBackground();
+
+    // Voxels of volume bricks, which are never read, keep stale values.
+    for(int32_t by = 0; by < numBricksY; ++by) {
+        int32_t const y0 = by * brickSize;
+        int32_t const y1 = std::min(y0 + brickSize, dims[1]);
+        for(int32_t bx = 0; bx < numBricksX; ++bx) {
+            if(!isVoxelBrickRead(bx, by, bz, iso))
+                continue;
+            int32_t const x0 = bx * brickSize;
+            int32_t const x1 = std::min(x0 + brickSize, dims[0]);
+            VolumeDataType const * const brick = volume.getBrick(bx, by, bz);
+            for(int32_t y = y0; y < y1; ++y) {
+                VolumeDataType * const row = slice + size_t(dims[0]) * size_t(y);
+                if(brick) {
+                    VolumeDataType const * const brickRow = brick + size_t(brickSize) * (size_t(y - y0) + size_t(brickSize) * size_t(brickZ));
+                    std::copy(brickRow, brickRow + (x1 - x0), row + x0);
+                } else {
+                    std::fill(row + x0, row + x1, background);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class FieldType> inline
+void DualMC<T,IndexType>::readImplicitSlice(FieldType const & field, int32_t const z,
+  VolumeDataType const iso, VolumeDataType * slice) const {
+    int32_t const brickSize = sparseBricks.getBrickSize();
+    int32_t const numBricksX = (dims[0] + brickSize - 1) / brickSize;
+    int32_t const numBricksY = (dims[1] + brickSize - 1) / brickSize;
+    int32_t const bz = z / brickSize;
+
+    // the field is only evaluated for voxels, which are read
+    for(int32_t by = 0; by < numBricksY; ++by) {
+        int32_t const y0 = by * brickSize;
+        int32_t const y1 = std::min(y0 + brickSize, dims[1]);
+        for(int32_t bx = 0; bx < numBricksX; ++bx) {
+            if(!isVoxelBrickRead(bx, by, bz, iso))
+                continue;
+            int32_t const x0 = bx * brickSize;
+            int32_t const x1 = std::min(x0 + brickSize, dims[0]);
+            for(int32_t y = y0; y < y1; ++y) {
+                VolumeDataType * const row = slice + size_t(dims[0]) * size_t(y);
+                for(int32_t x = x0; x < x1; ++x) {
+                    row[x] = field(x, y, z);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+bool DualMC<T,IndexType>::isVoxelBrickRead(int32_t const bx, int32_t const by, int32_t const bz,
+  VolumeDataType const iso) const {
+    // The voxels of a volume brick are touched by the cells of the bricks
+    // with the same and the preceding coordinates. The gradients of Hermite
+    // dual points also read the voxels next to the cells, so up to two
+    // preceding and one following brick are checked.
+    bool const hermite = dualPointPlacement == DualPointPlacement::Hermite;
+    int32_t const lowerMargin = hermite ? 2 : 1;
+    int32_t const upperMargin = hermite ? 1 : 0;
+    for(int32_t cz = std::max(0, bz - lowerMargin); cz <= std::min(bz + upperMargin, sparseBricks.getNumBricks(2) - 1); ++cz)
+        for(int32_t cy = std::max(0, by - lowerMargin); cy <= std::min(by + upperMargin, sparseBricks.getNumBricks(1) - 1); ++cy)
+            for(int32_t cx = std::max(0, bx - lowerMargin); cx <= std::min(bx + upperMargin, sparseBricks.getNumBricks(0) - 1); ++cx)
+                if(sparseBricks.getBrickState(cx, cy, cz, iso) == BrickState::Intersected)
+                    return true;
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildSlab(
+    VolumeDataType const * data,
+    VolumeDataType const iso,
+    bool const generateSoup,
+    int32_t const s, int32_t const numSlabs,
+    SlabMesh & slab,
+    std::vector<DualMC *> & freeBuilders,
+    std::mutex & poolMutex,
+    std::condition_variable & poolCondition
+    ) {
+    // take a free builder
+    DualMC * builder;
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        poolCondition.wait(lock, [&]() { return !freeBuilders.empty(); });
+        builder = freeBuilders.back();
+        freeBuilders.pop_back();
+    }
+
     int32_t const reducedZ = dims[2] - 2;
+    int32_t const zBegin = int32_t(int64_t(reducedZ) * s / numSlabs);
+    int32_t const zEnd = int32_t(int64_t(reducedZ) * (s + 1) / numSlabs);
+    slab.vertices.clear();
+    slab.quads.clear();
+    builder->initialize(data, dims[0], dims[1], dims[2], generateManifold);
+    if(generateSoup) {
+        builder->buildQuadSoup(iso, zBegin, zEnd, slab.vertices, slab.quads);
+        slab.boundaryDualPoints.clear();
+        slab.topDualPoints.clear();
+    } else {
+        builder->buildSharedVerticesQuads(iso, zBegin, zEnd, slab.vertices, slab.quads);
+        // keep the dual points shared with the neighboring slabs, as the
+        // builder is reused for other slabs
+        slab.boundaryDualPoints.swap(builder->boundaryDualPoints);
+        builder->getTopDualPoints(s + 1 < numSlabs ? zEnd - 1 : -1, slab.topDualPoints);
+    }
+    slab.stats = builder->stats;
+
+    // return the builder to the pool
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        freeBuilders.push_back(builder);
+    }
+    poolCondition.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class MeshSink, class Executor> inline
+void DualMC<T,IndexType>::mergeSlabs(
+    std::vector<SlabMesh> & slabs,
+    MeshSink & sink,
+    Executor & executor
+    ) const {
+
+    int32_t const numSlabs = int32_t(slabs.size());
+
+    // Find dual points of each slab's lower boundary layer, which have
+    // already been generated by the previous slab. As the previous slab
+    // generates its vertices first, only the remaining ones are new. Slabs
+    // generate their vertices in the same order as the serial build, so
+    // appending the new vertices slab by slab reproduces the serial result.
+    size_t numVertices = 0;
+    size_t numQuads = 0;
+    for(int32_t s = 0; s < numSlabs; ++s) {
+        SlabMesh & slab = slabs[s];
+        // new vertices are marked with -1, shared ones with -2
+        slab.localToGlobal.assign(slab.vertices.size(), -1);
+        slab.sharedWithPrevious.clear();
+        if(s > 0) {
+            std::vector<std::pair<size_t,QuadIndexType>> const & previousPoints = slabs[s-1].topDualPoints;
+            for(auto const & boundaryPoint : slab.boundaryDualPoints) {
+                std::pair<size_t,QuadIndexType> const key(
+                    getLayerDualPointKey(boundaryPoint.cx, boundaryPoint.cy, boundaryPoint.pointCode), -1);
+                auto const previous = std::lower_bound(previousPoints.begin(), previousPoints.end(), key);
+                if(previous != previousPoints.end() && previous->first == key.first) {
+                    slab.sharedWithPrevious.emplace_back(boundaryPoint.index, previous->second);
+                    slab.localToGlobal[boundaryPoint.index] = -2;
+                }
+            }
+        }
+        slab.vertexOffset = numVertices;
+        slab.quadOffset = numQuads;
+        numVertices += slab.vertices.size() - slab.sharedWithPrevious.size();
+        numQuads += slab.quads.size();
+    }
+
+    // assign final indices to the new vertices of each slab and move them
+    // to the front of the slab's vertex list
+    executor.run(numSlabs, [&](int32_t const s) {
+        SlabMesh & slab = slabs[s];
+        QuadIndexType nextIndex = QuadIndexType(slab.vertexOffset);
+        size_t numNewVertices = 0;
+        for(size_t i = 0; i < slab.vertices.size(); ++i) {
+            if(slab.localToGlobal[i] == -1) {
+                slab.localToGlobal[i] = nextIndex;
+                slab.vertices[numNewVertices] = slab.vertices[i];
+                ++nextIndex;
+                ++numNewVertices;
+            }
+        }
+        slab.vertices.resize(numNewVertices);
+    });
+
+    // resolve the shared vertices and replace the quad indices by final ones
+    executor.run(numSlabs, [&](int32_t const s) {
+        SlabMesh & slab = slabs[s];
+        for(auto const & shared : slab.sharedWithPrevious) {
+            slab.localToGlobal[shared.first] = slabs[s-1].localToGlobal[shared.second];
+        }
+        std::vector<QuadIndexType> const & localToGlobal = slab.localToGlobal;
+        for(auto & q : slab.quads) {
+            q = Quad(localToGlobal[q.i0], localToGlobal[q.i1], localToGlobal[q.i2], localToGlobal[q.i3]);
+        }
+    });
+
+    passSlabs(slabs, sink, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class MeshSink, class Executor> inline
+void DualMC<T,IndexType>::passSlabs(std::vector<SlabMesh> const & slabs, MeshSink & sink, Executor &) const {
+    // pass the slabs in order, so quads only reference vertices of the same
+    // or previous slabs
+    for(auto const & slab : slabs) {
+        if(!slab.vertices.empty()) {
+            sink.addVertices(slab.vertices.data(), slab.vertices.size());
+        }
+        if(!slab.quads.empty()) {
+            sink.addQuads(slab.quads.data(), slab.quads.size());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class Executor> inline
+void DualMC<T,IndexType>::passSlabs(std::vector<SlabMesh> const & slabs, VectorMeshSink & sink, Executor & executor) const {
+    // the final sizes are known, so the vectors are only resized once
+    std::vector<Vertex> & vertices = sink.getVertices();
+    std::vector<Quad> & quads = sink.getQuads();
+    size_t const vertexBegin = vertices.size();
+    size_t const quadBegin = quads.size();
+    SlabMesh const & lastSlab = slabs.back();
+    vertices.resize(vertexBegin + lastSlab.vertexOffset + lastSlab.vertices.size());
+    quads.resize(quadBegin + lastSlab.quadOffset + lastSlab.quads.size());
+    executor.run(int32_t(slabs.size()), [&](int32_t const s) {
+        SlabMesh const & slab = slabs[s];
+        std::copy(slab.vertices.begin(), slab.vertices.end(), vertices.begin() + vertexBegin + slab.vertexOffset);
+        std::copy(slab.quads.begin(), slab.quads.end(), quads.begin() + quadBegin + slab.quadOffset);
+    });
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildQuadSoup(
+    VolumeDataType const iso,
+    int32_t const zBegin, int32_t const zEnd,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+    beginQuadSoup(zBegin);
+    for(int32_t z = zBegin; z < zEnd; ++z) {
+        buildQuadSoupLayer(iso, z, zBegin, vertices);
+    }
+    addQuadSoupQuads(vertices.size(), quads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::beginQuadSoup(int32_t const zBegin) {
+    vertexIndexOffset = 0;
+    // quad soups do not share dual points with the previous slab
+    boundaryDualPoints.clear();
+    // The cell layer below the slab is referenced by the first edge layer
+    sliceCache.resize(cellLayerSize * 4 * 2);
+    resetSliceCacheLayer(zBegin - 1);
+    soupDualPoints[(zBegin - 1) & 1].clear();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildQuadSoupLayer(
+    VolumeDataType const iso,
+    int32_t const z, int32_t const zBegin,
+    std::vector<Vertex> & vertices
+    ) {
+
+    int32_t const reducedY = dims[1] - 2;
 
     Vertex vertex0;
     Vertex vertex1;
     Vertex vertex2;
     Vertex vertex3;
-    int pointCode;
-
-    // iterate voxels
-    for(int32_t z = 0; z < reducedZ; ++z)
-        for(int32_t y = 0; y < reducedY; ++y)
-            for(int32_t x = 0; x < reducedX; ++x) {
-                // construct quad for x edge
-                if(z > 0 && y > 0) {
-                    // is edge intersected?
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x+1,y,z)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x+1,y,z)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = getDualPointCode(x,y,z,iso,EDGE0);
-                        calculateDualPoint(x,y,z,iso,pointCode, vertex0);
-
-                        pointCode = getDualPointCode(x,y,z-1,iso,EDGE2);
-                        calculateDualPoint(x,y,z-1,iso,pointCode, vertex1);
-
-                        pointCode = getDualPointCode(x,y-1,z-1,iso,EDGE6);
-                        calculateDualPoint(x,y-1,z-1,iso,pointCode, vertex2);
-
-                        pointCode = getDualPointCode(x,y-1,z,iso,EDGE4);
-                        calculateDualPoint(x,y-1,z,iso,pointCode, vertex3);
-                        
-                        if(entering) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
-                        }
-                    }
-                }
-                
-                // construct quad for y edge
-                if(z > 0 && x > 0) {
-                    // is edge intersected?
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x,y+1,z)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x,y+1,z)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = getDualPointCode(x,y,z,iso,EDGE8);
-                        calculateDualPoint(x,y,z,iso,pointCode, vertex0);
-
-                        pointCode = getDualPointCode(x,y,z-1,iso,EDGE11);
-                        calculateDualPoint(x,y,z-1,iso,pointCode, vertex1);
-
-                        pointCode = getDualPointCode(x-1,y,z-1,iso,EDGE10);
-                        calculateDualPoint(x-1,y,z-1,iso,pointCode, vertex2);
-
-                        pointCode = getDualPointCode(x-1,y,z,iso,EDGE9);
-                        calculateDualPoint(x-1,y,z,iso,pointCode, vertex3);
-                        
-                        if(exiting) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
-                        }
-                    }
-                }
 
-                // construct quad for z edge
-                if(x > 0 && y > 0) {
-                    // is edge intersected?
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x,y,z+1)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x,y,z+1)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        pointCode = getDualPointCode(x,y,z,iso,EDGE3);
-                        calculateDualPoint(x,y,z,iso,pointCode, vertex0);
-                        
-                        pointCode = getDualPointCode(x-1,y,z,iso,EDGE1);
-                        calculateDualPoint(x-1,y,z,iso,pointCode, vertex1);
-
-                        pointCode = getDualPointCode(x-1,y-1,z,iso,EDGE5);
-                        calculateDualPoint(x-1,y-1,z,iso,pointCode, vertex2);
-
-                        pointCode = getDualPointCode(x,y-1,z,iso,EDGE7);
-                        calculateDualPoint(x,y-1,z,iso,pointCode, vertex3);
-                        
-                        if(exiting) {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex1);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex3);
-                        } else {
-                            vertices.emplace_back(vertex0);
-                            vertices.emplace_back(vertex3);
-                            vertices.emplace_back(vertex2);
-                            vertices.emplace_back(vertex1);
-                        }
-                    }
-                }
-            }
-    
-    // generate triangle soup quads
-    size_t const numQuads = vertices.size() / 4;
-    quads.reserve(numQuads);
+    // The first phase classifies the cells and compacts the crossed edges
+    // of the layer, so the second phase only visits edges generating quads.
+    DUALMC_STATS(BuildStats::Clock::time_point const classificationStartTime = BuildStats::Clock::now());
+    updateCellCodes(z, zBegin, iso);
+    size_t const numCrossedEdges = compactCrossedEdgeLayer(z);
+    DUALMC_STATS(stats.crossedEdges += numCrossedEdges);
+    (void)numCrossedEdges;
+    DUALMC_STATS(stats.classificationTime += BuildStats::secondsSince(classificationStartTime));
+    DUALMC_STATS(BuildStats::Clock::time_point const generationStartTime = BuildStats::Clock::now());
+    resetSliceCacheLayer(z);
+    soupDualPoints[z & 1].clear();
+    for(int32_t y = 0; y < reducedY; ++y) {
+        for(size_t e = crossedEdgeRows[y]; e < crossedEdgeRows[y+1]; ++e) {
+            // generate the quad of the crossed edge
+            uint32_t const edge = crossedEdges[e];
+            int32_t const x = int32_t(edge >> 3);
+            int const axis = int(edge & 3);
+            int8_t const (&cells)[4][3] = crossedEdgeCells[axis];
+            DMCEdgeCode const (&points)[4] = crossedEdgeDualPoints[axis];
+            getSoupDualPoint(x+cells[0][0],y+cells[0][1],z+cells[0][2],iso,points[0],vertex0);
+            getSoupDualPoint(x+cells[1][0],y+cells[1][1],z+cells[1][2],iso,points[1],vertex1);
+            getSoupDualPoint(x+cells[2][0],y+cells[2][1],z+cells[2][2],iso,points[2],vertex2);
+            getSoupDualPoint(x+cells[3][0],y+cells[3][1],z+cells[3][2],iso,points[3],vertex3);
+            
+            // the orientation depends on the direction the edge is crossed
+            bool const swapped = ((edge >> 2) & 1) != crossedEdgeInside[axis];
+            vertices.emplace_back(vertex0);
+            vertices.emplace_back(swapped ? vertex3 : vertex1);
+            vertices.emplace_back(vertex2);
+            vertices.emplace_back(swapped ? vertex1 : vertex3);
+        }
+    }
+    DUALMC_STATS(stats.quadGenerationTime += BuildStats::secondsSince(generationStartTime));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::addQuadSoupQuads(size_t const numVertices, std::vector<Quad> & quads) const {
+    // every four consecutive vertices form a quad
+    size_t const numQuads = numVertices / 4;
+    quads.reserve(quads.size() + numQuads);
     for (size_t i = 0; i < numQuads; ++i) {
-        quads.emplace_back(i * 4, i * 4 + 1, i * 4 + 2, i * 4 + 3);
+        QuadIndexType const first = vertexIndexOffset + QuadIndexType(i * 4);
+        quads.emplace_back(first, first + 1, first + 2, first + 3);
     }
 }
 
 //------------------------------------------------------------------------------
 
-template<class T> inline
-void DualMC<T>::buildSharedVerticesQuads(
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildSharedVerticesQuads(
     VolumeDataType const iso,
+    int32_t const zBegin, int32_t const zEnd,
     std::vector<Vertex> & vertices,
     std::vector<Quad> & quads
     ) {
-    
+    beginSharedVerticesQuads(zBegin);
+    for(int32_t z = zBegin; z < zEnd; ++z) {
+        buildSharedVerticesQuadsLayer(iso, z, zBegin, vertices, quads);
+    }
+}
 
-    int32_t const reducedX = dims[0] - 2;
-    int32_t const reducedY = dims[1] - 2;
-    int32_t const reducedZ = dims[2] - 2;
+//------------------------------------------------------------------------------
 
-    QuadIndexType i0,i1,i2,i3;
-    
-    pointToIndex.clear();
-
-    // iterate voxels
-    for(int32_t z = 0; z < reducedZ; ++z)
-        for(int32_t y = 0; y < reducedY; ++y)
-            for(int32_t x = 0; x < reducedX; ++x) {
-                // construct quads for x edge
-                if(z > 0 && y > 0) {
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x+1,y,z)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x+1,y,z)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        i0 = getSharedDualPointIndex(x,y,z,iso,EDGE0,vertices);
-                        i1 = getSharedDualPointIndex(x,y,z-1,iso,EDGE2,vertices);
-                        i2 = getSharedDualPointIndex(x,y-1,z-1,iso,EDGE6,vertices);
-                        i3 = getSharedDualPointIndex(x,y-1,z,iso,EDGE4,vertices);
-                        
-                        if(entering) {
-                            quads.emplace_back(i0,i1,i2,i3);
-                        } else {
-                            quads.emplace_back(i0,i3,i2,i1);
-                        }
-                    }
-                }
-                
-                // construct quads for y edge
-                if(z > 0 && x > 0) {
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x,y+1,z)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x,y+1,z)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        i0 = getSharedDualPointIndex(x,y,z,iso,EDGE8,vertices);
-                        i1 = getSharedDualPointIndex(x,y,z-1,iso,EDGE11,vertices);
-                        i2 = getSharedDualPointIndex(x-1,y,z-1,iso,EDGE10,vertices);
-                        i3 = getSharedDualPointIndex(x-1,y,z,iso,EDGE9,vertices);
-                        
-                        if(exiting) {
-                            quads.emplace_back(i0,i1,i2,i3);
-                        } else {
-                            quads.emplace_back(i0,i3,i2,i1);
-                        }
-                    }
-                }
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::beginSharedVerticesQuads(int32_t const zBegin) {
+    vertexIndexOffset = 0;
+    slabBeginZ = zBegin;
+    boundaryDualPoints.clear();
+    if(sharedVertexEngine == SharedVertexEngine::SliceCache) {
+        // The cell layer below the slab is referenced by the first edge layer
+        sliceCache.resize(cellLayerSize * 4 * 2);
+        resetSliceCacheLayer(zBegin - 1);
+    } else {
+        pointToIndex.clear();
+    }
+}
 
-                // construct quads for z edge
-                if(x > 0 && y > 0) {
-                    bool const entering = data[gA(x,y,z)] < iso && data[gA(x,y,z+1)] >= iso;
-                    bool const exiting  = data[gA(x,y,z)] >= iso && data[gA(x,y,z+1)] < iso;
-                    if(entering || exiting){
-                        // generate quad
-                        i0 = getSharedDualPointIndex(x,y,z,iso,EDGE3,vertices);                        
-                        i1 = getSharedDualPointIndex(x-1,y,z,iso,EDGE1,vertices);
-                        i2 = getSharedDualPointIndex(x-1,y-1,z,iso,EDGE5,vertices);
-                        i3 = getSharedDualPointIndex(x,y-1,z,iso,EDGE7,vertices);
-                        
-                        if(exiting) {
-                            quads.emplace_back(i0,i1,i2,i3);
-                        } else {
-                            quads.emplace_back(i0,i3,i2,i1);
-                        }
-                    }
-                } 
-            }
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMC<T,IndexType>::buildSharedVerticesQuadsLayer(
+    VolumeDataType const iso,
+    int32_t const z, int32_t const zBegin,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+
+    int32_t const reducedY = dims[1] - 2;
+
+    // The first phase classifies the cells and compacts the crossed edges
+    // of the layer, so the second phase only visits edges generating quads.
+    DUALMC_STATS(BuildStats::Clock::time_point const classificationStartTime = BuildStats::Clock::now());
+    updateCellCodes(z, zBegin, iso);
+    size_t const numCrossedEdges = compactCrossedEdgeLayer(z);
+    DUALMC_STATS(stats.crossedEdges += numCrossedEdges);
+    (void)numCrossedEdges;
+    DUALMC_STATS(stats.classificationTime += BuildStats::secondsSince(classificationStartTime));
+    DUALMC_STATS(BuildStats::Clock::time_point const generationStartTime = BuildStats::Clock::now());
+    if(sharedVertexEngine == SharedVertexEngine::SliceCache) {
+        resetSliceCacheLayer(z);
+    }
+    for(int32_t y = 0; y < reducedY; ++y) {
+        for(size_t e = crossedEdgeRows[y]; e < crossedEdgeRows[y+1]; ++e) {
+            // generate the quad of the crossed edge
+            uint32_t const edge = crossedEdges[e];
+            int32_t const x = int32_t(edge >> 3);
+            int const axis = int(edge & 3);
+            int8_t const (&cells)[4][3] = crossedEdgeCells[axis];
+            DMCEdgeCode const (&points)[4] = crossedEdgeDualPoints[axis];
+            QuadIndexType const i0 = getSharedDualPointIndex(x+cells[0][0],y+cells[0][1],z+cells[0][2],iso,points[0],vertices);
+            QuadIndexType const i1 = getSharedDualPointIndex(x+cells[1][0],y+cells[1][1],z+cells[1][2],iso,points[1],vertices);
+            QuadIndexType const i2 = getSharedDualPointIndex(x+cells[2][0],y+cells[2][1],z+cells[2][2],iso,points[2],vertices);
+            QuadIndexType const i3 = getSharedDualPointIndex(x+cells[3][0],y+cells[3][1],z+cells[3][2],iso,points[3],vertices);
+            
+            // the orientation depends on the direction the edge is crossed
+            bool const swapped = ((edge >> 2) & 1) != crossedEdgeInside[axis];
+            quads.emplace_back(i0, swapped ? i3 : i1, i2, swapped ? i1 : i3);
+        }
+    }
+    DUALMC_STATS(stats.quadGenerationTime += BuildStats::secondsSince(generationStartTime));
 }
+
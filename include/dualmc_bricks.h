@@ -0,0 +1,417 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_BRICKS_H_INCLUDED
+#define DUALMC_BRICKS_H_INCLUDED
+
+/// \file   dualmc_bricks.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <vector>
+
+// executor used by the parallel build function
+#include "dualmc_executor.h"
+
+namespace dualmc {
+
+/// Classification of a brick with respect to an iso value.
+enum class BrickState {
+    /// all voxels of the brick are below the iso value
+    Outside,
+    /// all voxels of the brick are greater or equal to the iso value
+    Inside,
+    /// the brick contains voxels on both sides of the iso value
+    Intersected
+};
+
+/// \class  MinMaxBricks
+/// Acceleration structure for skipping empty regions during extraction.
+/// The cells of a volume are partitioned into cubic bricks and the value
+/// range of all voxels touched by the cells of a brick is stored. Cells in
+/// bricks, which are not intersected by the iso surface, can be classified
+/// without reading the volume. As the structure does not depend on the iso
+/// value, it can be reused for extracting several iso surfaces of the same
+/// volume. See DualMC::setMinMaxBricks.
+/// For floating point volumes, NaN values are ignored in the value ranges,
+/// so volumes must not contain NaN values when used with bricks.
+template<class T> class MinMaxBricks {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+
+    /// Default constructor. Creates empty bricks, which do not match any volume.
+    MinMaxBricks();
+
+    /// Compute the value ranges for a volume. The brick size is the number
+    /// of cells along each axis of a brick.
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int32_t const brickSize = 8
+        );
+
+    /// Parallel version of build. Layers of bricks are processed
+    /// concurrently by the given executor.
+    template<class Executor>
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int32_t const brickSize,
+        Executor & executor
+        );
+
+    /// Compute the value ranges for a sparse volume, see SparseVolume for the
+    /// requirements on the volume type. The brick size is the one of the
+    /// sparse volume. The ranges are computed from the allocated bricks and
+    /// the background value, without densifying the volume. They may be
+    /// larger than the exact ranges of the cells.
+    template<class SparseVolumeType>
+    void buildSparse(
+        SparseVolumeType const & volume,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ
+        );
+
+    /// Compute the value ranges for a volume given by an implicit field, see
+    /// DualMC::buildImplicit for the requirements on the field type. The
+    /// ranges are the ones returned by the field for the voxels of each brick,
+    /// so the field is not evaluated.
+    template<class FieldType>
+    void buildImplicit(
+        FieldType const & field,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int32_t const brickSize = 8
+        );
+
+    /// Check whether the bricks were built for the given volume.
+    bool isBuiltFor(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ
+        ) const;
+
+    /// Get the number of cells along each axis of a brick.
+    int32_t getBrickSize() const;
+
+    /// Get the number of bricks along the given axis.
+    int32_t getNumBricks(int const axis) const;
+
+    /// Get the smallest voxel value of a brick.
+    VolumeDataType getMin(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+    /// Get the largest voxel value of a brick.
+    VolumeDataType getMax(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+    /// Classify a brick with respect to the given iso value.
+    BrickState getBrickState(int32_t const bx, int32_t const by, int32_t const bz,
+      VolumeDataType const iso) const;
+
+private:
+
+    /// Compute the value ranges of the brick layer bz.
+    void computeBrickLayer(int32_t const bz);
+
+    /// Compute a linearized brick index.
+    size_t gB(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+private:
+
+    /// volume the bricks were built for
+    VolumeDataType const * data;
+
+    /// volume extent array for x-,y-, and z-dimension
+    int32_t dims[3];
+
+    /// number of cells along each axis of a brick
+    int32_t brickSize;
+
+    /// number of bricks for x-,y-, and z-dimension
+    int32_t numBricks[3];
+
+    /// smallest voxel value of each brick
+    std::vector<VolumeDataType> minValues;
+
+    /// largest voxel value of each brick
+    std::vector<VolumeDataType> maxValues;
+};
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+MinMaxBricks<T>::MinMaxBricks() : data(nullptr), brickSize(1) {
+    for(int i = 0; i < 3; ++i) {
+        dims[i] = 0;
+        numBricks[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void MinMaxBricks<T>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int32_t const brickSize
+    ) {
+    SerialExecutor executor;
+    build(data, dimX, dimY, dimZ, brickSize, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> template<class Executor> inline
+void MinMaxBricks<T>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int32_t const brickSize,
+    Executor & executor
+    ) {
+    this->data = data;
+    this->dims[0] = dimX;
+    this->dims[1] = dimY;
+    this->dims[2] = dimZ;
+    this->brickSize = std::max<int32_t>(1, brickSize);
+
+    // bricks partition the cells of the volume
+    for(int i = 0; i < 3; ++i) {
+        int32_t const numCells = std::max(0, dims[i] - 1);
+        numBricks[i] = (numCells + this->brickSize - 1) / this->brickSize;
+    }
+    size_t const totalBricks = size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]);
+    minValues.resize(totalBricks);
+    maxValues.resize(totalBricks);
+
+    executor.run(numBricks[2], [this](int32_t const bz) {
+        computeBrickLayer(bz);
+    });
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> template<class SparseVolumeType> inline
+void MinMaxBricks<T>::buildSparse(
+    SparseVolumeType const & volume,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ
+    ) {
+    data = nullptr;
+    dims[0] = dimX;
+    dims[1] = dimY;
+    dims[2] = dimZ;
+    brickSize = std::max<int32_t>(1, volume.getBrickSize());
+
+    // bricks partition the cells of the volume, volume bricks its voxels
+    int32_t numVoxelBricks[3];
+    for(int i = 0; i < 3; ++i) {
+        int32_t const numCells = std::max(0, dims[i] - 1);
+        numBricks[i] = (numCells + brickSize - 1) / brickSize;
+        numVoxelBricks[i] = (std::max(0, dims[i]) + brickSize - 1) / brickSize;
+    }
+    size_t const totalBricks = size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]);
+    minValues.resize(totalBricks);
+    maxValues.resize(totalBricks);
+    if(totalBricks == 0)
+        return;
+
+    // value ranges of the voxels of the volume bricks inside the volume
+    size_t const totalVoxelBricks = size_t(numVoxelBricks[0]) * size_t(numVoxelBricks[1]) * size_t(numVoxelBricks[2]);
+    std::vector<VolumeDataType> voxelMinValues(totalVoxelBricks, volume.getBackground());
+    std::vector<VolumeDataType> voxelMaxValues(totalVoxelBricks, volume.getBackground());
+    size_t vb = 0;
+    for(int32_t bz = 0; bz < numVoxelBricks[2]; ++bz) {
+        int32_t const sizeZ = std::min(brickSize, dims[2] - bz * brickSize);
+        for(int32_t by = 0; by < numVoxelBricks[1]; ++by) {
+            int32_t const sizeY = std::min(brickSize, dims[1] - by * brickSize);
+            for(int32_t bx = 0; bx < numVoxelBricks[0]; ++bx, ++vb) {
+                VolumeDataType const * const brick = volume.getBrick(bx, by, bz);
+                if(!brick)
+                    continue;
+                int32_t const sizeX = std::min(brickSize, dims[0] - bx * brickSize);
+                VolumeDataType minValue = brick[0];
+                VolumeDataType maxValue = brick[0];
+                for(int32_t z = 0; z < sizeZ; ++z) {
+                    for(int32_t y = 0; y < sizeY; ++y) {
+                        VolumeDataType const * const row = brick + size_t(brickSize) * (y + size_t(brickSize) * z);
+                        for(int32_t x = 0; x < sizeX; ++x) {
+                            VolumeDataType const value = row[x];
+                            minValue = value < minValue ? value : minValue;
+                            maxValue = value > maxValue ? value : maxValue;
+                        }
+                    }
+                }
+                voxelMinValues[vb] = minValue;
+                voxelMaxValues[vb] = maxValue;
+            }
+        }
+    }
+
+    // The cells of a brick touch the voxels of the volume brick with the same
+    // coordinates and the first voxels of the following volume bricks.
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        int32_t const lastZ = std::min(bz + 1, numVoxelBricks[2] - 1);
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            int32_t const lastY = std::min(by + 1, numVoxelBricks[1] - 1);
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx) {
+                int32_t const lastX = std::min(bx + 1, numVoxelBricks[0] - 1);
+                VolumeDataType minValue = volume.getBackground();
+                VolumeDataType maxValue = minValue;
+                bool first = true;
+                for(int32_t z = bz; z <= lastZ; ++z) {
+                    for(int32_t y = by; y <= lastY; ++y) {
+                        for(int32_t x = bx; x <= lastX; ++x) {
+                            size_t const v = size_t(x) + size_t(numVoxelBricks[0]) * (size_t(y) + size_t(numVoxelBricks[1]) * size_t(z));
+                            if(first || voxelMinValues[v] < minValue)
+                                minValue = voxelMinValues[v];
+                            if(first || voxelMaxValues[v] > maxValue)
+                                maxValue = voxelMaxValues[v];
+                            first = false;
+                        }
+                    }
+                }
+                size_t const b = gB(bx, by, bz);
+                minValues[b] = minValue;
+                maxValues[b] = maxValue;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> template<class FieldType> inline
+void MinMaxBricks<T>::buildImplicit(
+    FieldType const & field,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int32_t const brickSize
+    ) {
+    data = nullptr;
+    dims[0] = dimX;
+    dims[1] = dimY;
+    dims[2] = dimZ;
+    this->brickSize = std::max<int32_t>(1, brickSize);
+
+    for(int i = 0; i < 3; ++i) {
+        int32_t const numCells = std::max(0, dims[i] - 1);
+        numBricks[i] = (numCells + this->brickSize - 1) / this->brickSize;
+    }
+    size_t const totalBricks = size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]);
+    minValues.resize(totalBricks);
+    maxValues.resize(totalBricks);
+
+    // the voxels of a brick include the upper corners of its last cells
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx) {
+                int32_t const lower[3] = {bx * this->brickSize, by * this->brickSize, bz * this->brickSize};
+                int32_t upper[3];
+                for(int i = 0; i < 3; ++i) {
+                    upper[i] = std::min(lower[i] + this->brickSize, dims[i] - 1);
+                }
+                size_t const b = gB(bx, by, bz);
+                field.getRange(lower, upper, minValues[b], maxValues[b]);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void MinMaxBricks<T>::computeBrickLayer(int32_t const bz) {
+    // the voxels of a brick include the upper corners of its last cells
+    int32_t const z0 = bz * brickSize;
+    int32_t const z1 = std::min(z0 + brickSize, dims[2] - 1);
+    for(int32_t by = 0; by < numBricks[1]; ++by) {
+        int32_t const y0 = by * brickSize;
+        int32_t const y1 = std::min(y0 + brickSize, dims[1] - 1);
+        for(int32_t bx = 0; bx < numBricks[0]; ++bx) {
+            int32_t const x0 = bx * brickSize;
+            int32_t const x1 = std::min(x0 + brickSize, dims[0] - 1);
+            VolumeDataType const * const first = data + x0 + size_t(dims[0]) * (y0 + size_t(dims[1]) * z0);
+            VolumeDataType minValue = *first;
+            VolumeDataType maxValue = *first;
+            for(int32_t z = z0; z <= z1; ++z) {
+                for(int32_t y = y0; y <= y1; ++y) {
+                    VolumeDataType const * const row = data + size_t(dims[0]) * (y + size_t(dims[1]) * z);
+                    for(int32_t x = x0; x <= x1; ++x) {
+                        VolumeDataType const value = row[x];
+                        minValue = value < minValue ? value : minValue;
+                        maxValue = value > maxValue ? value : maxValue;
+                    }
+                }
+            }
+            size_t const b = gB(bx, by, bz);
+            minValues[b] = minValue;
+            maxValues[b] = maxValue;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+bool MinMaxBricks<T>::isBuiltFor(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ
+    ) const {
+    return this->data == data && dims[0] == dimX && dims[1] == dimY && dims[2] == dimZ;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t MinMaxBricks<T>::getBrickSize() const {
+    return brickSize;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t MinMaxBricks<T>::getNumBricks(int const axis) const {
+    return numBricks[axis];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T MinMaxBricks<T>::getMin(int32_t const bx, int32_t const by, int32_t const bz) const {
+    return minValues[gB(bx, by, bz)];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T MinMaxBricks<T>::getMax(int32_t const bx, int32_t const by, int32_t const bz) const {
+    return maxValues[gB(bx, by, bz)];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+BrickState MinMaxBricks<T>::getBrickState(int32_t const bx, int32_t const by, int32_t const bz,
+  VolumeDataType const iso) const {
+    size_t const b = gB(bx, by, bz);
+    if(maxValues[b] < iso)
+        return BrickState::Outside;
+    if(minValues[b] >= iso)
+        return BrickState::Inside;
+    return BrickState::Intersected;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+size_t MinMaxBricks<T>::gB(int32_t const bx, int32_t const by, int32_t const bz) const {
+    return size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz));
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_BRICKS_H_INCLUDED
@@ -0,0 +1,426 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_COMPACT_H_INCLUDED
+#define DUALMC_COMPACT_H_INCLUDED
+
+/// \file   dualmc_compact.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// dual mc builder vertex and quad definitions
+#include "dualmc.h"
+
+namespace dualmc {
+
+/// \class  CompactMeshState
+/// Prediction state shared by the compact mesh encoder and decoder.
+///
+/// A compact mesh stream starts with the four bytes "DMCQ", a version byte,
+/// and the number of bits per vertex offset, which is 8 or 16. It is followed
+/// by chunks of vertices and quads in the order they were passed to the
+/// encoder. A chunk is a tag byte, 'V' or 'Q', followed by the number of
+/// vertices or quads and their codes. All numbers are unsigned LEB128
+/// variable length integers, signed ones are zigzag mapped first.
+///
+/// A vertex is stored as the cell containing it, i.e. the integer part of
+/// its coordinates, and three quantized offsets inside the cell in little
+/// endian byte order. The cell is the difference to the cell of the previous
+/// vertex. Its first number holds the x difference and in the two lowest
+/// bits whether the y and z differences follow (1: y, 2: y and z). Dual
+/// points of consecutive vertices are mostly in the same row of cells.
+///
+/// Each quad index is stored as the difference to a predicted index, whose
+/// selector is kept in the three lowest bits. Selector 0 predicts the next
+/// vertex, which has not been referenced yet, selectors 1-7 the corner
+/// indices of the last quads, starting with the last corner of the previous
+/// quad. The builders generate quads edge by edge, so quads mostly reference
+/// new vertices or recently referenced ones.
+class CompactMeshState {
+public:
+    /// number of recent quad corners used for predicting indices
+    static int constexpr NUM_RECENT = 7;
+
+    /// Initialize the state for the beginning of a stream.
+    CompactMeshState();
+
+    /// Get the index predicted by the given selector.
+    int64_t getPrediction(int const selector) const;
+
+    /// Update the predictions with the corner indices of a quad.
+    void addQuad(int64_t const (&indices)[4]);
+
+    /// cell of the last vertex
+    int64_t cell[3];
+
+    /// number of vertices so far
+    int64_t numVertices;
+
+    /// number of quads so far
+    int64_t numQuads;
+
+private:
+    /// largest quad index so far
+    int64_t maxIndex;
+
+    /// corner indices of the last quads, the most recent one first
+    int64_t recent[NUM_RECENT];
+};
+
+/// \class  BasicCompactMeshSink
+/// Mesh sink, which encodes the mesh into a compact stream of bytes, see
+/// CompactMeshState for the format. Vertices are quantized in their voxel
+/// cell, so the error of each coordinate is at most half of 1/255 or 1/65535
+/// of a cell for 8 and 16 bit offsets. The stream can be sent as soon as a
+/// chunk was added and is decoded by decodeCompactMesh.
+template<class IndexType> class BasicCompactMeshSink {
+public:
+    /// Initializing constructor, which writes the stream header. The stream
+    /// should be empty. The number of bits per vertex offset is 8 or 16,
+    /// other values select 8 bits.
+    explicit BasicCompactMeshSink(std::vector<uint8_t> & stream, int const offsetBits = 8);
+
+    /// Encode vertices.
+    void addVertices(Vertex const * vertices, size_t const numVertices);
+
+    /// Encode quads.
+    void addQuads(BasicQuad<IndexType> const * quads, size_t const numQuads);
+
+    /// Get the number of encoded vertices.
+    size_t getNumVertices() const;
+
+    /// Get the number of encoded quads.
+    size_t getNumQuads() const;
+
+private:
+    /// Write an unsigned variable length integer and return the end of it.
+    static uint8_t * writeUnsigned(uint64_t value, uint8_t * out);
+
+    /// Enlarge the stream by the maximum size of a chunk and return the
+    /// start of the new space. The stream is shrunk by finishChunk.
+    uint8_t * beginChunk(uint8_t const tag, size_t const count, size_t const maxCodeSize);
+
+    /// Shrink the stream to the end of the written chunk.
+    void finishChunk(uint8_t const * end);
+
+    /// stream the mesh is appended to
+    std::vector<uint8_t> & stream;
+
+    /// number of bits per vertex offset
+    int offsetBits;
+
+    /// prediction state
+    CompactMeshState state;
+};
+
+/// compact mesh sink for quads with the default 32-bit vertex indices
+typedef BasicCompactMeshSink<QuadIndexType> CompactMeshSink;
+
+/// Decode a compact mesh stream and append its vertices and quads. Returns
+/// false if the stream is malformed or a quad index does not fit IndexType.
+/// A stream truncated after a complete chunk is decoded up to that chunk.
+template<class IndexType>
+bool decodeCompactMesh(
+    uint8_t const * stream,
+    size_t const size,
+    std::vector<Vertex> & vertices,
+    std::vector<BasicQuad<IndexType>> & quads
+    );
+
+// inline function definitions
+
+namespace compact {
+
+/// Map a signed integer to an unsigned one, which is small for small magnitudes.
+inline uint64_t zigzag(int64_t const value) {
+    return (uint64_t(value) << 1) ^ (value < 0 ? ~uint64_t(0) : uint64_t(0));
+}
+
+/// Inverse of zigzag.
+inline int64_t unzigzag(uint64_t const value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+/// Read an unsigned variable length integer. Returns false if the stream ends
+/// before the integer or the integer does not fit 64 bits.
+inline bool readUnsigned(uint8_t const * & position, uint8_t const * const end, uint64_t & value) {
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(position == end)
+            return false;
+        uint8_t const byte = *position++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // END: namespace compact
+
+//------------------------------------------------------------------------------
+
+inline
+CompactMeshState::CompactMeshState() : numVertices(0), numQuads(0), maxIndex(-1) {
+    for(int i = 0; i < 3; ++i) {
+        cell[i] = 0;
+    }
+    for(int i = 0; i < NUM_RECENT; ++i) {
+        recent[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+int64_t CompactMeshState::getPrediction(int const selector) const {
+    return selector == 0 ? maxIndex + 1 : recent[selector - 1];
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void CompactMeshState::addQuad(int64_t const (&indices)[4]) {
+    for(int i = NUM_RECENT - 1; i >= 4; --i) {
+        recent[i] = recent[i - 4];
+    }
+    for(int i = 0; i < 4; ++i) {
+        recent[i] = indices[3 - i];
+        maxIndex = std::max(maxIndex, indices[i]);
+    }
+    ++numQuads;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+BasicCompactMeshSink<IndexType>::BasicCompactMeshSink(std::vector<uint8_t> & stream, int const offsetBits)
+  : stream(stream), offsetBits(offsetBits == 16 ? 16 : 8) {
+    uint8_t const header[6] = {'D', 'M', 'C', 'Q', 1, uint8_t(this->offsetBits)};
+    for(uint8_t const byte : header) {
+        stream.push_back(byte);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicCompactMeshSink<IndexType>::addVertices(Vertex const * vertices, size_t const numVertices) {
+    if(numVertices == 0)
+        return;
+    // up to three differences and offsets per vertex
+    int const numOffsetBytes = offsetBits / 8;
+    uint8_t * out = beginChunk('V', numVertices, 30 + 3 * numOffsetBytes);
+    uint32_t const maxOffsetValue = (1u << offsetBits) - 1;
+    float const maxOffset = float(maxOffsetValue);
+    for(size_t i = 0; i < numVertices; ++i) {
+        Vertex const & v = vertices[i];
+        VertexComponentsType const coordinates[3] = {v.x, v.y, v.z};
+        int64_t cell[3];
+        uint32_t offsets[3];
+        for(int a = 0; a < 3; ++a) {
+            // conversions round towards zero, which is corrected for negative
+            // coordinates
+            cell[a] = int64_t(coordinates[a]);
+            if(VertexComponentsType(cell[a]) > coordinates[a])
+                --cell[a];
+            float const offset = (coordinates[a] - VertexComponentsType(cell[a])) * maxOffset + 0.5f;
+            offsets[a] = std::min(uint32_t(std::max(offset, 0.0f)), maxOffsetValue);
+        }
+
+        // the y and z differences are only stored if they are not zero
+        int64_t const dx = cell[0] - state.cell[0];
+        int64_t const dy = cell[1] - state.cell[1];
+        int64_t const dz = cell[2] - state.cell[2];
+        uint64_t const mode = dz != 0 ? 2 : (dy != 0 ? 1 : 0);
+        out = writeUnsigned((compact::zigzag(dx) << 2) | mode, out);
+        if(mode > 0)
+            out = writeUnsigned(compact::zigzag(dy), out);
+        if(mode > 1)
+            out = writeUnsigned(compact::zigzag(dz), out);
+        for(int a = 0; a < 3; ++a) {
+            state.cell[a] = cell[a];
+            for(int b = 0; b < numOffsetBytes; ++b) {
+                *out++ = uint8_t(offsets[a] >> (8 * b));
+            }
+        }
+    }
+    finishChunk(out);
+    state.numVertices += int64_t(numVertices);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicCompactMeshSink<IndexType>::addQuads(BasicQuad<IndexType> const * quads, size_t const numQuads) {
+    if(numQuads == 0)
+        return;
+    uint8_t * out = beginChunk('Q', numQuads, 40);
+    for(size_t i = 0; i < numQuads; ++i) {
+        BasicQuad<IndexType> const & q = quads[i];
+        int64_t const indices[4] = {int64_t(q.i0), int64_t(q.i1), int64_t(q.i2), int64_t(q.i3)};
+        for(int c = 0; c < 4; ++c) {
+            // the smallest difference has the shortest code
+            uint64_t bestDifference = compact::zigzag(indices[c] - state.getPrediction(0));
+            uint64_t bestSelector = 0;
+            for(int selector = 1; selector <= CompactMeshState::NUM_RECENT; ++selector) {
+                uint64_t const difference = compact::zigzag(indices[c] - state.getPrediction(selector));
+                bestSelector = difference < bestDifference ? uint64_t(selector) : bestSelector;
+                bestDifference = difference < bestDifference ? difference : bestDifference;
+            }
+            out = writeUnsigned((bestDifference << 3) | bestSelector, out);
+        }
+        state.addQuad(indices);
+    }
+    finishChunk(out);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+size_t BasicCompactMeshSink<IndexType>::getNumVertices() const {
+    return size_t(state.numVertices);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+size_t BasicCompactMeshSink<IndexType>::getNumQuads() const {
+    return size_t(state.numQuads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+uint8_t * BasicCompactMeshSink<IndexType>::writeUnsigned(uint64_t value, uint8_t * out) {
+    while(value >= 0x80) {
+        *out++ = uint8_t(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+    return out;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+uint8_t * BasicCompactMeshSink<IndexType>::beginChunk(uint8_t const tag, size_t const count,
+  size_t const maxCodeSize) {
+    // tag and count
+    size_t const start = stream.size();
+    stream.resize(start + 11 + count * maxCodeSize);
+    uint8_t * const out = stream.data() + start;
+    *out = tag;
+    return writeUnsigned(count, out + 1);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicCompactMeshSink<IndexType>::finishChunk(uint8_t const * end) {
+    stream.resize(size_t(end - stream.data()));
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+bool decodeCompactMesh(
+    uint8_t const * stream,
+    size_t const size,
+    std::vector<Vertex> & vertices,
+    std::vector<BasicQuad<IndexType>> & quads
+    ) {
+    uint8_t const * position = stream;
+    uint8_t const * const end = stream + size;
+    if(size < 6 || position[0] != 'D' || position[1] != 'M' || position[2] != 'C' || position[3] != 'Q' || position[4] != 1)
+        return false;
+    int const offsetBits = position[5];
+    if(offsetBits != 8 && offsetBits != 16)
+        return false;
+    position += 6;
+    int const numOffsetBytes = offsetBits / 8;
+    double const offsetScale = 1.0 / double((1u << offsetBits) - 1);
+
+    // indices refer to vertices of the stream, which may follow the ones
+    // already in the vertex list
+    int64_t const firstVertex = int64_t(vertices.size());
+    CompactMeshState state;
+    while(position != end) {
+        uint8_t const tag = *position++;
+        uint64_t count;
+        if(!compact::readUnsigned(position, end, count))
+            return false;
+        if(tag == 'V') {
+            // every vertex needs at least one byte for the cell and the offsets
+            if(count > uint64_t(end - position) / uint64_t(1 + 3 * numOffsetBytes))
+                return false;
+            vertices.reserve(vertices.size() + size_t(count));
+            for(uint64_t i = 0; i < count; ++i) {
+                uint64_t code;
+                if(!compact::readUnsigned(position, end, code))
+                    return false;
+                uint64_t const mode = code & 3;
+                if(mode == 3)
+                    return false;
+                state.cell[0] += compact::unzigzag(code >> 2);
+                for(uint64_t a = 1; a <= mode; ++a) {
+                    uint64_t difference;
+                    if(!compact::readUnsigned(position, end, difference))
+                        return false;
+                    state.cell[a] += compact::unzigzag(difference);
+                }
+                if(end - position < 3 * numOffsetBytes)
+                    return false;
+                VertexComponentsType coordinates[3];
+                for(int a = 0; a < 3; ++a) {
+                    uint32_t offset = 0;
+                    for(int b = 0; b < numOffsetBytes; ++b) {
+                        offset |= uint32_t(*position++) << (8 * b);
+                    }
+                    coordinates[a] = VertexComponentsType(double(state.cell[a]) + double(offset) * offsetScale);
+                }
+                vertices.emplace_back(coordinates[0], coordinates[1], coordinates[2]);
+            }
+            state.numVertices += int64_t(count);
+        } else if(tag == 'Q') {
+            // every quad needs at least one byte per index
+            if(count > uint64_t(end - position) / 4)
+                return false;
+            quads.reserve(quads.size() + size_t(count));
+            for(uint64_t i = 0; i < count; ++i) {
+                int64_t indices[4];
+                for(int c = 0; c < 4; ++c) {
+                    uint64_t code;
+                    if(!compact::readUnsigned(position, end, code))
+                        return false;
+                    indices[c] = state.getPrediction(int(code & 7)) + compact::unzigzag(code >> 3);
+                    // quads only reference vertices, which were passed before
+                    if(indices[c] < 0 || indices[c] >= state.numVertices)
+                        return false;
+                    if(firstVertex + indices[c] > int64_t(std::numeric_limits<IndexType>::max()))
+                        return false;
+                }
+                quads.emplace_back(IndexType(firstVertex + indices[0]), IndexType(firstVertex + indices[1]),
+                  IndexType(firstVertex + indices[2]), IndexType(firstVertex + indices[3]));
+                state.addQuad(indices);
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_COMPACT_H_INCLUDED
@@ -0,0 +1,130 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_EXECUTOR_H_INCLUDED
+#define DUALMC_EXECUTOR_H_INCLUDED
+
+/// \file   dualmc_executor.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace dualmc {
+
+/// \class  SerialExecutor
+/// Executor, which runs all tasks one after another on the calling thread.
+class SerialExecutor {
+public:
+    /// Get the number of tasks processed concurrently, which is one.
+    unsigned int concurrency() const;
+
+    /// Run the tasks 0,...,numTasks-1 in order.
+    template<class TaskFunction>
+    void run(int32_t const numTasks, TaskFunction const & task) const;
+};
+
+/// \class  ThreadExecutor
+/// Simple executor for the parallel build functions of DualMC, which runs
+/// tasks on a set of threads that only lives for the duration of a run call.
+///
+/// Any other type can be used as executor as long as it provides the same two
+/// functions. This allows to run the extraction on an existing thread pool
+/// by wrapping it in a small adapter class:
+///  - unsigned int concurrency() const
+///    returns the number of tasks that are processed concurrently.
+///  - template<class TaskFunction> void run(int32_t numTasks, TaskFunction const & task)
+///    calls task(i) for all i in [0,numTasks) and returns when all calls
+///    have finished. Calls may be executed concurrently and in any order.
+class ThreadExecutor {
+public:
+    /// Initializing constructor. A thread count of 0 selects the number of
+    /// concurrent threads supported by the hardware.
+    explicit ThreadExecutor(unsigned int const numThreads = 0);
+
+    /// Get the number of threads which process tasks concurrently.
+    unsigned int concurrency() const;
+
+    /// Run the tasks 0,...,numTasks-1 and return after all of them finished.
+    /// The calling thread participates in the task processing.
+    template<class TaskFunction>
+    void run(int32_t const numTasks, TaskFunction const & task) const;
+
+private:
+    /// number of threads including the calling thread
+    unsigned int numThreads;
+};
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+inline
+unsigned int SerialExecutor::concurrency() const {
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+
+template<class TaskFunction> inline
+void SerialExecutor::run(int32_t const numTasks, TaskFunction const & task) const {
+    for(int32_t t = 0; t < numTasks; ++t) {
+        task(t);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+ThreadExecutor::ThreadExecutor(unsigned int const numThreads) : numThreads(numThreads) {
+    if(this->numThreads == 0) {
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+unsigned int ThreadExecutor::concurrency() const {
+    return numThreads;
+}
+
+//------------------------------------------------------------------------------
+
+template<class TaskFunction> inline
+void ThreadExecutor::run(int32_t const numTasks, TaskFunction const & task) const {
+    if(numTasks <= 0)
+        return;
+
+    // tasks are fetched from a shared counter until all are taken
+    std::atomic<int32_t> nextTask(0);
+    auto const worker = [&]() {
+        for(int32_t t = nextTask++; t < numTasks; t = nextTask++) {
+            task(t);
+        }
+    };
+
+    // no need for more threads than tasks
+    unsigned int const numWorkers = std::min(numThreads, static_cast<unsigned int>(numTasks));
+    std::vector<std::thread> threads;
+    threads.reserve(numWorkers - 1);
+    for(unsigned int i = 1; i < numWorkers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(auto & thread : threads) {
+        thread.join();
+    }
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_EXECUTOR_H_INCLUDED
@@ -0,0 +1,933 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_GPU_H_INCLUDED
+#define DUALMC_GPU_H_INCLUDED
+
+/// \file   dualmc_gpu.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <new>
+#include <vector>
+
+// dual mc builder, whose lookup tables are shared
+#include "dualmc.h"
+
+#ifdef __CUDACC__
+#include <cuda_runtime.h>
+#include <thrust/device_ptr.h>
+#include <thrust/scan.h>
+/// functions called by the per cell kernels on the device and the host
+#define DUALMC_GPU_FUNCTION __host__ __device__ inline
+#else
+#define DUALMC_GPU_FUNCTION inline
+#endif
+
+namespace dualmc {
+
+namespace gpu {
+
+/// Lookup tables used by the per cell kernels. The dual marching cubes
+/// tables are copied from DualMC, so both builders generate the same mesh.
+struct Tables {
+    /// copy of DualMC::dualPointsList
+    int32_t dualPointsList[256][4];
+    /// copy of DualMC::problematicConfigs
+    uint8_t problematicConfigs[256];
+    /// offset of the first voxel of each cell edge from the cell origin
+    uint8_t edgeVoxels[12][3];
+    /// axis of each cell edge
+    uint8_t edgeAxes[12];
+};
+
+/// Volume, iso value, and cell grid of an extraction. Passed by value to the
+/// per cell kernels.
+template<class T> struct Grid {
+    /// volume data in device memory
+    T const * data;
+    /// volume extent
+    int32_t dims[3];
+    /// iso value
+    T iso;
+    /// number of cells
+    size_t numCells;
+    /// lookup tables in device memory
+    Tables const * tables;
+
+    /// Get the coordinates of a cell.
+    DUALMC_GPU_FUNCTION void getCellCoords(size_t const cell, int32_t & cx, int32_t & cy, int32_t & cz) const;
+
+    /// Get the index of a cell.
+    DUALMC_GPU_FUNCTION size_t getCellIndex(int32_t const cx, int32_t const cy, int32_t const cz) const;
+
+    /// Get the value of a voxel.
+    DUALMC_GPU_FUNCTION T getVoxel(int32_t const x, int32_t const y, int32_t const z) const;
+
+    /// Check whether the cell edge starting at the voxel (x,y,z) along the
+    /// given axis produces a quad, if it is crossed. These are the edges
+    /// visited by DualMC::build.
+    DUALMC_GPU_FUNCTION bool isQuadEdge(int32_t const x, int32_t const y, int32_t const z, int const axis) const;
+
+    /// Get the index of the dual point in the dualPointsList entry of the
+    /// given cube code, which belongs to the given edge.
+    DUALMC_GPU_FUNCTION int getDualPointSlot(int const cubeCode, int const edge) const;
+
+    /// Compute the dual point of a dual point code like DualMC does.
+    DUALMC_GPU_FUNCTION void calculateDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
+      int const pointCode, Vertex * v) const;
+};
+
+/// Per cell kernel computing the 8-bit in-out masks of the cell corners.
+template<class T> struct ClassifyCells {
+    Grid<T> grid;
+    uint8_t * cellCodes;
+    DUALMC_GPU_FUNCTION void operator()(size_t const cell) const;
+};
+
+/// Per cell kernel computing the cube codes used for looking up dual points.
+/// This is where the manifold dual marching cubes algorithm is implemented.
+template<class T> struct ResolveCells {
+    Grid<T> grid;
+    uint8_t const * cellCodes;
+    uint8_t * resolvedCodes;
+    DUALMC_GPU_FUNCTION void operator()(size_t const cell) const;
+};
+
+/// Per cell kernel counting the quads of the edges starting at the cell
+/// origin and the dual points of the cell, which are referenced by quads.
+/// For quad soups the dual points are not counted.
+template<class T> struct CountCells {
+    Grid<T> grid;
+    bool generateSoup;
+    uint8_t const * cellCodes;
+    uint8_t const * resolvedCodes;
+    uint8_t * dualPointMasks;
+    uint32_t * quadCounts;
+    uint32_t * vertexCounts;
+    DUALMC_GPU_FUNCTION void operator()(size_t const cell) const;
+};
+
+/// Per cell kernel writing the referenced dual points of a cell in slot order.
+template<class T> struct EmitVertices {
+    Grid<T> grid;
+    uint8_t const * resolvedCodes;
+    uint8_t const * dualPointMasks;
+    uint32_t const * vertexOffsets;
+    Vertex * vertices;
+    DUALMC_GPU_FUNCTION void operator()(size_t const cell) const;
+};
+
+/// Per cell kernel writing the quads of the edges starting at the cell
+/// origin. Quad soups also write the four vertices of each quad.
+template<class T, class IndexType> struct EmitQuads {
+    Grid<T> grid;
+    bool generateSoup;
+    uint8_t const * cellCodes;
+    uint8_t const * resolvedCodes;
+    uint8_t const * dualPointMasks;
+    uint32_t const * quadOffsets;
+    uint32_t const * vertexOffsets;
+    Vertex * vertices;
+    BasicQuad<IndexType> * quads;
+    DUALMC_GPU_FUNCTION void operator()(size_t const cell) const;
+
+    /// Get the vertex index of a shared dual point.
+    DUALMC_GPU_FUNCTION IndexType getDualPointIndex(int32_t const cx, int32_t const cy, int32_t const cz, int const edge) const;
+
+    /// Write a quad with either the given or the reversed orientation.
+    DUALMC_GPU_FUNCTION void emitQuad(uint32_t const quad, int32_t const x, int32_t const y, int32_t const z,
+      int32_t const (&cells)[4][3], int const (&edges)[4], bool const reverse) const;
+};
+
+} // END: namespace gpu
+
+/// \class  DeviceBuffer
+/// Array in device memory. Without CUDA, device memory is host memory.
+template<class E> class DeviceBuffer {
+public:
+    /// Create an empty buffer.
+    DeviceBuffer();
+
+    /// Free the buffer.
+    ~DeviceBuffer();
+
+    /// Resize the buffer. The contents are undefined afterwards.
+    /// Returns false if the allocation failed.
+    bool resize(size_t const numElements);
+
+    /// Resize the buffer and copy elements from host memory.
+    bool upload(E const * elements, size_t const numElements);
+
+    /// Copy the first numElements elements to host memory.
+    bool download(E * elements, size_t const numElements) const;
+
+    /// Get the elements in device memory.
+    E * data();
+
+    /// Get the elements in device memory.
+    E const * data() const;
+
+    /// Get the number of elements.
+    size_t size() const;
+
+private:
+    // buffers are not copyable
+    DeviceBuffer(DeviceBuffer const &);
+    DeviceBuffer & operator=(DeviceBuffer const &);
+
+    /// Free the allocated memory.
+    void release();
+
+    /// allocated elements
+    E * elements;
+    /// number of elements
+    size_t numElements;
+    /// number of allocated elements
+    size_t capacity;
+};
+
+/// \class  DualMCGPU
+/// Data-parallel version of the dual marching cubes builder for GPUs.
+/// In contrast to DualMC, the cells are processed independently: cells are
+/// classified, the quads and referenced dual points of each cell are counted
+/// and prefix summed, and the vertices and quads are written to their final
+/// positions in device buffers. The volume and the mesh can stay resident on
+/// the GPU.
+///
+/// If compiled with CUDA, each phase is a kernel launch and the prefix sums
+/// use Thrust. Otherwise, the same kernels run serially on the host, which
+/// allows to validate the backend without a GPU.
+///
+/// The builder uses the lookup tables of DualMC and generates the same
+/// quads in the same order with the same vertex positions. Quad soups are
+/// identical. With shared vertices, vertices are ordered by cell instead of
+/// by their first use, so vertex indices differ from DualMC. CUDA builds
+/// contract floating point operations by default, so vertex positions only
+/// match bitwise if compiled with -fmad=false.
+/// Counts and offsets are 32-bit, so meshes are limited to 2^32 quads,
+/// quad soup vertices, and shared vertices.
+template<class T, class IndexType = QuadIndexType> class DualMCGPU {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+    typedef IndexType QuadIndexType;
+    typedef BasicQuad<IndexType> Quad;
+
+    /// Default constructor.
+    DualMCGPU();
+
+    /// Extracts the iso surface for a volume in device memory. The mesh is
+    /// kept in device memory, see getVertices and getQuads.
+    /// Returns false if a device allocation or operation failed.
+    bool buildDevice(
+        VolumeDataType const * deviceData,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup
+        );
+
+    /// Version of buildDevice for a volume in host memory. The volume is
+    /// uploaded and the mesh downloaded to the given vectors.
+    bool build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads
+        );
+
+    /// Get the vertices of the last extraction in device memory.
+    Vertex const * getVertices() const;
+
+    /// Get the number of vertices of the last extraction.
+    size_t getNumVertices() const;
+
+    /// Get the quads of the last extraction in device memory.
+    Quad const * getQuads() const;
+
+    /// Get the number of quads of the last extraction.
+    size_t getNumQuads() const;
+
+private:
+    /// Upload the lookup tables, if not done already.
+    bool uploadTables();
+
+    /// Run a per cell kernel for all cells.
+    template<class Kernel>
+    static bool forEachCell(size_t const numCells, Kernel const & kernel);
+
+    /// Replace counts by their exclusive prefix sum and compute their total.
+    static bool scan(uint32_t * counts, size_t const numCounts, size_t & total);
+
+    /// lookup tables
+    DeviceBuffer<gpu::Tables> tables;
+    /// uploaded volume of build
+    DeviceBuffer<VolumeDataType> volume;
+    /// cube codes of all cells
+    DeviceBuffer<uint8_t> cellCodes;
+    /// cube codes used for looking up dual points
+    DeviceBuffer<uint8_t> resolvedCodes;
+    /// referenced dual point slots of each cell
+    DeviceBuffer<uint8_t> dualPointMasks;
+    /// quad counts and then offsets of each cell
+    DeviceBuffer<uint32_t> quadOffsets;
+    /// shared vertex counts and then offsets of each cell
+    DeviceBuffer<uint32_t> vertexOffsets;
+    /// extracted vertices
+    DeviceBuffer<Vertex> vertices;
+    /// extracted quads
+    DeviceBuffer<Quad> quads;
+    /// number of extracted vertices
+    size_t numVertices;
+    /// number of extracted quads
+    size_t numQuads;
+};
+
+// inline function definitions
+
+namespace gpu {
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void Grid<T>::getCellCoords(size_t const cell, int32_t & cx, int32_t & cy, int32_t & cz) const {
+    size_t const cellsX = size_t(dims[0] - 1);
+    size_t const cellsY = size_t(dims[1] - 1);
+    cx = int32_t(cell % cellsX);
+    cy = int32_t((cell / cellsX) % cellsY);
+    cz = int32_t(cell / (cellsX * cellsY));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+size_t Grid<T>::getCellIndex(int32_t const cx, int32_t const cy, int32_t const cz) const {
+    return size_t(cx) + size_t(dims[0] - 1) * (size_t(cy) + size_t(dims[1] - 1) * size_t(cz));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+T Grid<T>::getVoxel(int32_t const x, int32_t const y, int32_t const z) const {
+    return data[size_t(x) + size_t(dims[0]) * (size_t(y) + size_t(dims[1]) * size_t(z))];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+bool Grid<T>::isQuadEdge(int32_t const x, int32_t const y, int32_t const z, int const axis) const {
+    // DualMC visits the edges starting at the voxels [0,dims-2) and skips
+    // edges on the lower boundary, which have less than four cells
+    if(x >= dims[0] - 2 || y >= dims[1] - 2 || z >= dims[2] - 2)
+        return false;
+    if(axis == 0)
+        return y > 0 && z > 0;
+    if(axis == 1)
+        return x > 0 && z > 0;
+    return x > 0 && y > 0;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+int Grid<T>::getDualPointSlot(int const cubeCode, int const edge) const {
+    for(int i = 0; i < 4; ++i)
+        if(tables->dualPointsList[cubeCode][i] & edge) {
+            return i;
+        }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void Grid<T>::calculateDualPoint(int32_t const cx, int32_t const cy, int32_t const cz,
+  int const pointCode, Vertex * v) const {
+    // Sum the edge intersection vertices in edge order. Edges add 1 to the
+    // components, in which their first voxel is offset from the cell origin.
+    // Adding 0 to the other components does not change the sums, so the
+    // result is the same as in DualMC::calculateDualPoint.
+    float p[3] = {0, 0, 0};
+    int points = 0;
+    for(int edge = 0; edge < 12; ++edge) {
+        if((pointCode & (1 << edge)) == 0)
+            continue;
+        uint8_t const * const voxel = tables->edgeVoxels[edge];
+        int const axis = tables->edgeAxes[edge];
+        int32_t const x = cx + voxel[0];
+        int32_t const y = cy + voxel[1];
+        int32_t const z = cz + voxel[2];
+        float const v0 = (float)getVoxel(x, y, z);
+        float const v1 = (float)getVoxel(x + (axis == 0), y + (axis == 1), z + (axis == 2));
+        float const t = ((float)iso - v0)/(v1 - v0);
+        for(int c = 0; c < 3; ++c) {
+            p[c] += c == axis ? t : (float)voxel[c];
+        }
+        points++;
+    }
+
+    // divide by number of accumulated points
+    float invPoints = 1.0f / (float)points;
+    p[0]*= invPoints;
+    p[1]*= invPoints;
+    p[2]*= invPoints;
+
+    // offset point by voxel coordinates
+    v->x = (float)cx;
+    v->y = (float)cy;
+    v->z = (float)cz;
+    v->x += p[0];
+    v->y += p[1];
+    v->z += p[2];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void ClassifyCells<T>::operator()(size_t const cell) const {
+    int32_t cx, cy, cz;
+    grid.getCellCoords(cell, cx, cy, cz);
+    // corner i is at the offset (i&1,(i>>1)&1,i>>2) from the cell origin
+    int code = 0;
+    for(int i = 0; i < 8; ++i) {
+        if(grid.getVoxel(cx + (i & 1), cy + ((i >> 1) & 1), cz + (i >> 2)) >= grid.iso) {
+            code |= 1 << i;
+        }
+    }
+    cellCodes[cell] = uint8_t(code);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void ResolveCells<T>::operator()(size_t const cell) const {
+    // Like DualMC::resolveCellCodeLayer, the cube code of problematic C16
+    // and C19 configurations sharing their ambiguous face with another
+    // problematic configuration is inverted.
+    int cubeCode = cellCodes[cell];
+    uint8_t const direction = grid.tables->problematicConfigs[cubeCode];
+    if(direction != 255) {
+        int32_t neighborCoords[3];
+        grid.getCellCoords(cell, neighborCoords[0], neighborCoords[1], neighborCoords[2]);
+        unsigned int const component = direction >> 1;
+        neighborCoords[component] += (direction & 1) == 1 ? 1 : -1;
+        if(neighborCoords[component] >= 0 && neighborCoords[component] < grid.dims[component] - 1) {
+            int const neighborCubeCode = cellCodes[grid.getCellIndex(neighborCoords[0], neighborCoords[1], neighborCoords[2])];
+            if(grid.tables->problematicConfigs[neighborCubeCode] != 255) {
+                cubeCode ^= 0xff;
+            }
+        }
+    }
+    resolvedCodes[cell] = uint8_t(cubeCode);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void CountCells<T>::operator()(size_t const cell) const {
+    int32_t cx, cy, cz;
+    grid.getCellCoords(cell, cx, cy, cz);
+
+    // count the crossed edges starting at the cell origin, which produce quads
+    int const cellCode = cellCodes[cell];
+    uint32_t numQuads = 0;
+    if(grid.isQuadEdge(cx, cy, cz, 0) && ((cellCode & 3) == 1 || (cellCode & 3) == 2))
+        ++numQuads;
+    if(grid.isQuadEdge(cx, cy, cz, 1) && ((cellCode & 5) == 1 || (cellCode & 5) == 4))
+        ++numQuads;
+    if(grid.isQuadEdge(cx, cy, cz, 2) && ((cellCode & 17) == 1 || (cellCode & 17) == 16))
+        ++numQuads;
+    quadCounts[cell] = numQuads;
+    if(generateSoup)
+        return;
+
+    // A dual point is referenced by the quads of its edges. All of them are
+    // crossed, so it is used if one of them produces a quad.
+    int const cubeCode = resolvedCodes[cell];
+    int mask = 0;
+    uint32_t numDualPoints = 0;
+    for(int slot = 0; slot < 4; ++slot) {
+        int const pointCode = grid.tables->dualPointsList[cubeCode][slot];
+        for(int edge = 0; edge < 12; ++edge) {
+            if((pointCode & (1 << edge)) == 0)
+                continue;
+            uint8_t const * const voxel = grid.tables->edgeVoxels[edge];
+            if(grid.isQuadEdge(cx + voxel[0], cy + voxel[1], cz + voxel[2], grid.tables->edgeAxes[edge])) {
+                mask |= 1 << slot;
+                ++numDualPoints;
+                break;
+            }
+        }
+    }
+    dualPointMasks[cell] = uint8_t(mask);
+    vertexCounts[cell] = numDualPoints;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> DUALMC_GPU_FUNCTION
+void EmitVertices<T>::operator()(size_t const cell) const {
+    int const mask = dualPointMasks[cell];
+    if(mask == 0)
+        return;
+    int32_t cx, cy, cz;
+    grid.getCellCoords(cell, cx, cy, cz);
+    int const cubeCode = resolvedCodes[cell];
+    Vertex * v = vertices + vertexOffsets[cell];
+    for(int slot = 0; slot < 4; ++slot) {
+        if(mask & (1 << slot)) {
+            grid.calculateDualPoint(cx, cy, cz, grid.tables->dualPointsList[cubeCode][slot], v++);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> DUALMC_GPU_FUNCTION
+IndexType EmitQuads<T,IndexType>::getDualPointIndex(int32_t const cx, int32_t const cy, int32_t const cz, int const edge) const {
+    // the dual points of a cell are stored in slot order
+    size_t const cell = grid.getCellIndex(cx, cy, cz);
+    int const slot = grid.getDualPointSlot(resolvedCodes[cell], edge);
+    int const lowerSlots = dualPointMasks[cell] & ((1 << slot) - 1);
+    uint32_t index = vertexOffsets[cell];
+    for(int i = 0; i < slot; ++i) {
+        index += (lowerSlots >> i) & 1;
+    }
+    return IndexType(index);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> DUALMC_GPU_FUNCTION
+void EmitQuads<T,IndexType>::emitQuad(uint32_t const quad, int32_t const x, int32_t const y, int32_t const z,
+  int32_t const (&cells)[4][3], int const (&edges)[4], bool const reverse) const {
+    // vertex order of the quad, the reversed order is i0,i3,i2,i1
+    int const order[4] = {0, reverse ? 3 : 1, 2, reverse ? 1 : 3};
+    BasicQuad<IndexType> & q = quads[quad];
+    if(generateSoup) {
+        Vertex * const v = vertices + size_t(quad) * 4;
+        for(int i = 0; i < 4; ++i) {
+            int32_t const * const c = cells[order[i]];
+            size_t const cell = grid.getCellIndex(x + c[0], y + c[1], z + c[2]);
+            int const cubeCode = resolvedCodes[cell];
+            int const pointCode = grid.tables->dualPointsList[cubeCode][grid.getDualPointSlot(cubeCode, edges[order[i]])];
+            grid.calculateDualPoint(x + c[0], y + c[1], z + c[2], pointCode, v + i);
+        }
+        IndexType const first = IndexType(size_t(quad) * 4);
+        q.i0 = first;
+        q.i1 = first + 1;
+        q.i2 = first + 2;
+        q.i3 = first + 3;
+        return;
+    }
+    IndexType indices[4];
+    for(int i = 0; i < 4; ++i) {
+        int32_t const * const c = cells[order[i]];
+        indices[i] = getDualPointIndex(x + c[0], y + c[1], z + c[2], edges[order[i]]);
+    }
+    q.i0 = indices[0];
+    q.i1 = indices[1];
+    q.i2 = indices[2];
+    q.i3 = indices[3];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> DUALMC_GPU_FUNCTION
+void EmitQuads<T,IndexType>::operator()(size_t const cell) const {
+    int32_t x, y, z;
+    grid.getCellCoords(cell, x, y, z);
+    int const cellCode = cellCodes[cell];
+    uint32_t quad = quadOffsets[cell];
+
+    // The four cells around each edge and the edges referencing it, in the
+    // order of DualMC::buildSharedVerticesQuadsLayer.
+    if(grid.isQuadEdge(x, y, z, 0)) {
+        bool const entering = (cellCode & 3) == 2;
+        bool const exiting  = (cellCode & 3) == 1;
+        if(entering || exiting) {
+            int32_t const cells[4][3] = {{0,0,0},{0,0,-1},{0,-1,-1},{0,-1,0}};
+            int const edges[4] = {1 << 0, 1 << 2, 1 << 6, 1 << 4};
+            emitQuad(quad++, x, y, z, cells, edges, !entering);
+        }
+    }
+    if(grid.isQuadEdge(x, y, z, 1)) {
+        bool const entering = (cellCode & 5) == 4;
+        bool const exiting  = (cellCode & 5) == 1;
+        if(entering || exiting) {
+            int32_t const cells[4][3] = {{0,0,0},{0,0,-1},{-1,0,-1},{-1,0,0}};
+            int const edges[4] = {1 << 8, 1 << 11, 1 << 10, 1 << 9};
+            emitQuad(quad++, x, y, z, cells, edges, !exiting);
+        }
+    }
+    if(grid.isQuadEdge(x, y, z, 2)) {
+        bool const entering = (cellCode & 17) == 16;
+        bool const exiting  = (cellCode & 17) == 1;
+        if(entering || exiting) {
+            int32_t const cells[4][3] = {{0,0,0},{-1,0,0},{-1,-1,0},{0,-1,0}};
+            int const edges[4] = {1 << 3, 1 << 1, 1 << 5, 1 << 7};
+            emitQuad(quad++, x, y, z, cells, edges, !exiting);
+        }
+    }
+}
+
+#ifdef __CUDACC__
+//------------------------------------------------------------------------------
+
+/// Run a per cell kernel with a grid-stride loop.
+template<class Kernel> __global__
+void forEachCellKernel(size_t const numCells, Kernel const kernel) {
+    size_t const stride = size_t(blockDim.x) * gridDim.x;
+    for(size_t cell = size_t(blockIdx.x) * blockDim.x + threadIdx.x; cell < numCells; cell += stride) {
+        kernel(cell);
+    }
+}
+#endif
+
+} // END: namespace gpu
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+DeviceBuffer<E>::DeviceBuffer() : elements(nullptr), numElements(0), capacity(0) {}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+DeviceBuffer<E>::~DeviceBuffer() {
+    release();
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+bool DeviceBuffer<E>::resize(size_t const numElements) {
+    if(numElements > capacity) {
+        release();
+#ifdef __CUDACC__
+        if(cudaMalloc(reinterpret_cast<void**>(&elements), numElements * sizeof(E)) != cudaSuccess) {
+            elements = nullptr;
+            return false;
+        }
+#else
+        elements = new(std::nothrow) E[numElements];
+        if(!elements)
+            return false;
+#endif
+        capacity = numElements;
+    }
+    this->numElements = numElements;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+bool DeviceBuffer<E>::upload(E const * elements, size_t const numElements) {
+    if(!resize(numElements))
+        return false;
+#ifdef __CUDACC__
+    return numElements == 0 ||
+        cudaMemcpy(this->elements, elements, numElements * sizeof(E), cudaMemcpyHostToDevice) == cudaSuccess;
+#else
+    std::copy(elements, elements + numElements, this->elements);
+    return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+bool DeviceBuffer<E>::download(E * elements, size_t const numElements) const {
+    if(numElements > this->numElements)
+        return false;
+#ifdef __CUDACC__
+    return numElements == 0 ||
+        cudaMemcpy(elements, this->elements, numElements * sizeof(E), cudaMemcpyDeviceToHost) == cudaSuccess;
+#else
+    std::copy(this->elements, this->elements + numElements, elements);
+    return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+E * DeviceBuffer<E>::data() {
+    return elements;
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+E const * DeviceBuffer<E>::data() const {
+    return elements;
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+size_t DeviceBuffer<E>::size() const {
+    return numElements;
+}
+
+//------------------------------------------------------------------------------
+
+template<class E> inline
+void DeviceBuffer<E>::release() {
+    if(elements) {
+#ifdef __CUDACC__
+        cudaFree(elements);
+#else
+        delete[] elements;
+#endif
+    }
+    elements = nullptr;
+    numElements = 0;
+    capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+DualMCGPU<T,IndexType>::DualMCGPU() : numVertices(0), numQuads(0) {}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+bool DualMCGPU<T,IndexType>::uploadTables() {
+    if(tables.size() == 1)
+        return true;
+
+    gpu::Tables hostTables;
+    std::copy(&DualMC<T,IndexType>::dualPointsList[0][0], &DualMC<T,IndexType>::dualPointsList[0][0] + 256 * 4,
+        &hostTables.dualPointsList[0][0]);
+    std::copy(DualMC<T,IndexType>::problematicConfigs, DualMC<T,IndexType>::problematicConfigs + 256,
+        hostTables.problematicConfigs);
+
+    // first voxel and axis of the cell edges, see the cell edges figure in
+    // dualmc_tables.tpp
+    std::copy(&DualMC<T,IndexType>::edgeVoxels[0][0], &DualMC<T,IndexType>::edgeVoxels[0][0] + 12 * 3,
+        &hostTables.edgeVoxels[0][0]);
+    std::copy(DualMC<T,IndexType>::edgeAxes, DualMC<T,IndexType>::edgeAxes + 12, hostTables.edgeAxes);
+
+    return tables.upload(&hostTables, 1);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> template<class Kernel> inline
+bool DualMCGPU<T,IndexType>::forEachCell(size_t const numCells, Kernel const & kernel) {
+#ifdef __CUDACC__
+    if(numCells == 0)
+        return true;
+    unsigned int const blockSize = 256;
+    size_t const numBlocks = std::min<size_t>((numCells + blockSize - 1) / blockSize, 1 << 16);
+    gpu::forEachCellKernel<<<(unsigned int)numBlocks, blockSize>>>(numCells, kernel);
+    return cudaGetLastError() == cudaSuccess;
+#else
+    for(size_t cell = 0; cell < numCells; ++cell) {
+        kernel(cell);
+    }
+    return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+bool DualMCGPU<T,IndexType>::scan(uint32_t * counts, size_t const numCounts, size_t & total) {
+    total = 0;
+    if(numCounts == 0)
+        return true;
+#ifdef __CUDACC__
+    uint32_t lastCount;
+    uint32_t lastOffset;
+    if(cudaMemcpy(&lastCount, counts + numCounts - 1, sizeof(uint32_t), cudaMemcpyDeviceToHost) != cudaSuccess)
+        return false;
+    thrust::device_ptr<uint32_t> const begin(counts);
+    thrust::exclusive_scan(begin, begin + numCounts, begin);
+    if(cudaMemcpy(&lastOffset, counts + numCounts - 1, sizeof(uint32_t), cudaMemcpyDeviceToHost) != cudaSuccess)
+        return false;
+    total = size_t(lastOffset) + lastCount;
+    return total <= UINT32_MAX;
+#else
+    for(size_t i = 0; i < numCounts; ++i) {
+        uint32_t const count = counts[i];
+        counts[i] = uint32_t(total);
+        total += count;
+    }
+    return total <= UINT32_MAX;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+bool DualMCGPU<T,IndexType>::buildDevice(
+    VolumeDataType const * deviceData,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup
+    ) {
+    numVertices = 0;
+    numQuads = 0;
+    if(!uploadTables())
+        return false;
+    // volumes without cell edges do not produce quads
+    if(dimX < 3 || dimY < 3 || dimZ < 3)
+        return true;
+
+    gpu::Grid<T> grid;
+    grid.data = deviceData;
+    grid.dims[0] = dimX;
+    grid.dims[1] = dimY;
+    grid.dims[2] = dimZ;
+    grid.iso = iso;
+    grid.numCells = size_t(dimX - 1) * size_t(dimY - 1) * size_t(dimZ - 1);
+    grid.tables = tables.data();
+    size_t const numCells = grid.numCells;
+
+    if(!cellCodes.resize(numCells) || !quadOffsets.resize(numCells))
+        return false;
+    if(generateManifold && !resolvedCodes.resize(numCells))
+        return false;
+    if(!generateSoup && (!dualPointMasks.resize(numCells) || !vertexOffsets.resize(numCells)))
+        return false;
+
+    // classify the cells and resolve the cube codes of the dual points
+    gpu::ClassifyCells<T> classify;
+    classify.grid = grid;
+    classify.cellCodes = cellCodes.data();
+    if(!forEachCell(numCells, classify))
+        return false;
+    uint8_t const * dualPointsCellCodes = cellCodes.data();
+    if(generateManifold) {
+        gpu::ResolveCells<T> resolve;
+        resolve.grid = grid;
+        resolve.cellCodes = cellCodes.data();
+        resolve.resolvedCodes = resolvedCodes.data();
+        if(!forEachCell(numCells, resolve))
+            return false;
+        dualPointsCellCodes = resolvedCodes.data();
+    }
+
+    // count quads and referenced dual points and compute their offsets
+    gpu::CountCells<T> count;
+    count.grid = grid;
+    count.generateSoup = generateSoup;
+    count.cellCodes = cellCodes.data();
+    count.resolvedCodes = dualPointsCellCodes;
+    count.dualPointMasks = dualPointMasks.data();
+    count.quadCounts = quadOffsets.data();
+    count.vertexCounts = vertexOffsets.data();
+    if(!forEachCell(numCells, count))
+        return false;
+    if(!scan(quadOffsets.data(), numCells, numQuads))
+        return false;
+    if(generateSoup) {
+        numVertices = numQuads * 4;
+    } else if(!scan(vertexOffsets.data(), numCells, numVertices)) {
+        return false;
+    }
+    if(numVertices > UINT32_MAX || !vertices.resize(numVertices) || !quads.resize(numQuads))
+        return false;
+
+    // write the vertices and quads to their offsets
+    if(!generateSoup) {
+        gpu::EmitVertices<T> emitVertices;
+        emitVertices.grid = grid;
+        emitVertices.resolvedCodes = dualPointsCellCodes;
+        emitVertices.dualPointMasks = dualPointMasks.data();
+        emitVertices.vertexOffsets = vertexOffsets.data();
+        emitVertices.vertices = vertices.data();
+        if(!forEachCell(numCells, emitVertices))
+            return false;
+    }
+    gpu::EmitQuads<T,IndexType> emitQuads;
+    emitQuads.grid = grid;
+    emitQuads.generateSoup = generateSoup;
+    emitQuads.cellCodes = cellCodes.data();
+    emitQuads.resolvedCodes = dualPointsCellCodes;
+    emitQuads.dualPointMasks = dualPointMasks.data();
+    emitQuads.quadOffsets = quadOffsets.data();
+    emitQuads.vertexOffsets = vertexOffsets.data();
+    emitQuads.vertices = vertices.data();
+    emitQuads.quads = quads.data();
+    if(!forEachCell(numCells, emitQuads))
+        return false;
+#ifdef __CUDACC__
+    return cudaDeviceSynchronize() == cudaSuccess;
+#else
+    return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+bool DualMCGPU<T,IndexType>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+    vertices.clear();
+    quads.clear();
+    size_t const numVoxels = size_t(std::max(dimX, 0)) * size_t(std::max(dimY, 0)) * size_t(std::max(dimZ, 0));
+    if(!volume.upload(data, numVoxels))
+        return false;
+    if(!buildDevice(volume.data(), dimX, dimY, dimZ, iso, generateManifold, generateSoup))
+        return false;
+    vertices.resize(numVertices);
+    quads.resize(numQuads);
+    return this->vertices.download(vertices.data(), numVertices) && this->quads.download(quads.data(), numQuads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+Vertex const * DualMCGPU<T,IndexType>::getVertices() const {
+    return vertices.data();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMCGPU<T,IndexType>::getNumVertices() const {
+    return numVertices;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMCGPU<T,IndexType>::Quad const * DualMCGPU<T,IndexType>::getQuads() const {
+    return quads.data();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMCGPU<T,IndexType>::getNumQuads() const {
+    return numQuads;
+}
+
+} // END: namespace dualmc
+
+#endif // DUALMC_GPU_H_INCLUDED
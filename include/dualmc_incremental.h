@@ -0,0 +1,498 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_INCREMENTAL_H_INCLUDED
+#define DUALMC_INCREMENTAL_H_INCLUDED
+
+/// \file   dualmc_incremental.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <vector>
+
+// dual mc builder, whose kernels are shared
+#include "dualmc.h"
+
+namespace dualmc {
+
+/// \class  DualMCIncremental
+/// Dual marching cubes builder for volumes, which are edited in place, e.g.
+/// by a sculpting tool. The mesh is kept as one sub-mesh per brick of cell
+/// edges. After an edit, only the bricks whose quads can depend on the
+/// modified voxels are re-extracted, so the update time scales with the size
+/// of the edit instead of the size of the volume.
+///
+/// Each brick holds the quads generated by the cell edges starting at the
+/// voxels of the brick. The union of the sub-meshes contains the same quads
+/// with the same vertex positions as the mesh of DualMC::build. With shared
+/// vertices, each sub-mesh has its own vertices, so dual points referenced
+/// by quads of several bricks are duplicated.
+template<class T, class IndexType = QuadIndexType> class DualMCIncremental {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+    typedef IndexType QuadIndexType;
+    typedef BasicQuad<IndexType> Quad;
+
+    /// Mesh of a single brick.
+    struct BrickMesh {
+        std::vector<Vertex> vertices;
+        std::vector<Quad> quads;
+    };
+
+    /// Default constructor.
+    DualMCIncremental();
+
+    /// Set the method for placing dual points. Takes effect with the next
+    /// build.
+    void setDualPointPlacement(DualPointPlacement const placement);
+
+    /// Extracts the iso surface of all bricks of a volume. The volume is
+    /// read again by update, so it has to stay valid until the next build.
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        int32_t const brickSize = 16
+        );
+
+    /// Re-extracts the bricks affected by modified voxels in the box
+    /// [minX,maxX]x[minY,maxY]x[minZ,maxZ] of the volume passed to build.
+    /// The box is clamped to the volume.
+    void update(
+        int32_t const minX, int32_t const minY, int32_t const minZ,
+        int32_t const maxX, int32_t const maxY, int32_t const maxZ
+        );
+
+    /// Get the number of cell edges along each axis of a brick.
+    int32_t getBrickSize() const;
+
+    /// Get the number of bricks along the given axis.
+    int32_t getNumBricks(int const axis) const;
+
+    /// Get the mesh of a brick.
+    BrickMesh const & getBrickMesh(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+    /// Get the linearized indices of the bricks, which were extracted by the
+    /// last build or update, in increasing order. Bricks are linearized in
+    /// x,y,z order.
+    std::vector<size_t> const & getUpdatedBricks() const;
+
+    /// Concatenate the meshes of all bricks.
+    void getMesh(std::vector<Vertex> & vertices, std::vector<Quad> & quads) const;
+
+private:
+    // builder types
+    typedef DualMC<T,IndexType> Builder;
+    typedef typename Builder::DMCEdgeCode DMCEdgeCode;
+
+    /// Compute the cube codes of the cells in [begin,end).
+    void classifyCells(int32_t const (&begin)[3], int32_t const (&end)[3]);
+
+    /// Compute the cube codes used for looking up the dual points of the
+    /// cells in [begin,end).
+    void resolveCells(int32_t const (&begin)[3], int32_t const (&end)[3]);
+
+    /// Extract the mesh of a brick.
+    void extractBrick(int32_t const bx, int32_t const by, int32_t const bz);
+
+    /// Get the index of a dual point in the dual points of the current brick.
+    QuadIndexType getDualPointIndex(int32_t const cx, int32_t const cy, int32_t const cz,
+      DMCEdgeCode const edge, std::vector<Vertex> & points);
+
+    /// Add a quad of dual points to a brick mesh.
+    void addQuad(QuadIndexType const i0, QuadIndexType const i1, QuadIndexType const i2, QuadIndexType const i3,
+      std::vector<Vertex> const & points, BrickMesh & mesh) const;
+
+    /// Compute the index of a cell.
+    size_t getCellIndex(int32_t const cx, int32_t const cy, int32_t const cz) const;
+
+    /// Compute the linearized index of a brick.
+    size_t getBrickIndex(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+private:
+
+    /// builder providing the classification and dual point kernels
+    Builder builder;
+
+    /// iso value of the extraction
+    VolumeDataType iso;
+
+    /// store whether quad soups are generated
+    bool generateSoup;
+
+    /// number of cell edges along each axis of a brick
+    int32_t brickSize;
+
+    /// number of bricks for x-,y-, and z-dimension
+    int32_t numBricks[3];
+
+    /// cube codes of all cells
+    std::vector<uint8_t> cellCodes;
+
+    /// cube codes used for looking up dual points of all cells
+    std::vector<uint8_t> resolvedCodes;
+
+    /// meshes of all bricks
+    std::vector<BrickMesh> brickMeshes;
+
+    /// bricks extracted by the last build or update
+    std::vector<size_t> updatedBricks;
+
+    /// origin of the cells referenced by the current brick
+    int32_t cacheOrigin[3];
+
+    /// dual point indices of the cells referenced by the current brick
+    std::vector<QuadIndexType> pointCache;
+
+    /// dual points of the current quad soup brick
+    std::vector<Vertex> soupPoints;
+};
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+DualMCIncremental<T,IndexType>::DualMCIncremental() :
+    iso(),
+    generateSoup(false),
+    brickSize(1) {
+    for(int i = 0; i < 3; ++i) {
+        numBricks[i] = 0;
+        cacheOrigin[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::setDualPointPlacement(DualPointPlacement const placement) {
+    builder.setDualPointPlacement(placement);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    int32_t const brickSize
+    ) {
+    builder.initialize(data, dimX, dimY, dimZ, generateManifold);
+    this->iso = iso;
+    this->generateSoup = generateSoup;
+    this->brickSize = std::max<int32_t>(1, brickSize);
+
+    // quads are generated by the cell edges starting at the voxels [0,dims-2)
+    for(int i = 0; i < 3; ++i) {
+        numBricks[i] = (std::max(0, builder.dims[i] - 2) + this->brickSize - 1) / this->brickSize;
+    }
+    size_t const numCells = size_t(std::max(0, dimX - 1)) * size_t(std::max(0, dimY - 1)) * size_t(std::max(0, dimZ - 1));
+    cellCodes.assign(numCells, 0);
+    resolvedCodes.assign(numCells, 0);
+    brickMeshes.assign(size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]), BrickMesh());
+    size_t const cacheSize = size_t(this->brickSize + 1);
+    pointCache.assign(cacheSize * cacheSize * cacheSize * 4, QuadIndexType(-1));
+
+    // extract the whole volume as a single edit
+    update(0, 0, 0, dimX - 1, dimY - 1, dimZ - 1);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::update(
+    int32_t const minX, int32_t const minY, int32_t const minZ,
+    int32_t const maxX, int32_t const maxY, int32_t const maxZ
+    ) {
+    updatedBricks.clear();
+    int32_t const minVoxel[3] = {minX, minY, minZ};
+    int32_t const maxVoxel[3] = {maxX, maxY, maxZ};
+
+    // A voxel is a corner of the cells starting at the voxel and the
+    // preceding voxels. Manifold dual marching cubes also looks at the cube
+    // codes of the face neighbors, so the dual point cube codes of one more
+    // cell in each direction can change.
+    int32_t classifyBegin[3], classifyEnd[3];
+    int32_t resolveBegin[3], resolveEnd[3];
+    int32_t brickBegin[3], brickEnd[3];
+    for(int i = 0; i < 3; ++i) {
+        int32_t const numCells = std::max(0, builder.dims[i] - 1);
+        int32_t const lo = std::max(minVoxel[i], 0);
+        int32_t const hi = std::min(maxVoxel[i], builder.dims[i] - 1);
+        if(lo > hi || numBricks[i] == 0)
+            return;
+        classifyBegin[i] = std::max(lo - 1, 0);
+        classifyEnd[i] = std::min(hi + 1, numCells);
+        // The gradients of Hermite dual points change for the voxels next
+        // to modified ones, which moves the dual points of one more cell.
+        int32_t const margin = builder.generateManifold ||
+            builder.dualPointPlacement == DualPointPlacement::Hermite ? 1 : 0;
+        resolveBegin[i] = std::max(classifyBegin[i] - margin, 0);
+        resolveEnd[i] = std::min(classifyEnd[i] + margin, numCells);
+        // the quads of an edge reference the cells starting at the edge's
+        // first voxel and the preceding ones
+        brickBegin[i] = resolveBegin[i] / brickSize;
+        brickEnd[i] = std::min((resolveEnd[i] + brickSize) / brickSize, numBricks[i]);
+    }
+
+    // cached gradients may belong to modified voxels
+    ++builder.gradientGeneration;
+
+    classifyCells(classifyBegin, classifyEnd);
+    resolveCells(resolveBegin, resolveEnd);
+    for(int32_t bz = brickBegin[2]; bz < brickEnd[2]; ++bz) {
+        for(int32_t by = brickBegin[1]; by < brickEnd[1]; ++by) {
+            for(int32_t bx = brickBegin[0]; bx < brickEnd[0]; ++bx) {
+                extractBrick(bx, by, bz);
+                updatedBricks.push_back(getBrickIndex(bx, by, bz));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int32_t DualMCIncremental<T,IndexType>::getBrickSize() const {
+    return brickSize;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int32_t DualMCIncremental<T,IndexType>::getNumBricks(int const axis) const {
+    return numBricks[axis];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMCIncremental<T,IndexType>::BrickMesh const & DualMCIncremental<T,IndexType>::getBrickMesh(
+    int32_t const bx, int32_t const by, int32_t const bz) const {
+    return brickMeshes[getBrickIndex(bx, by, bz)];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+std::vector<size_t> const & DualMCIncremental<T,IndexType>::getUpdatedBricks() const {
+    return updatedBricks;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::getMesh(std::vector<Vertex> & vertices, std::vector<Quad> & quads) const {
+    vertices.clear();
+    quads.clear();
+    for(BrickMesh const & mesh : brickMeshes) {
+        QuadIndexType const offset = QuadIndexType(vertices.size());
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        for(Quad const & quad : mesh.quads) {
+            quads.emplace_back(quad.i0 + offset, quad.i1 + offset, quad.i2 + offset, quad.i3 + offset);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::classifyCells(int32_t const (&begin)[3], int32_t const (&end)[3]) {
+    for(int32_t cz = begin[2]; cz < end[2]; ++cz) {
+        for(int32_t cy = begin[1]; cy < end[1]; ++cy) {
+            builder.classifyCellRow(begin[0], end[0], cy, cz, iso, &cellCodes[getCellIndex(0, cy, cz)]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::resolveCells(int32_t const (&begin)[3], int32_t const (&end)[3]) {
+    int32_t const numCells[3] = {builder.dims[0] - 1, builder.dims[1] - 1, builder.dims[2] - 1};
+    for(int32_t cz = begin[2]; cz < end[2]; ++cz) {
+        for(int32_t cy = begin[1]; cy < end[1]; ++cy) {
+            size_t cellIndex = getCellIndex(begin[0], cy, cz);
+            for(int32_t cx = begin[0]; cx < end[0]; ++cx, ++cellIndex) {
+                int cubeCode = cellCodes[cellIndex];
+                // Like DualMC::resolveCellCodeLayer, the cube code of
+                // problematic C16 and C19 configurations sharing their
+                // ambiguous face with another problematic configuration is
+                // inverted.
+                uint8_t const direction = Builder::problematicConfigs[uint8_t(cubeCode)];
+                if(builder.generateManifold && direction != 255) {
+                    int8_t const * const offset = Builder::problematicNeighborOffsets[direction];
+                    int32_t const neighborCoords[] = {cx + offset[0], cy + offset[1], cz + offset[2]};
+                    unsigned int const component = direction >> 1;
+                    if(neighborCoords[component] >= 0 && neighborCoords[component] < numCells[component]) {
+                        int const neighborCubeCode = cellCodes[getCellIndex(neighborCoords[0], neighborCoords[1], neighborCoords[2])];
+                        if(Builder::problematicConfigs[uint8_t(neighborCubeCode)] != 255) {
+                            cubeCode ^= 0xff;
+                        }
+                    }
+                }
+                resolvedCodes[cellIndex] = uint8_t(cubeCode);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::extractBrick(int32_t const bx, int32_t const by, int32_t const bz) {
+    BrickMesh & mesh = brickMeshes[getBrickIndex(bx, by, bz)];
+    mesh.vertices.clear();
+    mesh.quads.clear();
+    soupPoints.clear();
+    std::vector<Vertex> & points = generateSoup ? soupPoints : mesh.vertices;
+
+    // cell edges starting at the voxels of the brick, which generate quads
+    int32_t const begin[3] = {bx * brickSize, by * brickSize, bz * brickSize};
+    int32_t end[3];
+    for(int i = 0; i < 3; ++i) {
+        end[i] = std::min(begin[i] + brickSize, builder.dims[i] - 2);
+        cacheOrigin[i] = begin[i] - 1;
+    }
+
+    QuadIndexType i0,i1,i2,i3;
+
+    // the quads are generated in the same way as in DualMC
+    for(int32_t z = begin[2]; z < end[2]; ++z) {
+        for(int32_t y = begin[1]; y < end[1]; ++y) {
+            uint8_t const * const rowCodes = &cellCodes[getCellIndex(0, y, z)];
+            for(int32_t x = simd::findActiveCell(rowCodes, begin[0], end[0]); x < end[0];
+                x = simd::findActiveCell(rowCodes, x + 1, end[0])) {
+                int const cellCode = rowCodes[x];
+
+                // construct quad for x edge
+                if(z > 0 && y > 0) {
+                    bool const entering = (cellCode & 3) == 2;
+                    bool const exiting  = (cellCode & 3) == 1;
+                    if(entering || exiting) {
+                        i0 = getDualPointIndex(x,y,z,Builder::EDGE0,points);
+                        i1 = getDualPointIndex(x,y,z-1,Builder::EDGE2,points);
+                        i2 = getDualPointIndex(x,y-1,z-1,Builder::EDGE6,points);
+                        i3 = getDualPointIndex(x,y-1,z,Builder::EDGE4,points);
+                        if(entering) {
+                            addQuad(i0,i1,i2,i3,points,mesh);
+                        } else {
+                            addQuad(i0,i3,i2,i1,points,mesh);
+                        }
+                    }
+                }
+
+                // construct quad for y edge
+                if(z > 0 && x > 0) {
+                    bool const entering = (cellCode & 5) == 4;
+                    bool const exiting  = (cellCode & 5) == 1;
+                    if(entering || exiting) {
+                        i0 = getDualPointIndex(x,y,z,Builder::EDGE8,points);
+                        i1 = getDualPointIndex(x,y,z-1,Builder::EDGE11,points);
+                        i2 = getDualPointIndex(x-1,y,z-1,Builder::EDGE10,points);
+                        i3 = getDualPointIndex(x-1,y,z,Builder::EDGE9,points);
+                        if(exiting) {
+                            addQuad(i0,i1,i2,i3,points,mesh);
+                        } else {
+                            addQuad(i0,i3,i2,i1,points,mesh);
+                        }
+                    }
+                }
+
+                // construct quad for z edge
+                if(x > 0 && y > 0) {
+                    bool const entering = (cellCode & 17) == 16;
+                    bool const exiting  = (cellCode & 17) == 1;
+                    if(entering || exiting) {
+                        i0 = getDualPointIndex(x,y,z,Builder::EDGE3,points);
+                        i1 = getDualPointIndex(x-1,y,z,Builder::EDGE1,points);
+                        i2 = getDualPointIndex(x-1,y-1,z,Builder::EDGE5,points);
+                        i3 = getDualPointIndex(x,y-1,z,Builder::EDGE7,points);
+                        if(exiting) {
+                            addQuad(i0,i1,i2,i3,points,mesh);
+                        } else {
+                            addQuad(i0,i3,i2,i1,points,mesh);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // only bricks with dual points have modified the cache
+    if(!points.empty()) {
+        std::fill(pointCache.begin(), pointCache.end(), QuadIndexType(-1));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMCIncremental<T,IndexType>::QuadIndexType DualMCIncremental<T,IndexType>::getDualPointIndex(
+    int32_t const cx, int32_t const cy, int32_t const cz,
+    DMCEdgeCode const edge, std::vector<Vertex> & points) {
+    // look up the dual point in the slot of its cell
+    int const cubeCode = resolvedCodes[getCellIndex(cx, cy, cz)];
+    int const slot = builder.getDualPointSlot(cubeCode, edge);
+    size_t const cacheSize = size_t(brickSize + 1);
+    size_t const cacheCell = size_t(cx - cacheOrigin[0]) +
+        cacheSize * (size_t(cy - cacheOrigin[1]) + cacheSize * size_t(cz - cacheOrigin[2]));
+    QuadIndexType & index = pointCache[cacheCell * 4 + size_t(slot)];
+    if(index < 0) {
+        index = QuadIndexType(points.size());
+        points.emplace_back();
+        builder.calculateDualPoint(cx, cy, cz, iso, cubeCode, slot, points.back());
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCIncremental<T,IndexType>::addQuad(
+    QuadIndexType const i0, QuadIndexType const i1, QuadIndexType const i2, QuadIndexType const i3,
+    std::vector<Vertex> const & points, BrickMesh & mesh) const {
+    if(!generateSoup) {
+        mesh.quads.emplace_back(i0, i1, i2, i3);
+        return;
+    }
+    // every quad of a soup has its own four vertices
+    QuadIndexType const first = QuadIndexType(mesh.vertices.size());
+    mesh.vertices.push_back(points[i0]);
+    mesh.vertices.push_back(points[i1]);
+    mesh.vertices.push_back(points[i2]);
+    mesh.vertices.push_back(points[i3]);
+    mesh.quads.emplace_back(first, first + 1, first + 2, first + 3);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMCIncremental<T,IndexType>::getCellIndex(int32_t const cx, int32_t const cy, int32_t const cz) const {
+    return size_t(cx) + size_t(builder.dims[0] - 1) * (size_t(cy) + size_t(builder.dims[1] - 1) * size_t(cz));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMCIncremental<T,IndexType>::getBrickIndex(int32_t const bx, int32_t const by, int32_t const bz) const {
+    return size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz));
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_INCREMENTAL_H_INCLUDED
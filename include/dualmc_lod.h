@@ -0,0 +1,1567 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_LOD_H_INCLUDED
+#define DUALMC_LOD_H_INCLUDED
+
+/// \file   dualmc_lod.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// dual mc builder, whose kernels are shared
+#include "dualmc.h"
+
+namespace dualmc {
+
+/// \class  MipPyramid
+/// Pyramid of successively downsampled versions of a volume. Level 0 is the
+/// input volume. Each following level is computed from the previous one with
+/// a 3x3x3 tent filter centered at every second voxel, so voxel i of level l
+/// lies at voxel i*2^l of the input. A level with dim voxels along an axis is
+/// followed by a level with dim/2+1 voxels, which covers the same extent.
+template<class T> class MipPyramid {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+
+    /// Default constructor. Creates an empty pyramid.
+    MipPyramid();
+
+    /// Build the pyramid with up to numLevels levels including the input
+    /// volume. Building stops early, once a level would not be smaller than
+    /// its predecessor. The input volume is referenced and not copied, so it
+    /// has to stay valid as long as the pyramid is used.
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int const numLevels
+        );
+
+    /// Version of build, which downsamples the slices of a level concurrently
+    /// with the given executor. See ThreadExecutor for the requirements on
+    /// the executor type.
+    template<class Executor>
+    void build(
+        VolumeDataType const * data,
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int const numLevels,
+        Executor & executor
+        );
+
+    /// Get the number of levels including the input volume.
+    int getNumLevels() const;
+
+    /// Get the number of voxels of a level along the given axis.
+    int32_t getDim(int const level, int const axis) const;
+
+    /// Get the voxels of a level stored in x,y,z order.
+    VolumeDataType const * getLevel(int const level) const;
+
+    /// Get the value of a voxel of a level.
+    VolumeDataType getVoxel(int const level, int32_t const x, int32_t const y, int32_t const z) const;
+
+private:
+
+    /// Filter the voxels of slice z of a level from its predecessor.
+    void downsampleSlice(int const level, int32_t const z);
+
+private:
+
+    /// voxels of each level
+    std::vector<VolumeDataType const *> levelData;
+
+    /// number of voxels for x-,y-, and z-dimension of each level
+    std::vector<int32_t> levelDims;
+
+    /// voxels of the levels following the input volume
+    std::vector<std::vector<VolumeDataType>> downsampledLevels;
+};
+
+/// Camera used by DualMCLod for selecting the level of each brick. A brick
+/// is extracted from the coarsest level, whose cells project to at most
+/// maxPixelError pixels at the distance of the brick to the eye.
+struct LodView {
+    /// Default constructor. Places the eye at the origin with a projection
+    /// scale and pixel error of one.
+    LodView();
+
+    /// eye position in voxel coordinates of the input volume
+    float eye[3];
+    /// projected size in pixels of a length of one voxel at distance one,
+    /// e.g. the viewport height divided by 2*tan(fovy/2)
+    float projectionScale;
+    /// maximum projected cell size in pixels
+    float maxPixelError;
+};
+
+/// \class  DualMCLod
+/// Dual marching cubes builder extracting iso surfaces from the levels of a
+/// MipPyramid. Either a single level is extracted, or the volume is divided
+/// into bricks of cells, which are extracted from different levels.
+///
+/// Adaptive extractions are crack-free. The levels of bricks sharing a face,
+/// an edge, or a corner differ by at most one, which is enforced by refining
+/// bricks. Voxels on the boundary of a brick touching a coarser brick take
+/// the values interpolated from the coarser level, so all bricks agree on the
+/// edge crossings of their common boundary. The quads of edges on brick
+/// boundaries connect the dual points of the cells on both sides. Where the
+/// edge lies inside the face of a coarser cell, the coarser side contributes
+/// a single dual point, so the quad is a triangle with two equal vertices.
+template<class T, class IndexType = QuadIndexType> class DualMCLod {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+    typedef IndexType QuadIndexType;
+    typedef BasicQuad<IndexType> Quad;
+
+    /// Default constructor.
+    DualMCLod();
+
+    /// Extracts the iso surface of a single level of the pyramid. Vertices
+    /// are in voxel coordinates of the input volume.
+    void build(
+        MipPyramid<T> const & pyramid,
+        int const level,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads
+        );
+
+    /// Select the level of each brick, see LodView. Bricks have brickSize
+    /// cells of the input volume along each axis, rounded up to a multiple of
+    /// the cell size of the coarsest level. The levels are stored in x,y,z
+    /// order of the bricks, see getNumBricks.
+    void selectLevels(
+        MipPyramid<T> const & pyramid,
+        LodView const & view,
+        int32_t const brickSize,
+        std::vector<uint8_t> & levels
+        );
+
+    /// Extracts the iso surface with a level per brick. The bricks are laid
+    /// out as by selectLevels. Missing levels are set to 0, levels of the
+    /// pyramid are clamped to its coarsest level. Quad manifold generation
+    /// only considers cells of the same level. Edges at the upper volume
+    /// border are skipped as by DualMC::build, so bricks at level 0 generate
+    /// the same quads.
+    void buildAdaptive(
+        MipPyramid<T> const & pyramid,
+        std::vector<uint8_t> const & levels,
+        int32_t const brickSize,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads
+        );
+
+    /// Version of buildAdaptive, which selects the levels of bricks with
+    /// selectLevels.
+    void buildAdaptive(
+        MipPyramid<T> const & pyramid,
+        LodView const & view,
+        VolumeDataType const iso,
+        bool const generateManifold,
+        bool const generateSoup,
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads,
+        int32_t const brickSize = 32
+        );
+
+    /// Get the number of input volume cells along each axis of a brick.
+    int32_t getBrickSize() const;
+
+    /// Get the number of bricks along the given axis.
+    int32_t getNumBricks(int const axis) const;
+
+    /// Get the levels of the bricks used by the last adaptive extraction,
+    /// i.e. after enforcing the level difference between neighbors.
+    std::vector<uint8_t> const & getBrickLevels() const;
+
+private:
+    // builder types
+    typedef DualMC<T,IndexType> Builder;
+    typedef typename Builder::DMCEdgeCode DMCEdgeCode;
+
+    /// Cells of a brick extracted from one level.
+    struct Brick {
+        /// level of the cells
+        int level;
+        /// first voxel in the input volume
+        int32_t origin[3];
+        /// number of cells for x-,y-, and z-dimension
+        int32_t numCells[3];
+        /// voxels of the cells including the transition values, which are
+        /// only copied for bricks next to coarser bricks or the volume border
+        std::vector<VolumeDataType> samples;
+        /// first voxel of the cells in the samples or the pyramid level
+        VolumeDataType const * voxels;
+        /// number of voxels for x-,y-, and z-dimension of the voxel array
+        int32_t voxelDims[3];
+        /// cube codes of the cells
+        std::vector<uint8_t> cellCodes;
+        /// cube codes used for looking up dual points of the cells
+        std::vector<uint8_t> resolvedCodes;
+        /// dual point indices of the cells on the brick boundary by cell
+        /// index times four plus slot
+        std::unordered_map<size_t, QuadIndexType> boundaryPoints;
+        /// slots of merged dual points by cell index times four plus slot
+        std::unordered_map<size_t, int> mergedSlots;
+    };
+
+    /// Compute the brick layout for a pyramid.
+    void initializeBricks(MipPyramid<T> const & pyramid, int32_t const brickSize);
+
+    /// Refine bricks until the levels of neighboring bricks differ by at
+    /// most one.
+    void balanceLevels();
+
+    /// Get the brick with the given coordinates or nullptr if it is outside
+    /// of the brick grid.
+    Brick * findBrick(int32_t const bx, int32_t const by, int32_t const bz);
+
+    /// Get the coarsest level of the bricks containing an input voxel.
+    int getCoarsestLevel(int32_t const (&p)[3]) const;
+
+    /// Get the value of an input voxel on the grid of the given level. Voxels
+    /// shared with bricks of a coarser level are interpolated from it.
+    VolumeDataType getSample(int32_t const (&p)[3], int const level) const;
+
+    /// Get the side of the iso surface the center of a face of a coarser
+    /// cell is on. Returns 1 for inside, -1 for outside, and 0 if the face is
+    /// not ambiguous. For ambiguous faces the dual point table of the coarser
+    /// cell decides, which corners are connected on the face.
+    int getFaceCenterSide(int32_t const (&p)[3], int const level, int const normal) const;
+
+    /// Fill the voxels of a brick and compute its cube codes.
+    void classifyBrick(Brick & brick);
+
+    /// Compute the cube codes used for looking up dual points of a brick.
+    void resolveBrick(Brick & brick);
+
+    /// Generate the quads of the edges, whose cells all belong to a brick.
+    void extractBrick(Brick & brick, std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Generate the quads of the edges inside the face between a brick and
+    /// its predecessor along the given axis.
+    void stitchFace(int32_t const (&b)[3], int const axis, std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Generate the quads of the edges on the brick edge along the given
+    /// axis, which starts at the first voxel of a brick.
+    void stitchLine(int32_t const (&b)[3], int const axis, std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Generate the quad of an edge on a brick boundary, which starts at the
+    /// input voxel p. The edge has the cell size of the given brick, whose
+    /// voxels contain the edge.
+    void addBoundaryQuad(int32_t const (&p)[3], int const axis, Brick const & edgeBrick,
+      std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Find the connected iso lines on the face of a coarser cell next to a
+    /// brick of the next finer level. The face is at the lower side of the
+    /// cell along the normal for faceOffset 0 and at its upper side
+    /// otherwise. Its 12 finer edges, see getFaceEdge, are labelled with
+    /// their component of the iso line as seen by the finer cells. The halves
+    /// of crossed edges of the coarser cell get the slot of its dual point,
+    /// all other edges get -1.
+    void traceTransitionFace(Brick const & coarse, int32_t const (&cell)[3], int const normal,
+      int const faceOffset, int (&components)[12], int (&coarseSlots)[12]);
+
+    /// Merge the dual points of the coarser cells on the face between a
+    /// brick and its predecessor along the given axis, whose iso lines are
+    /// connected by the finer cells on the other side. Finer cells may
+    /// resolve the ambiguous subfaces of a transition face differently from
+    /// the coarser cell, which would leave a hole otherwise.
+    void mergeTransitionSlots(int32_t const (&b)[3], int const axis);
+
+    /// Get the slot of the dual point of a coarser cell, whose face contains
+    /// the edge of a finer cell starting at p. The slot is determined by
+    /// following the iso line on the face through the finer cells to an
+    /// edge of the coarser cell.
+    int getTransitionSlot(Brick const & coarse, int32_t const (&cell)[3], int const normal, bool const coarseAbove,
+      int32_t const (&p)[3], int const axis);
+
+    /// Get the slot, which a dual point of a cell has been merged into.
+    int findSlot(Brick const & brick, size_t const cellIndex, int slot) const;
+
+    /// Get the index of an edge on a face divided into 2x2 finer faces. The
+    /// edges along the first axis of the face start at (i,j), the others at
+    /// (j,i), for i in {0,1} and j in {0,1,2}.
+    static int getFaceEdge(int const axis, int const i, int const j);
+
+    /// Get the index of a dual point of a brick cell.
+    QuadIndexType getBrickPoint(Brick & brick, int32_t const (&cell)[3], int const slot,
+      std::vector<Vertex> & vertices);
+
+    /// Let the builder compute dual points from the voxels of a brick.
+    void bindBrick(Brick const & brick);
+
+    /// Compute the index of a cell in a brick.
+    size_t getCellIndex(Brick const & brick, int32_t const (&cell)[3]) const;
+
+    /// Get the marching cubes edge with the given axis and first voxel.
+    static int getEdgeIndex(int const axis, int const ox, int const oy, int const oz);
+
+    /// Get the number of cells of a brick along an axis, whose edges are
+    /// extracted. Like DualMC, no quads are generated for edges starting in
+    /// the last two voxel layers of the input volume along any axis.
+    int32_t getNumEdgeCells(Brick const & brick, int const axis) const;
+
+private:
+
+    /// builder providing the classification and dual point kernels
+    Builder builder;
+
+    /// pyramid of the current extraction
+    MipPyramid<T> const * pyramid;
+
+    /// iso value of the current extraction
+    VolumeDataType iso;
+
+    /// number of input volume cells along each axis of a brick
+    int32_t brickSize;
+
+    /// number of bricks for x-,y-, and z-dimension
+    int32_t numBricks[3];
+
+    /// level of each brick
+    std::vector<uint8_t> brickLevels;
+
+    /// bricks of the current extraction
+    std::vector<Brick> bricks;
+
+    /// brick whose voxels are used by the builder
+    Brick const * boundBrick;
+
+    /// dual point indices of the cells of the current brick
+    std::vector<QuadIndexType> pointCache;
+};
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+MipPyramid<T>::MipPyramid() {}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void MipPyramid<T>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int const numLevels
+    ) {
+    SerialExecutor executor;
+    build(data, dimX, dimY, dimZ, numLevels, executor);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> template<class Executor> inline
+void MipPyramid<T>::build(
+    VolumeDataType const * data,
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int const numLevels,
+    Executor & executor
+    ) {
+    levelData.assign(1, data);
+    levelDims.assign({dimX, dimY, dimZ});
+    downsampledLevels.clear();
+    downsampledLevels.reserve(std::max(0, numLevels - 1));
+    for(int level = 1; level < numLevels; ++level) {
+        int32_t const * const previousDims = &levelDims[3 * (level - 1)];
+        int32_t dims[3];
+        bool shrinks = false;
+        for(int i = 0; i < 3; ++i) {
+            dims[i] = previousDims[i] > 2 ? previousDims[i] / 2 + 1 : previousDims[i];
+            shrinks = shrinks || dims[i] < previousDims[i];
+        }
+        if(!shrinks)
+            break;
+        levelDims.insert(levelDims.end(), dims, dims + 3);
+        downsampledLevels.emplace_back(size_t(dims[0]) * size_t(dims[1]) * size_t(dims[2]));
+        levelData.push_back(downsampledLevels.back().data());
+        executor.run(dims[2], [&](int32_t const z) {
+            downsampleSlice(level, z);
+        });
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int MipPyramid<T>::getNumLevels() const {
+    return int(levelData.size());
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t MipPyramid<T>::getDim(int const level, int const axis) const {
+    return levelDims[3 * level + axis];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T const * MipPyramid<T>::getLevel(int const level) const {
+    return levelData[level];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T MipPyramid<T>::getVoxel(int const level, int32_t const x, int32_t const y, int32_t const z) const {
+    int32_t const * const dims = &levelDims[3 * level];
+    return levelData[level][size_t(x) + size_t(dims[0]) * (size_t(y) + size_t(dims[1]) * size_t(z))];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void MipPyramid<T>::downsampleSlice(int const level, int32_t const z) {
+    int32_t const * const dims = &levelDims[3 * level];
+    int32_t const * const sourceDims = &levelDims[3 * (level - 1)];
+    VolumeDataType * const slice = downsampledLevels[level - 1].data() + size_t(dims[0]) * size_t(dims[1]) * size_t(z);
+
+    // The tent filter weights 1,2,1 of the three source voxels around the
+    // center are applied along each axis. Source voxels outside of the
+    // volume are clamped to the border.
+    double const weights[3] = {0.25, 0.5, 0.25};
+    auto const clampSource = [](int32_t const c, int32_t const dim) {
+        return std::min(std::max(c, 0), dim - 1);
+    };
+    for(int32_t y = 0; y < dims[1]; ++y) {
+        for(int32_t x = 0; x < dims[0]; ++x) {
+            double value = 0.0;
+            for(int dz = 0; dz < 3; ++dz) {
+                int32_t const sz = clampSource(2 * z + dz - 1, sourceDims[2]);
+                for(int dy = 0; dy < 3; ++dy) {
+                    int32_t const sy = clampSource(2 * y + dy - 1, sourceDims[1]);
+                    double const weightYZ = weights[dz] * weights[dy];
+                    for(int dx = 0; dx < 3; ++dx) {
+                        int32_t const sx = clampSource(2 * x + dx - 1, sourceDims[0]);
+                        value += weightYZ * weights[dx] * double(getVoxel(level - 1, sx, sy, sz));
+                    }
+                }
+            }
+            // integer voxels are rounded to the nearest value
+            if(std::is_integral<VolumeDataType>::value) {
+                value = std::floor(value + 0.5);
+            }
+            slice[size_t(x) + size_t(dims[0]) * size_t(y)] = VolumeDataType(value);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+LodView::LodView() : projectionScale(1.0f), maxPixelError(1.0f) {
+    for(int i = 0; i < 3; ++i) {
+        eye[i] = 0.0f;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+DualMCLod<T,IndexType>::DualMCLod() :
+    pyramid(nullptr),
+    iso(),
+    brickSize(1),
+    boundBrick(nullptr) {
+    for(int i = 0; i < 3; ++i) {
+        numBricks[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::build(
+    MipPyramid<T> const & pyramid,
+    int const level,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+    int const clampedLevel = std::min(std::max(level, 0), pyramid.getNumLevels() - 1);
+    builder.build(pyramid.getLevel(clampedLevel),
+        pyramid.getDim(clampedLevel, 0), pyramid.getDim(clampedLevel, 1), pyramid.getDim(clampedLevel, 2),
+        iso, generateManifold, generateSoup, vertices, quads);
+
+    // scale the vertices from level voxels to input voxels
+    VertexComponentsType const scale = VertexComponentsType(int32_t(1) << clampedLevel);
+    for(Vertex & v : vertices) {
+        v.x *= scale;
+        v.y *= scale;
+        v.z *= scale;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::selectLevels(
+    MipPyramid<T> const & pyramid,
+    LodView const & view,
+    int32_t const brickSize,
+    std::vector<uint8_t> & levels
+    ) {
+    initializeBricks(pyramid, brickSize);
+    int const maxLevel = pyramid.getNumLevels() - 1;
+    levels.resize(size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]));
+    size_t b = 0;
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx, ++b) {
+                // distance of the eye to the closest point of the brick
+                int32_t const coords[3] = {bx, by, bz};
+                float squaredDistance = 0.0f;
+                for(int i = 0; i < 3; ++i) {
+                    float const lower = float(coords[i] * this->brickSize);
+                    float const upper = lower + float(this->brickSize);
+                    float const offset = std::max(std::max(lower - view.eye[i], view.eye[i] - upper), 0.0f);
+                    squaredDistance += offset * offset;
+                }
+
+                // the cells of level l project to 2^l * projectionScale / distance pixels
+                float const maxCellSize = view.maxPixelError * std::sqrt(squaredDistance) /
+                    std::max(view.projectionScale, 1e-6f);
+                int level = 0;
+                while(level < maxLevel && float(int32_t(2) << level) <= maxCellSize) {
+                    ++level;
+                }
+                levels[b] = uint8_t(level);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::buildAdaptive(
+    MipPyramid<T> const & pyramid,
+    std::vector<uint8_t> const & levels,
+    int32_t const brickSize,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads
+    ) {
+    vertices.clear();
+    quads.clear();
+    initializeBricks(pyramid, brickSize);
+    this->pyramid = &pyramid;
+    this->iso = iso;
+    builder.generateManifold = generateManifold;
+    int const maxLevel = pyramid.getNumLevels() - 1;
+    size_t const totalBricks = size_t(numBricks[0]) * size_t(numBricks[1]) * size_t(numBricks[2]);
+    brickLevels.assign(totalBricks, 0);
+    for(size_t b = 0; b < std::min(totalBricks, levels.size()); ++b) {
+        brickLevels[b] = uint8_t(std::min<int>(levels[b], maxLevel));
+    }
+    balanceLevels();
+
+    // set up the bricks
+    bricks.clear();
+    bricks.resize(totalBricks);
+    size_t b = 0;
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx, ++b) {
+                Brick & brick = bricks[b];
+                brick.level = brickLevels[b];
+                int32_t const coords[3] = {bx, by, bz};
+                for(int i = 0; i < 3; ++i) {
+                    brick.origin[i] = coords[i] * this->brickSize;
+                    int32_t const inputCells = std::min(this->brickSize, pyramid.getDim(0, i) - 1 - brick.origin[i]);
+                    brick.numCells[i] = (inputCells + (int32_t(1) << brick.level) - 1) >> brick.level;
+                }
+            }
+        }
+    }
+
+    // The cube codes of all bricks of a level are needed for resolving the
+    // codes of cells next to neighboring bricks. The voxels of finer bricks
+    // depend on the resolved codes of coarser ones, so the levels are
+    // processed from coarse to fine.
+    for(int level = maxLevel; level >= 0; --level) {
+        for(Brick & brick : bricks) {
+            if(brick.level == level)
+                classifyBrick(brick);
+        }
+        for(Brick & brick : bricks) {
+            if(brick.level == level)
+                resolveBrick(brick);
+        }
+    }
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx) {
+                int32_t const coords[3] = {bx, by, bz};
+                for(int axis = 0; axis < 3; ++axis) {
+                    mergeTransitionSlots(coords, axis);
+                }
+            }
+        }
+    }
+    for(Brick & brick : bricks) {
+        extractBrick(brick, vertices, quads);
+    }
+
+    // connect the bricks at their common faces and edges
+    for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+        for(int32_t by = 0; by < numBricks[1]; ++by) {
+            for(int32_t bx = 0; bx < numBricks[0]; ++bx) {
+                int32_t const coords[3] = {bx, by, bz};
+                for(int axis = 0; axis < 3; ++axis) {
+                    stitchFace(coords, axis, vertices, quads);
+                    stitchLine(coords, axis, vertices, quads);
+                }
+            }
+        }
+    }
+    bricks.clear();
+    boundBrick = nullptr;
+
+    // every quad of a soup has its own four vertices
+    if(generateSoup) {
+        std::vector<Vertex> soupVertices;
+        soupVertices.reserve(quads.size() * 4);
+        for(Quad & quad : quads) {
+            QuadIndexType const first = QuadIndexType(soupVertices.size());
+            soupVertices.push_back(vertices[quad.i0]);
+            soupVertices.push_back(vertices[quad.i1]);
+            soupVertices.push_back(vertices[quad.i2]);
+            soupVertices.push_back(vertices[quad.i3]);
+            quad = Quad(first, first + 1, first + 2, first + 3);
+        }
+        vertices.swap(soupVertices);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::buildAdaptive(
+    MipPyramid<T> const & pyramid,
+    LodView const & view,
+    VolumeDataType const iso,
+    bool const generateManifold,
+    bool const generateSoup,
+    std::vector<Vertex> & vertices,
+    std::vector<Quad> & quads,
+    int32_t const brickSize
+    ) {
+    std::vector<uint8_t> levels;
+    selectLevels(pyramid, view, brickSize, levels);
+    buildAdaptive(pyramid, levels, brickSize, iso, generateManifold, generateSoup, vertices, quads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int32_t DualMCLod<T,IndexType>::getBrickSize() const {
+    return brickSize;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int32_t DualMCLod<T,IndexType>::getNumBricks(int const axis) const {
+    return numBricks[axis];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+std::vector<uint8_t> const & DualMCLod<T,IndexType>::getBrickLevels() const {
+    return brickLevels;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::initializeBricks(MipPyramid<T> const & pyramid, int32_t const brickSize) {
+    // brick boundaries have to be voxels of all levels
+    int32_t const coarsestCellSize = int32_t(1) << std::max(0, pyramid.getNumLevels() - 1);
+    this->brickSize = (std::max<int32_t>(1, brickSize) + coarsestCellSize - 1) / coarsestCellSize * coarsestCellSize;
+    for(int i = 0; i < 3; ++i) {
+        int32_t const numCells = pyramid.getNumLevels() > 0 ? std::max(0, pyramid.getDim(0, i) - 1) : 0;
+        numBricks[i] = (numCells + this->brickSize - 1) / this->brickSize;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::balanceLevels() {
+    // Coarse bricks are refined to one level above their finest neighbor.
+    // Refined bricks may require refining their neighbors, so the passes
+    // are repeated until no level changes.
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        size_t b = 0;
+        for(int32_t bz = 0; bz < numBricks[2]; ++bz) {
+            for(int32_t by = 0; by < numBricks[1]; ++by) {
+                for(int32_t bx = 0; bx < numBricks[0]; ++bx, ++b) {
+                    int maxLevel = brickLevels[b];
+                    for(int32_t nz = std::max(bz - 1, 0); nz <= std::min(bz + 1, numBricks[2] - 1); ++nz)
+                        for(int32_t ny = std::max(by - 1, 0); ny <= std::min(by + 1, numBricks[1] - 1); ++ny)
+                            for(int32_t nx = std::max(bx - 1, 0); nx <= std::min(bx + 1, numBricks[0] - 1); ++nx) {
+                                size_t const n = size_t(nx) + size_t(numBricks[0]) * (size_t(ny) + size_t(numBricks[1]) * size_t(nz));
+                                maxLevel = std::min(maxLevel, brickLevels[n] + 1);
+                            }
+                    if(maxLevel < brickLevels[b]) {
+                        brickLevels[b] = uint8_t(maxLevel);
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMCLod<T,IndexType>::Brick * DualMCLod<T,IndexType>::findBrick(
+    int32_t const bx, int32_t const by, int32_t const bz) {
+    if(bx < 0 || by < 0 || bz < 0 || bx >= numBricks[0] || by >= numBricks[1] || bz >= numBricks[2])
+        return nullptr;
+    return &bricks[size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz))];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::getCoarsestLevel(int32_t const (&p)[3]) const {
+    // voxels on a brick boundary belong to the bricks on both sides
+    int32_t begin[3], end[3];
+    for(int i = 0; i < 3; ++i) {
+        int32_t const b = p[i] / brickSize;
+        begin[i] = std::max(p[i] % brickSize == 0 ? b - 1 : b, 0);
+        end[i] = std::min(b, numBricks[i] - 1);
+    }
+    int level = 0;
+    for(int32_t bz = begin[2]; bz <= end[2]; ++bz)
+        for(int32_t by = begin[1]; by <= end[1]; ++by)
+            for(int32_t bx = begin[0]; bx <= end[0]; ++bx)
+                level = std::max<int>(level,
+                    brickLevels[size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz))]);
+    return level;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+T DualMCLod<T,IndexType>::getSample(int32_t const (&p)[3], int const level) const {
+    // Coarse bricks may extend beyond the volume, whose voxels are clamped
+    // to its border.
+    int const coarsest = std::max(getCoarsestLevel(p), level);
+    if(coarsest == level)
+        return pyramid->getVoxel(level,
+            std::min(p[0] >> level, pyramid->getDim(level, 0) - 1),
+            std::min(p[1] >> level, pyramid->getDim(level, 1) - 1),
+            std::min(p[2] >> level, pyramid->getDim(level, 2) - 1));
+
+    // multilinear interpolation of the voxels of the coarsest level
+    int32_t const cellSize = int32_t(1) << coarsest;
+    int32_t lower[3];
+    double weights[3];
+    for(int i = 0; i < 3; ++i) {
+        lower[i] = std::min(p[i] >> coarsest, pyramid->getDim(coarsest, i) - 1);
+        weights[i] = lower[i] < pyramid->getDim(coarsest, i) - 1 ?
+            double(p[i] - (lower[i] << coarsest)) / double(cellSize) : 0.0;
+    }
+    double value = 0.0;
+    for(int corner = 0; corner < 8; ++corner) {
+        double weight = 1.0;
+        int32_t c[3];
+        for(int i = 0; i < 3; ++i) {
+            int const upper = (corner >> i) & 1;
+            weight *= upper ? weights[i] : 1.0 - weights[i];
+            c[i] = lower[i] + upper;
+        }
+        if(weight > 0.0) {
+            value += weight * double(pyramid->getVoxel(coarsest, c[0], c[1], c[2]));
+        }
+    }
+    // Truncating keeps interpolated integer voxels on the side of the iso
+    // value of the voxels they are interpolated from.
+    VolumeDataType const sample = VolumeDataType(value);
+
+    // The bilinearly interpolated center of an ambiguous face may connect
+    // other corners than the dual point table of the coarser cell does.
+    int numCenterAxes = 0;
+    int normal = 0;
+    for(int i = 0; i < 3; ++i) {
+        if(weights[i] > 0.0) {
+            ++numCenterAxes;
+        } else {
+            normal = i;
+        }
+    }
+    if(numCenterAxes == 2) {
+        int const side = getFaceCenterSide(p, coarsest, normal);
+        if(side > 0 && !(sample >= iso))
+            return iso;
+        if(side < 0 && sample >= iso)
+            return std::is_integral<VolumeDataType>::value ?
+                VolumeDataType(iso - 1) : VolumeDataType(std::nextafter(iso, std::numeric_limits<VolumeDataType>::lowest()));
+    }
+    return sample;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::getFaceCenterSide(int32_t const (&p)[3], int const level, int const normal) const {
+    // find the cell of the brick with the given level, whose face contains p
+    Brick const * brick = nullptr;
+    for(int32_t bz = std::max((p[2] - 1) / brickSize, 0); bz <= std::min(p[2] / brickSize, numBricks[2] - 1) && !brick; ++bz)
+        for(int32_t by = std::max((p[1] - 1) / brickSize, 0); by <= std::min(p[1] / brickSize, numBricks[1] - 1) && !brick; ++by)
+            for(int32_t bx = std::max((p[0] - 1) / brickSize, 0); bx <= std::min(p[0] / brickSize, numBricks[0] - 1) && !brick; ++bx) {
+                Brick const & candidate = bricks[size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz))];
+                if(candidate.level == level && !candidate.resolvedCodes.empty())
+                    brick = &candidate;
+            }
+    if(!brick)
+        return 0;
+    int32_t cell[3];
+    for(int i = 0; i < 3; ++i) {
+        cell[i] = (p[i] - brick->origin[i]) >> level;
+    }
+    int const faceOffset = p[normal] == brick->origin[normal] ? 0 : 1;
+    cell[normal] -= faceOffset;
+    for(int i = 0; i < 3; ++i) {
+        if(cell[i] < 0 || cell[i] >= brick->numCells[i])
+            return 0;
+    }
+    size_t const cellIndex = getCellIndex(*brick, cell);
+    int const cubeCode = brick->resolvedCodes[cellIndex];
+    bool const inverted = cubeCode != brick->cellCodes[cellIndex];
+
+    // corners and edges of the face by their coordinates along u and v
+    int const u = normal == 0 ? 1 : 0;
+    int const v = normal == 2 ? 1 : 2;
+    bool inside[2][2];
+    int uSlots[2], vSlots[2];
+    for(int b = 0; b < 2; ++b) {
+        for(int a = 0; a < 2; ++a) {
+            int offsets[3];
+            offsets[normal] = faceOffset;
+            offsets[u] = a;
+            offsets[v] = b;
+            inside[a][b] = ((cubeCode >> (offsets[0] + 2 * offsets[1] + 4 * offsets[2])) & 1) == 1;
+        }
+        int offsets[3];
+        offsets[normal] = faceOffset;
+        offsets[u] = 0;
+        offsets[v] = b;
+        uSlots[b] = builder.getDualPointSlot(cubeCode, DMCEdgeCode(1 << getEdgeIndex(u, offsets[0], offsets[1], offsets[2])));
+        offsets[u] = b;
+        offsets[v] = 0;
+        vSlots[b] = builder.getDualPointSlot(cubeCode, DMCEdgeCode(1 << getEdgeIndex(v, offsets[0], offsets[1], offsets[2])));
+    }
+    if(inside[0][0] != inside[1][1] || inside[0][0] == inside[1][0])
+        return 0;
+
+    // The iso line segment cutting off a corner connects its two edges,
+    // which therefore share a dual point.
+    bool const diagonalCut = uSlots[0] == vSlots[0] && uSlots[1] == vSlots[1];
+    bool const antiDiagonalCut = uSlots[0] == vSlots[1] && uSlots[1] == vSlots[0];
+    if(diagonalCut == antiDiagonalCut)
+        return 0;
+    // the center is connected to the corners, which are not cut off
+    bool const centerInside = (diagonalCut ? !inside[0][0] : inside[0][0]) != inverted;
+    return centerInside ? 1 : -1;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::classifyBrick(Brick & brick) {
+    int32_t const dims[3] = {brick.numCells[0] + 1, brick.numCells[1] + 1, brick.numCells[2] + 1};
+    int32_t const cellSize = int32_t(1) << brick.level;
+
+    // Only voxels on the boundary of bricks next to coarser bricks are
+    // interpolated. Bricks without those and within the volume use the
+    // voxels of their level directly.
+    bool nextToCoarser = false;
+    for(int32_t bz = std::max(brick.origin[2] / brickSize - 1, 0); bz <= std::min(brick.origin[2] / brickSize + 1, numBricks[2] - 1); ++bz)
+        for(int32_t by = std::max(brick.origin[1] / brickSize - 1, 0); by <= std::min(brick.origin[1] / brickSize + 1, numBricks[1] - 1); ++by)
+            for(int32_t bx = std::max(brick.origin[0] / brickSize - 1, 0); bx <= std::min(brick.origin[0] / brickSize + 1, numBricks[0] - 1); ++bx)
+                nextToCoarser = nextToCoarser ||
+                    brickLevels[size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz))] > brick.level;
+    VolumeDataType const * const levelData = pyramid->getLevel(brick.level);
+    int32_t const levelDims[3] = {
+        pyramid->getDim(brick.level, 0),
+        pyramid->getDim(brick.level, 1),
+        pyramid->getDim(brick.level, 2)
+    };
+    int32_t const levelOrigin[3] = {
+        brick.origin[0] >> brick.level,
+        brick.origin[1] >> brick.level,
+        brick.origin[2] >> brick.level
+    };
+    bool const insideVolume =
+        levelOrigin[0] + dims[0] <= levelDims[0] &&
+        levelOrigin[1] + dims[1] <= levelDims[1] &&
+        levelOrigin[2] + dims[2] <= levelDims[2];
+    if(!nextToCoarser && insideVolume) {
+        brick.samples.clear();
+        brick.voxels = levelData + size_t(levelOrigin[0]) + size_t(levelDims[0]) *
+            (size_t(levelOrigin[1]) + size_t(levelDims[1]) * size_t(levelOrigin[2]));
+        for(int i = 0; i < 3; ++i) {
+            brick.voxelDims[i] = levelDims[i];
+        }
+    } else {
+        brick.samples.resize(size_t(dims[0]) * size_t(dims[1]) * size_t(dims[2]));
+        size_t s = 0;
+        for(int32_t z = 0; z < dims[2]; ++z) {
+            for(int32_t y = 0; y < dims[1]; ++y, s += size_t(dims[0])) {
+                bool const boundaryRow = z == 0 || y == 0 || z == dims[2] - 1 || y == dims[1] - 1;
+                int32_t const first = !nextToCoarser ? 0 : boundaryRow ? dims[0] : 1;
+                int32_t const last = !nextToCoarser ? dims[0] : boundaryRow ? dims[0] : dims[0] - 1;
+                for(int32_t x = 0; x < dims[0]; ++x) {
+                    if(x >= first && x < last)
+                        continue;
+                    int32_t const p[3] = {
+                        brick.origin[0] + x * cellSize,
+                        brick.origin[1] + y * cellSize,
+                        brick.origin[2] + z * cellSize
+                    };
+                    brick.samples[s + size_t(x)] = getSample(p, brick.level);
+                }
+
+                // coarser bricks may extend beyond the volume, whose voxels
+                // are clamped to its border
+                VolumeDataType const * const levelRow = levelData + size_t(levelDims[0]) *
+                    (size_t(std::min(levelOrigin[1] + y, levelDims[1] - 1)) +
+                     size_t(levelDims[1]) * size_t(std::min(levelOrigin[2] + z, levelDims[2] - 1)));
+                for(int32_t x = first; x < last; ++x) {
+                    brick.samples[s + size_t(x)] = levelRow[std::min(levelOrigin[0] + x, levelDims[0] - 1)];
+                }
+            }
+        }
+        brick.voxels = brick.samples.data();
+        for(int i = 0; i < 3; ++i) {
+            brick.voxelDims[i] = dims[i];
+        }
+    }
+
+    bindBrick(brick);
+    brick.cellCodes.resize(size_t(brick.numCells[0]) * size_t(brick.numCells[1]) * size_t(brick.numCells[2]));
+    for(int32_t cz = 0; cz < brick.numCells[2]; ++cz) {
+        for(int32_t cy = 0; cy < brick.numCells[1]; ++cy) {
+            int32_t const row[3] = {0, cy, cz};
+            builder.classifyCellRow(0, brick.numCells[0], cy, cz, iso, &brick.cellCodes[getCellIndex(brick, row)]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::resolveBrick(Brick & brick) {
+    brick.resolvedCodes = brick.cellCodes;
+    if(!builder.generateManifold)
+        return;
+    int32_t const brickCoords[3] = {
+        brick.origin[0] / brickSize,
+        brick.origin[1] / brickSize,
+        brick.origin[2] / brickSize
+    };
+    size_t cellIndex = 0;
+    for(int32_t cz = 0; cz < brick.numCells[2]; ++cz) {
+        for(int32_t cy = 0; cy < brick.numCells[1]; ++cy) {
+            for(int32_t cx = 0; cx < brick.numCells[0]; ++cx, ++cellIndex) {
+                // Like DualMC::resolveCellCodeLayer, the cube code of
+                // problematic C16 and C19 configurations sharing their
+                // ambiguous face with another problematic configuration is
+                // inverted. Neighbors in other bricks are only considered if
+                // they have the same level.
+                int const cubeCode = brick.cellCodes[cellIndex];
+                uint8_t const direction = Builder::problematicConfigs[uint8_t(cubeCode)];
+                if(direction == 255)
+                    continue;
+                int8_t const * const offset = Builder::problematicNeighborOffsets[direction];
+                int32_t neighborCell[3] = {cx + offset[0], cy + offset[1], cz + offset[2]};
+                int32_t neighborBrick[3] = {brickCoords[0], brickCoords[1], brickCoords[2]};
+                unsigned int const component = direction >> 1;
+                Brick const * neighbor = &brick;
+                if(neighborCell[component] < 0 || neighborCell[component] >= brick.numCells[component]) {
+                    neighborBrick[component] += offset[component];
+                    neighbor = findBrick(neighborBrick[0], neighborBrick[1], neighborBrick[2]);
+                    if(!neighbor || neighbor->level != brick.level)
+                        continue;
+                    neighborCell[component] = neighborCell[component] < 0 ? neighbor->numCells[component] - 1 : 0;
+                }
+                int const neighborCubeCode = neighbor->cellCodes[getCellIndex(*neighbor, neighborCell)];
+                if(Builder::problematicConfigs[uint8_t(neighborCubeCode)] != 255) {
+                    brick.resolvedCodes[cellIndex] = uint8_t(cubeCode ^ 0xff);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::extractBrick(Brick & brick, std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    bindBrick(brick);
+    pointCache.assign(brick.cellCodes.size() * 4, QuadIndexType(-1));
+    auto const getIndex = [&](int32_t const cx, int32_t const cy, int32_t const cz, DMCEdgeCode const edge) {
+        int32_t const cell[3] = {cx, cy, cz};
+        size_t const cellIndex = getCellIndex(brick, cell);
+        int const slot = builder.getDualPointSlot(brick.resolvedCodes[cellIndex], edge);
+        QuadIndexType & index = pointCache[cellIndex * 4 + size_t(slot)];
+        if(index < 0) {
+            index = getBrickPoint(brick, cell, slot, vertices);
+        }
+        return index;
+    };
+
+    QuadIndexType i0,i1,i2,i3;
+
+    // the quads are generated in the same way as in DualMC
+    int32_t const numEdgeCells[3] = {
+        getNumEdgeCells(brick, 0), getNumEdgeCells(brick, 1), getNumEdgeCells(brick, 2)
+    };
+    for(int32_t z = 0; z < numEdgeCells[2]; ++z) {
+        for(int32_t y = 0; y < numEdgeCells[1]; ++y) {
+            int32_t const row[3] = {0, y, z};
+            uint8_t const * const rowCodes = brick.cellCodes.data() + getCellIndex(brick, row);
+            for(int32_t x = simd::findActiveCell(rowCodes, 0, numEdgeCells[0]); x < numEdgeCells[0];
+                x = simd::findActiveCell(rowCodes, x + 1, numEdgeCells[0])) {
+                int const cellCode = rowCodes[x];
+
+                // construct quad for x edge
+                if(z > 0 && y > 0) {
+                    bool const entering = (cellCode & 3) == 2;
+                    bool const exiting  = (cellCode & 3) == 1;
+                    if(entering || exiting) {
+                        i0 = getIndex(x,y,z,Builder::EDGE0);
+                        i1 = getIndex(x,y,z-1,Builder::EDGE2);
+                        i2 = getIndex(x,y-1,z-1,Builder::EDGE6);
+                        i3 = getIndex(x,y-1,z,Builder::EDGE4);
+                        if(entering) {
+                            quads.emplace_back(i0,i1,i2,i3);
+                        } else {
+                            quads.emplace_back(i0,i3,i2,i1);
+                        }
+                    }
+                }
+
+                // construct quad for y edge
+                if(z > 0 && x > 0) {
+                    bool const entering = (cellCode & 5) == 4;
+                    bool const exiting  = (cellCode & 5) == 1;
+                    if(entering || exiting) {
+                        i0 = getIndex(x,y,z,Builder::EDGE8);
+                        i1 = getIndex(x,y,z-1,Builder::EDGE11);
+                        i2 = getIndex(x-1,y,z-1,Builder::EDGE10);
+                        i3 = getIndex(x-1,y,z,Builder::EDGE9);
+                        if(exiting) {
+                            quads.emplace_back(i0,i1,i2,i3);
+                        } else {
+                            quads.emplace_back(i0,i3,i2,i1);
+                        }
+                    }
+                }
+
+                // construct quad for z edge
+                if(x > 0 && y > 0) {
+                    bool const entering = (cellCode & 17) == 16;
+                    bool const exiting  = (cellCode & 17) == 1;
+                    if(entering || exiting) {
+                        i0 = getIndex(x,y,z,Builder::EDGE3);
+                        i1 = getIndex(x-1,y,z,Builder::EDGE1);
+                        i2 = getIndex(x-1,y-1,z,Builder::EDGE5);
+                        i3 = getIndex(x,y-1,z,Builder::EDGE7);
+                        if(exiting) {
+                            quads.emplace_back(i0,i1,i2,i3);
+                        } else {
+                            quads.emplace_back(i0,i3,i2,i1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::stitchFace(int32_t const (&b)[3], int const axis,
+  std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    int32_t previous[3] = {b[0], b[1], b[2]};
+    --previous[axis];
+    Brick const * const upperBrick = findBrick(b[0], b[1], b[2]);
+    Brick const * const lowerBrick = findBrick(previous[0], previous[1], previous[2]);
+    if(!upperBrick || !lowerBrick)
+        return;
+
+    // The edges are as long as the cells of the finer brick. Edges on the
+    // boundary of the face are handled by stitchLine.
+    Brick const & edgeBrick = upperBrick->level <= lowerBrick->level ? *upperBrick : *lowerBrick;
+    int32_t const step = int32_t(1) << edgeBrick.level;
+    int const u = axis == 0 ? 1 : 0;
+    int const v = axis == 2 ? 1 : 2;
+    int32_t end[3];
+    for(int i = 0; i < 3; ++i) {
+        end[i] = upperBrick->origin[i] + std::min(
+            upperBrick->numCells[i] << upperBrick->level,
+            lowerBrick->numCells[i] << lowerBrick->level);
+    }
+    int32_t p[3];
+    p[axis] = upperBrick->origin[axis];
+    for(int edgeAxis = 0; edgeAxis < 2; ++edgeAxis) {
+        int const along = edgeAxis == 0 ? u : v;
+        int const across = edgeAxis == 0 ? v : u;
+        for(p[across] = upperBrick->origin[across] + step; p[across] < end[across]; p[across] += step) {
+            for(p[along] = upperBrick->origin[along]; p[along] < end[along]; p[along] += step) {
+                addBoundaryQuad(p, along, edgeBrick, vertices, quads);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::stitchLine(int32_t const (&b)[3], int const axis,
+  std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    // the four bricks around the line
+    int const u = axis == 0 ? 1 : 0;
+    int const v = axis == 2 ? 1 : 2;
+    Brick const * around[4];
+    for(int i = 0; i < 4; ++i) {
+        int32_t coords[3] = {b[0], b[1], b[2]};
+        coords[u] -= i & 1;
+        coords[v] -= i >> 1;
+        around[i] = findBrick(coords[0], coords[1], coords[2]);
+        if(!around[i])
+            return;
+    }
+
+    // the edges are as long as the cells of the finest brick
+    Brick const * edgeBrick = around[0];
+    int32_t end = around[0]->origin[axis] + (around[0]->numCells[axis] << around[0]->level);
+    for(int i = 1; i < 4; ++i) {
+        if(around[i]->level < edgeBrick->level) {
+            edgeBrick = around[i];
+        }
+        end = std::min(end, around[i]->origin[axis] + (around[i]->numCells[axis] << around[i]->level));
+    }
+    int32_t const step = int32_t(1) << edgeBrick->level;
+    int32_t p[3] = {around[0]->origin[0], around[0]->origin[1], around[0]->origin[2]};
+    for(; p[axis] < end; p[axis] += step) {
+        addBoundaryQuad(p, axis, *edgeBrick, vertices, quads);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::addBoundaryQuad(int32_t const (&p)[3], int const axis, Brick const & edgeBrick,
+  std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    // skip the edges, which DualMC does not extract, see getNumEdgeCells
+    for(int i = 0; i < 3; ++i) {
+        if(p[i] >= pyramid->getDim(0, i) - 2)
+            return;
+    }
+    int const level = edgeBrick.level;
+    int32_t const * const voxelDims = edgeBrick.voxelDims;
+    size_t const start = size_t((p[0] - edgeBrick.origin[0]) >> level) + size_t(voxelDims[0]) *
+        (size_t((p[1] - edgeBrick.origin[1]) >> level) + size_t(voxelDims[1]) * size_t((p[2] - edgeBrick.origin[2]) >> level));
+    size_t const stride = axis == 0 ? 1 : axis == 1 ? size_t(voxelDims[0]) : size_t(voxelDims[0]) * size_t(voxelDims[1]);
+    bool const startInside = edgeBrick.voxels[start] >= iso;
+    bool const endInside = edgeBrick.voxels[start + stride] >= iso;
+    if(startInside == endInside)
+        return;
+
+    // The four cells around the edge are visited in the same order as in
+    // DualMC. Each entry holds the sides of the two other axes.
+    static int const sides[3][4][2] = {
+        {{1,1},{1,-1},{-1,-1},{-1,1}},
+        {{1,1},{1,-1},{-1,-1},{-1,1}},
+        {{1,1},{-1,1},{-1,-1},{1,-1}}
+    };
+    int const u = axis == 0 ? 1 : 0;
+    int const v = axis == 2 ? 1 : 2;
+    Brick * cellBricks[4];
+    int32_t cells[4][3];
+    int slots[4];
+    for(int k = 0; k < 4; ++k) {
+        int const side[3] = {
+            axis == 0 ? 0 : sides[axis][k][0],
+            axis == 1 ? 0 : (axis == 0 ? sides[axis][k][0] : sides[axis][k][1]),
+            axis == 2 ? 0 : sides[axis][k][1]
+        };
+        int32_t brickCoords[3];
+        for(int i = 0; i < 3; ++i) {
+            brickCoords[i] = (side[i] < 0 ? p[i] - 1 : p[i]) / brickSize;
+        }
+        if(p[u] == 0 && side[u] < 0)
+            return;
+        if(p[v] == 0 && side[v] < 0)
+            return;
+        Brick * const brick = findBrick(brickCoords[0], brickCoords[1], brickCoords[2]);
+        if(!brick)
+            return;
+
+        // cell of the brick's level next to the edge on the given sides
+        int32_t offsets[3] = {0, 0, 0};
+        int interiorAxis = -1;
+        for(int i = 0; i < 3; ++i) {
+            int32_t const local = p[i] - brick->origin[i];
+            cells[k][i] = local >> brick->level;
+            if(i == axis)
+                continue;
+            if((local & ((int32_t(1) << brick->level) - 1)) != 0) {
+                interiorAxis = i;
+            } else if(side[i] < 0) {
+                --cells[k][i];
+                offsets[i] = 1;
+            }
+        }
+        for(int i = 0; i < 3; ++i) {
+            if(cells[k][i] < 0 || cells[k][i] >= brick->numCells[i])
+                return;
+        }
+        cellBricks[k] = brick;
+        if(interiorAxis < 0) {
+            int const edge = getEdgeIndex(axis, offsets[0], offsets[1], offsets[2]);
+            slots[k] = builder.getDualPointSlot(brick->resolvedCodes[getCellIndex(*brick, cells[k])], DMCEdgeCode(1 << edge));
+        } else {
+            // the edge lies inside the face of a coarser cell
+            int const normal = 3 - axis - interiorAxis;
+            slots[k] = getTransitionSlot(*brick, cells[k], normal, side[normal] > 0, p, axis);
+        }
+    }
+
+    QuadIndexType indices[4];
+    for(int k = 0; k < 4; ++k) {
+        indices[k] = getBrickPoint(*cellBricks[k], cells[k], slots[k], vertices);
+    }
+    bool const entering = !startInside && endInside;
+    if(axis == 0 ? entering : !entering) {
+        quads.emplace_back(indices[0], indices[1], indices[2], indices[3]);
+    } else {
+        quads.emplace_back(indices[0], indices[3], indices[2], indices[1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::traceTransitionFace(Brick const & coarse, int32_t const (&cell)[3], int const normal,
+  int const faceOffset, int (&components)[12], int (&coarseSlots)[12]) {
+    // The face is divided into 2x2 faces of finer cells. Its 12 finer edges
+    // are numbered with the edges along u first.
+    int const u = normal == 0 ? 1 : 0;
+    int const v = normal == 2 ? 1 : 2;
+    int const fineLevel = coarse.level - 1;
+    int32_t const fineSize = int32_t(1) << fineLevel;
+    int32_t origin[3];
+    for(int i = 0; i < 3; ++i) {
+        origin[i] = coarse.origin[i] + (cell[i] << coarse.level);
+    }
+    origin[normal] += faceOffset << coarse.level;
+    bool inside[3][3];
+    for(int j = 0; j < 3; ++j) {
+        for(int i = 0; i < 3; ++i) {
+            int32_t position[3] = {origin[0], origin[1], origin[2]};
+            position[u] += i * fineSize;
+            position[v] += j * fineSize;
+            inside[i][j] = getSample(position, fineLevel) >= iso;
+        }
+    }
+    bool crossed[12];
+    for(int j = 0; j < 3; ++j) {
+        for(int i = 0; i < 2; ++i) {
+            crossed[getFaceEdge(0, i, j)] = inside[i][j] != inside[i+1][j];
+            crossed[getFaceEdge(1, j, i)] = inside[j][i] != inside[j][i+1];
+        }
+    }
+
+    // Edges, which share a dual point of the finer cell behind a face, are
+    // connected by the iso line.
+    for(int e = 0; e < 12; ++e) {
+        components[e] = e;
+    }
+    auto const find = [&](int e) {
+        while(components[e] != e) {
+            e = components[e];
+        }
+        return e;
+    };
+    int32_t fineBrickCoords[3];
+    for(int i = 0; i < 3; ++i) {
+        fineBrickCoords[i] = origin[i] / brickSize;
+    }
+    fineBrickCoords[normal] = (faceOffset == 0 ? origin[normal] - 1 : origin[normal]) / brickSize;
+    Brick const * const fine = findBrick(fineBrickCoords[0], fineBrickCoords[1], fineBrickCoords[2]);
+    int const fineOffset = 1 - faceOffset;
+    for(int j = 0; j < 2; ++j) {
+        for(int i = 0; i < 2; ++i) {
+            int32_t fineCell[3];
+            for(int c = 0; c < 3; ++c) {
+                fineCell[c] = (origin[c] - fine->origin[c]) >> fineLevel;
+            }
+            fineCell[u] += i;
+            fineCell[v] += j;
+            fineCell[normal] -= fineOffset;
+            if(fineCell[u] >= fine->numCells[u] || fineCell[v] >= fine->numCells[v])
+                continue;
+            int const cubeCode = fine->resolvedCodes[getCellIndex(*fine, fineCell)];
+
+            // the edges along u at v=0,1 and along v at u=0,1 of the finer cell
+            int const edges[4] = {getFaceEdge(0, i, j), getFaceEdge(0, i, j + 1), getFaceEdge(1, i, j), getFaceEdge(1, i + 1, j)};
+            int edgeSlots[4];
+            for(int k = 0; k < 4; ++k) {
+                edgeSlots[k] = -1;
+                if(!crossed[edges[k]])
+                    continue;
+                int offsets[3];
+                offsets[normal] = fineOffset;
+                offsets[u] = k < 2 ? 0 : k - 2;
+                offsets[v] = k < 2 ? k : 0;
+                int const edge = getEdgeIndex(k < 2 ? u : v, offsets[0], offsets[1], offsets[2]);
+                edgeSlots[k] = builder.getDualPointSlot(cubeCode, DMCEdgeCode(1 << edge));
+                for(int l = 0; l < k; ++l) {
+                    if(edgeSlots[l] == edgeSlots[k]) {
+                        components[find(edges[k])] = find(edges[l]);
+                    }
+                }
+            }
+        }
+    }
+    for(int e = 0; e < 12; ++e) {
+        components[e] = find(e);
+    }
+
+    // The halves of the crossed edges of the coarser cell lie on the
+    // boundary of the face.
+    int const coarseCubeCode = coarse.resolvedCodes[getCellIndex(coarse, cell)];
+    for(int e = 0; e < 12; ++e) {
+        coarseSlots[e] = -1;
+    }
+    for(int side = 0; side < 2; ++side) {
+        for(int half = 0; half < 2; ++half) {
+            int const boundaryEdges[2] = {getFaceEdge(0, half, 2 * side), getFaceEdge(1, 2 * side, half)};
+            for(int k = 0; k < 2; ++k) {
+                if(!crossed[boundaryEdges[k]])
+                    continue;
+                int offsets[3];
+                offsets[normal] = faceOffset;
+                offsets[u] = k == 0 ? 0 : side;
+                offsets[v] = k == 0 ? side : 0;
+                int const edge = getEdgeIndex(k == 0 ? u : v, offsets[0], offsets[1], offsets[2]);
+                coarseSlots[boundaryEdges[k]] = builder.getDualPointSlot(coarseCubeCode, DMCEdgeCode(1 << edge));
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::mergeTransitionSlots(int32_t const (&b)[3], int const axis) {
+    int32_t previous[3] = {b[0], b[1], b[2]};
+    --previous[axis];
+    Brick * const upperBrick = findBrick(b[0], b[1], b[2]);
+    Brick * const lowerBrick = findBrick(previous[0], previous[1], previous[2]);
+    if(!upperBrick || !lowerBrick || upperBrick->level == lowerBrick->level)
+        return;
+    Brick & coarse = upperBrick->level > lowerBrick->level ? *upperBrick : *lowerBrick;
+    Brick const & fine = upperBrick->level > lowerBrick->level ? *lowerBrick : *upperBrick;
+    int const faceOffset = &coarse == upperBrick ? 0 : 1;
+    int const u = axis == 0 ? 1 : 0;
+    int const v = axis == 2 ? 1 : 2;
+    int32_t cell[3];
+    cell[axis] = faceOffset == 0 ? 0 : coarse.numCells[axis] - 1;
+    int32_t const endU = std::min(coarse.numCells[u], (fine.numCells[u] + 1) >> 1);
+    int32_t const endV = std::min(coarse.numCells[v], (fine.numCells[v] + 1) >> 1);
+    for(cell[v] = 0; cell[v] < endV; ++cell[v]) {
+        for(cell[u] = 0; cell[u] < endU; ++cell[u]) {
+            int components[12];
+            int coarseSlots[12];
+            traceTransitionFace(coarse, cell, axis, faceOffset, components, coarseSlots);
+
+            // Dual points of the coarser cell, whose iso lines are connected
+            // on the finer side, are merged.
+            size_t const cellIndex = getCellIndex(coarse, cell);
+            for(int e = 0; e < 12; ++e) {
+                if(coarseSlots[e] < 0)
+                    continue;
+                for(int f = 0; f < e; ++f) {
+                    if(coarseSlots[f] < 0 || components[f] != components[e])
+                        continue;
+                    int const first = findSlot(coarse, cellIndex, coarseSlots[e]);
+                    int const second = findSlot(coarse, cellIndex, coarseSlots[f]);
+                    if(first != second) {
+                        coarse.mergedSlots[cellIndex * 4 + size_t(std::max(first, second))] = std::min(first, second);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::getTransitionSlot(Brick const & coarse, int32_t const (&cell)[3], int const normal,
+  bool const coarseAbove, int32_t const (&p)[3], int const axis) {
+    int components[12];
+    int coarseSlots[12];
+    int const faceOffset = coarseAbove ? 0 : 1;
+    traceTransitionFace(coarse, cell, normal, faceOffset, components, coarseSlots);
+
+    // The edge of the coarser cell, where the iso line through the given
+    // edge ends, determines the dual point.
+    int const fineLevel = coarse.level - 1;
+    int const u = normal == 0 ? 1 : 0;
+    int32_t const offset = (p[axis] - coarse.origin[axis] - (cell[axis] << coarse.level)) >> fineLevel;
+    int const edge = axis == u ? getFaceEdge(0, offset, 1) : getFaceEdge(1, 1, offset);
+    int fallbackSlot = -1;
+    for(int e = 0; e < 12; ++e) {
+        if(coarseSlots[e] < 0)
+            continue;
+        if(components[e] == components[edge])
+            return coarseSlots[e];
+        if(fallbackSlot < 0)
+            fallbackSlot = coarseSlots[e];
+    }
+    // closed iso lines inside the face belong to any dual point of the face
+    return std::max(fallbackSlot, 0);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::findSlot(Brick const & brick, size_t const cellIndex, int slot) const {
+    for(auto merged = brick.mergedSlots.find(cellIndex * 4 + size_t(slot)); merged != brick.mergedSlots.end();
+        merged = brick.mergedSlots.find(cellIndex * 4 + size_t(slot))) {
+        slot = merged->second;
+    }
+    return slot;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::getFaceEdge(int const axis, int const i, int const j) {
+    return axis == 0 ? j * 2 + i : 6 + i * 2 + j;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+typename DualMCLod<T,IndexType>::QuadIndexType DualMCLod<T,IndexType>::getBrickPoint(
+    Brick & brick, int32_t const (&cell)[3], int const cellSlot, std::vector<Vertex> & vertices) {
+    // dual points of boundary cells may be shared with neighboring bricks
+    size_t const cellIndex = getCellIndex(brick, cell);
+    int const slot = brick.mergedSlots.empty() ? cellSlot : findSlot(brick, cellIndex, cellSlot);
+    bool const boundary =
+        cell[0] == 0 || cell[1] == 0 || cell[2] == 0 ||
+        cell[0] == brick.numCells[0] - 1 || cell[1] == brick.numCells[1] - 1 || cell[2] == brick.numCells[2] - 1;
+    QuadIndexType * sharedIndex = nullptr;
+    if(boundary) {
+        auto const inserted = brick.boundaryPoints.emplace(cellIndex * 4 + size_t(slot), QuadIndexType(vertices.size()));
+        if(!inserted.second)
+            return inserted.first->second;
+        sharedIndex = &inserted.first->second;
+    }
+
+    // compute the dual point in level voxels and move it to input voxels
+    bindBrick(brick);
+    Vertex v;
+    builder.calculateDualPoint(cell[0], cell[1], cell[2], iso, brick.resolvedCodes[cellIndex], slot, v);
+    VertexComponentsType const scale = VertexComponentsType(int32_t(1) << brick.level);
+    vertices.emplace_back(
+        VertexComponentsType(brick.origin[0]) + v.x * scale,
+        VertexComponentsType(brick.origin[1]) + v.y * scale,
+        VertexComponentsType(brick.origin[2]) + v.z * scale);
+    QuadIndexType const index = QuadIndexType(vertices.size() - 1);
+    if(sharedIndex) {
+        *sharedIndex = index;
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+void DualMCLod<T,IndexType>::bindBrick(Brick const & brick) {
+    if(boundBrick == &brick)
+        return;
+    // Only the volume members are set. The cube code caches of the builder
+    // are not used.
+    builder.data = brick.voxels;
+    for(int i = 0; i < 3; ++i) {
+        builder.dims[i] = brick.voxelDims[i];
+    }
+    builder.sliceMask = -1;
+    boundBrick = &brick;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+size_t DualMCLod<T,IndexType>::getCellIndex(Brick const & brick, int32_t const (&cell)[3]) const {
+    return size_t(cell[0]) + size_t(brick.numCells[0]) * (size_t(cell[1]) + size_t(brick.numCells[1]) * size_t(cell[2]));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int32_t DualMCLod<T,IndexType>::getNumEdgeCells(Brick const & brick, int const axis) const {
+    // cells whose first voxel is before the last two voxel layers
+    int32_t const numVoxels = std::max(0, pyramid->getDim(0, axis) - 2 - brick.origin[axis]);
+    int32_t const numCells = (numVoxels + (int32_t(1) << brick.level) - 1) >> brick.level;
+    return std::min(brick.numCells[axis], numCells);
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class IndexType> inline
+int DualMCLod<T,IndexType>::getEdgeIndex(int const axis, int const ox, int const oy, int const oz) {
+    for(int edge = 0; edge < 12; ++edge) {
+        uint8_t const * const voxel = Builder::edgeVoxels[edge];
+        if(Builder::edgeAxes[edge] == axis && voxel[0] == ox && voxel[1] == oy && voxel[2] == oz)
+            return edge;
+    }
+    return 0;
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_LOD_H_INCLUDED
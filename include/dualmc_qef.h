@@ -0,0 +1,180 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_QEF_H_INCLUDED
+#define DUALMC_QEF_H_INCLUDED
+
+/// \file   dualmc_qef.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cmath>
+
+namespace dualmc {
+
+namespace qef {
+
+/// Quadratic error function of a dual point as used by Dual Contouring of
+/// Hermite Data. Each edge intersection contributes the squared distance to
+/// the plane through the intersection point with the surface normal there.
+struct QEF {
+    /// Create an empty error function.
+    QEF();
+
+    /// Add the plane through the point p with the normal n. The normal may
+    /// be zero, in which case only the mass point is affected.
+    void add(float const (&p)[3], float const (&n)[3]);
+
+    /// Compute the point minimizing the error function. Directions, in
+    /// which the planes do not constrain the point, e.g. along a flat
+    /// surface or an edge, are taken from the mass point of the
+    /// intersection points.
+    void solve(float (&x)[3]) const;
+
+    /// upper triangle of the symmetric matrix A^T A in the order xx,xy,xz,yy,yz,zz
+    float ata[6];
+    /// A^T b
+    float atb[3];
+    /// sum of the intersection points
+    float pointSum[3];
+    /// number of intersection points
+    int numPoints;
+};
+
+/// Compute the eigenvalues and eigenvectors of a symmetric 3x3 matrix with
+/// Jacobi rotations. The eigenvectors are the columns of v.
+void computeEigenSystem(float const (&ata)[6], float (&eigenvalues)[3], float (&v)[3][3]);
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+inline
+QEF::QEF() : numPoints(0) {
+    for(int i = 0; i < 6; ++i) {
+        ata[i] = 0;
+    }
+    for(int i = 0; i < 3; ++i) {
+        atb[i] = 0;
+        pointSum[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void QEF::add(float const (&p)[3], float const (&n)[3]) {
+    ata[0] += n[0] * n[0];
+    ata[1] += n[0] * n[1];
+    ata[2] += n[0] * n[2];
+    ata[3] += n[1] * n[1];
+    ata[4] += n[1] * n[2];
+    ata[5] += n[2] * n[2];
+    float const b = n[0] * p[0] + n[1] * p[1] + n[2] * p[2];
+    for(int i = 0; i < 3; ++i) {
+        atb[i] += n[i] * b;
+        pointSum[i] += p[i];
+    }
+    ++numPoints;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void QEF::solve(float (&x)[3]) const {
+    // solve relative to the mass point, so unconstrained directions keep it
+    float massPoint[3] = {0, 0, 0};
+    if(numPoints > 0) {
+        for(int i = 0; i < 3; ++i) {
+            massPoint[i] = pointSum[i] / float(numPoints);
+        }
+    }
+    float const r[3] = {
+        atb[0] - (ata[0] * massPoint[0] + ata[1] * massPoint[1] + ata[2] * massPoint[2]),
+        atb[1] - (ata[1] * massPoint[0] + ata[3] * massPoint[1] + ata[4] * massPoint[2]),
+        atb[2] - (ata[2] * massPoint[0] + ata[4] * massPoint[1] + ata[5] * massPoint[2])
+    };
+
+    // Apply the pseudo inverse of A^T A. Small eigenvalues belong to
+    // directions, which are only weakly constrained by nearly parallel
+    // planes. Those are truncated like in Dual Contouring.
+    float eigenvalues[3];
+    float v[3][3];
+    computeEigenSystem(ata, eigenvalues, v);
+    float const maxEigenvalue = std::fmax(std::fabs(eigenvalues[0]),
+        std::fmax(std::fabs(eigenvalues[1]), std::fabs(eigenvalues[2])));
+    float const threshold = 0.1f * maxEigenvalue;
+    for(int i = 0; i < 3; ++i) {
+        x[i] = massPoint[i];
+    }
+    for(int k = 0; k < 3; ++k) {
+        if(!(std::fabs(eigenvalues[k]) > threshold))
+            continue;
+        float const projection = (v[0][k] * r[0] + v[1][k] * r[1] + v[2][k] * r[2]) / eigenvalues[k];
+        for(int i = 0; i < 3; ++i) {
+            x[i] += v[i][k] * projection;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void computeEigenSystem(float const (&ata)[6], float (&eigenvalues)[3], float (&v)[3][3]) {
+    float a[3][3] = {
+        {ata[0], ata[1], ata[2]},
+        {ata[1], ata[3], ata[4]},
+        {ata[2], ata[4], ata[5]}
+    };
+    for(int i = 0; i < 3; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            v[i][j] = i == j ? 1.0f : 0.0f;
+        }
+    }
+
+    // Cyclic Jacobi sweeps zero the off-diagonal elements one after another.
+    // A few sweeps suffice for 3x3 matrices.
+    for(int sweep = 0; sweep < 6; ++sweep) {
+        for(int p = 0; p < 2; ++p) {
+            for(int q = p + 1; q < 3; ++q) {
+                if(a[p][q] == 0.0f)
+                    continue;
+                float const theta = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+                float const t = (theta >= 0.0f ? 1.0f : -1.0f) /
+                    (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+                float const c = 1.0f / std::sqrt(t * t + 1.0f);
+                float const s = t * c;
+                // rotate rows and columns p and q of a and columns of v
+                for(int k = 0; k < 3; ++k) {
+                    float const akp = a[k][p];
+                    float const akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for(int k = 0; k < 3; ++k) {
+                    float const apk = a[p][k];
+                    float const aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for(int k = 0; k < 3; ++k) {
+                    float const vkp = v[k][p];
+                    float const vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for(int i = 0; i < 3; ++i) {
+        eigenvalues[i] = a[i][i];
+    }
+}
+
+} // END: namespace qef
+
+} // END: namespace dualmc
+#endif // DUALMC_QEF_H_INCLUDED
@@ -0,0 +1,451 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_REORDER_H_INCLUDED
+#define DUALMC_REORDER_H_INCLUDED
+
+/// \file   dualmc_reorder.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// dual mc builder vertex and quad definitions
+#include "dualmc.h"
+
+namespace dualmc {
+
+/// \class  BasicMeshOptimizer
+/// Reorders the quads and vertices of an extracted mesh for rendering.
+///
+/// The builders emit shared vertices in the order their cells are scanned,
+/// so consecutive quads of neighboring rows reference vertices far apart and
+/// the post-transform vertex cache of a GPU misses often. The optimizer
+///  1. sorts the quads along a Morton curve of their cells, which groups
+///     them into bricks of all sizes,
+///  2. reorders the quads greedily with Forsyth's linear-speed vertex cache
+///     optimization, which simulates an LRU cache and always emits the quad
+///     whose vertices score best by their cache position and the number of
+///     quads still referencing them, and
+///  3. renumbers the vertices in the order they are first referenced, so
+///     vertex fetches are mostly sequential.
+/// The Morton order is the fallback, whenever no quad references a cached
+/// vertex. Quads keep their corner order, so their orientation is unchanged.
+template<class IndexType = QuadIndexType> class BasicMeshOptimizer {
+public:
+    // typedefs
+    typedef BasicQuad<IndexType> Quad;
+
+    /// default number of simulated cache entries
+    static int constexpr DEFAULT_CACHE_SIZE = 32;
+
+    /// Constructor for the number of simulated cache entries, which is
+    /// clamped to [8,64].
+    explicit BasicMeshOptimizer(int const cacheSize = DEFAULT_CACHE_SIZE);
+
+    /// Reorder the quads and vertices of a mesh. Quad soups do not share
+    /// vertices, so only their vertex fetches benefit.
+    void optimize(std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Version of optimize, which additionally replaces the triangles with
+    /// the triangulation of the reordered quads, see triangulate.
+    void optimize(
+        std::vector<Vertex> & vertices,
+        std::vector<Quad> & quads,
+        std::vector<IndexType> & triangles
+        );
+
+    /// Split each quad along its diagonal from the first to the third corner
+    /// into two triangles with the orientation of the quad and append their
+    /// three indices each. Triangles with two equal corners are skipped.
+    static void triangulate(Quad const * quads, size_t const numQuads, std::vector<IndexType> & triangles);
+
+    /// Get the average number of cache misses per triangle, when rendering
+    /// triangles with a FIFO vertex cache of the given size. Lower is better,
+    /// meshes with shared vertices reach about 0.5 to 0.7.
+    static double getCacheMissRatio(IndexType const * triangles, size_t const numIndices, int const cacheSize);
+
+private:
+    /// maximum number of simulated cache entries
+    static int constexpr MAX_CACHE_SIZE = 64;
+
+    /// Spread the lowest 21 bits of a value to every third bit.
+    static uint64_t spreadBits(uint64_t value);
+
+    /// Sort the quads by the Morton code of the cell containing their center.
+    void sortQuadsByCell(std::vector<Vertex> const & vertices, std::vector<Quad> & quads);
+
+    /// Reorder the quads for the simulated vertex cache.
+    void reorderQuads(size_t const numVertices, std::vector<Quad> & quads);
+
+    /// Renumber the vertices by their first reference. Unreferenced vertices
+    /// are moved to the end.
+    void reorderVertices(std::vector<Vertex> & vertices, std::vector<Quad> & quads);
+
+    /// Get the number of distinct corners of a quad and store them.
+    static int getCorners(Quad const & quad, IndexType (&corners)[4]);
+
+    /// Get the score of a vertex for its cache position, -1 if it is not
+    /// cached, and the number of quads still referencing it.
+    float getVertexScore(int const cachePosition, size_t const numRemaining) const;
+
+private:
+    /// number of simulated cache entries
+    int cacheSize;
+
+    /// score of each cache position
+    float cachePositionScores[MAX_CACHE_SIZE];
+
+    /// score of small numbers of remaining quads
+    float valenceScores[16];
+
+    /// Morton codes of the quads with their index
+    std::vector<std::pair<uint64_t,size_t>> sortKeys;
+
+    /// quads in their previous order
+    std::vector<Quad> sortedQuads;
+
+    /// start of the adjacent quads of each vertex in adjacentQuads
+    std::vector<size_t> adjacencyStart;
+
+    /// adjacent quads of all vertices, the remaining ones first
+    std::vector<size_t> adjacentQuads;
+
+    /// number of quads still referencing each vertex
+    std::vector<size_t> numRemaining;
+
+    /// cache position of each vertex, -1 if it is not cached
+    std::vector<int> cachePositions;
+
+    /// current score of each vertex
+    std::vector<float> vertexScores;
+
+    /// set for quads, which have been emitted
+    std::vector<bool> emitted;
+
+    /// new index of each vertex
+    std::vector<IndexType> vertexRemap;
+
+    /// vertices in their previous order
+    std::vector<Vertex> sortedVertices;
+};
+
+/// mesh optimizer for quads with the default 32-bit vertex indices
+typedef BasicMeshOptimizer<QuadIndexType> MeshOptimizer;
+
+//------------------------------------------------------------------------------
+
+// definitions of the constants, which may be bound to references, e.g. by std::min
+template<class IndexType>
+constexpr int BasicMeshOptimizer<IndexType>::DEFAULT_CACHE_SIZE;
+
+template<class IndexType>
+constexpr int BasicMeshOptimizer<IndexType>::MAX_CACHE_SIZE;
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+BasicMeshOptimizer<IndexType>::BasicMeshOptimizer(int const cacheSize) :
+    cacheSize(std::min(MAX_CACHE_SIZE, std::max(8, cacheSize))) {
+    // Scores as proposed by Forsyth. The corners of the last quad score
+    // equally, so emitting its neighbors is preferred, the remaining cache
+    // positions decay with the distance to the cache end.
+    for(int p = 0; p < this->cacheSize; ++p) {
+        if(p < 4) {
+            cachePositionScores[p] = 0.75f;
+        } else {
+            float const distance = 1.0f - float(p - 4) / float(this->cacheSize - 4);
+            cachePositionScores[p] = std::pow(distance, 1.5f);
+        }
+    }
+    valenceScores[0] = 0.0f;
+    for(int n = 1; n < 16; ++n) {
+        valenceScores[n] = 2.0f / std::sqrt(float(n));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::optimize(std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    sortQuadsByCell(vertices, quads);
+    reorderQuads(vertices.size(), quads);
+    reorderVertices(vertices, quads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::optimize(
+  std::vector<Vertex> & vertices,
+  std::vector<Quad> & quads,
+  std::vector<IndexType> & triangles) {
+    optimize(vertices, quads);
+    triangles.clear();
+    triangles.reserve(quads.size() * 6);
+    triangulate(quads.data(), quads.size(), triangles);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::triangulate(Quad const * quads, size_t const numQuads,
+  std::vector<IndexType> & triangles) {
+    for(size_t q = 0; q < numQuads; ++q) {
+        Quad const & quad = quads[q];
+        if(quad.i0 != quad.i1 && quad.i1 != quad.i2 && quad.i0 != quad.i2) {
+            triangles.push_back(quad.i0);
+            triangles.push_back(quad.i1);
+            triangles.push_back(quad.i2);
+        }
+        if(quad.i0 != quad.i2 && quad.i2 != quad.i3 && quad.i0 != quad.i3) {
+            triangles.push_back(quad.i0);
+            triangles.push_back(quad.i2);
+            triangles.push_back(quad.i3);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+double BasicMeshOptimizer<IndexType>::getCacheMissRatio(IndexType const * triangles,
+  size_t const numIndices, int const cacheSize) {
+    size_t const numTriangles = numIndices / 3;
+    if(numTriangles == 0)
+        return 0.0;
+    IndexType const maxIndex = *std::max_element(triangles, triangles + numTriangles * 3);
+
+    // A vertex is cached, if less than cacheSize misses happened since it
+    // was loaded by its own miss.
+    std::vector<size_t> loadedAt(size_t(maxIndex) + 1, 0);
+    size_t numMisses = 0;
+    for(size_t i = 0; i < numTriangles * 3; ++i) {
+        size_t & loaded = loadedAt[triangles[i]];
+        if(loaded == 0 || numMisses - loaded >= size_t(cacheSize)) {
+            ++numMisses;
+            loaded = numMisses;
+        }
+    }
+    return double(numMisses) / double(numTriangles);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+uint64_t BasicMeshOptimizer<IndexType>::spreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffffull;
+    value = (value | value << 16) & 0x1f0000ff0000ffull;
+    value = (value | value << 8) & 0x100f00f00f00f00full;
+    value = (value | value << 4) & 0x10c30c30c30c30c3ull;
+    value = (value | value << 2) & 0x1249249249249249ull;
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::sortQuadsByCell(std::vector<Vertex> const & vertices, std::vector<Quad> & quads) {
+    if(quads.empty())
+        return;
+
+    // cells are relative to the lower corner of the bounding box, so
+    // negative coordinates are supported
+    VertexComponentsType lower[3] = {vertices[0].x, vertices[0].y, vertices[0].z};
+    for(auto const & v : vertices) {
+        lower[0] = std::min(lower[0], v.x);
+        lower[1] = std::min(lower[1], v.y);
+        lower[2] = std::min(lower[2], v.z);
+    }
+
+    sortKeys.resize(quads.size());
+    for(size_t q = 0; q < quads.size(); ++q) {
+        Quad const & quad = quads[q];
+        Vertex const & v0 = vertices[quad.i0];
+        Vertex const & v1 = vertices[quad.i1];
+        Vertex const & v2 = vertices[quad.i2];
+        Vertex const & v3 = vertices[quad.i3];
+        uint64_t const cellX = uint64_t(0.25f * (v0.x + v1.x + v2.x + v3.x) - lower[0]);
+        uint64_t const cellY = uint64_t(0.25f * (v0.y + v1.y + v2.y + v3.y) - lower[1]);
+        uint64_t const cellZ = uint64_t(0.25f * (v0.z + v1.z + v2.z + v3.z) - lower[2]);
+        sortKeys[q].first = spreadBits(cellX) | spreadBits(cellY) << 1 | spreadBits(cellZ) << 2;
+        sortKeys[q].second = q;
+    }
+    std::sort(sortKeys.begin(), sortKeys.end());
+
+    sortedQuads.swap(quads);
+    quads.resize(sortedQuads.size());
+    for(size_t q = 0; q < quads.size(); ++q) {
+        quads[q] = sortedQuads[sortKeys[q].second];
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+int BasicMeshOptimizer<IndexType>::getCorners(Quad const & quad, IndexType (&corners)[4]) {
+    IndexType const indices[4] = {quad.i0, quad.i1, quad.i2, quad.i3};
+    int numCorners = 0;
+    for(int i = 0; i < 4; ++i) {
+        if(std::find(corners, corners + numCorners, indices[i]) == corners + numCorners) {
+            corners[numCorners++] = indices[i];
+        }
+    }
+    return numCorners;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+float BasicMeshOptimizer<IndexType>::getVertexScore(int const cachePosition, size_t const numRemaining) const {
+    float const valenceScore = numRemaining < 16 ?
+        valenceScores[numRemaining] : 2.0f / std::sqrt(float(numRemaining));
+    return cachePosition < 0 ? valenceScore : cachePositionScores[cachePosition] + valenceScore;
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::reorderQuads(size_t const numVertices, std::vector<Quad> & quads) {
+    size_t const numQuads = quads.size();
+    IndexType corners[4];
+
+    // adjacent quads of each vertex
+    numRemaining.assign(numVertices, 0);
+    for(auto const & quad : quads) {
+        int const numCorners = getCorners(quad, corners);
+        for(int c = 0; c < numCorners; ++c) {
+            ++numRemaining[corners[c]];
+        }
+    }
+    adjacencyStart.resize(numVertices + 1);
+    adjacencyStart[0] = 0;
+    for(size_t v = 0; v < numVertices; ++v) {
+        adjacencyStart[v+1] = adjacencyStart[v] + numRemaining[v];
+        numRemaining[v] = 0;
+    }
+    adjacentQuads.resize(adjacencyStart[numVertices]);
+    for(size_t q = 0; q < numQuads; ++q) {
+        int const numCorners = getCorners(quads[q], corners);
+        for(int c = 0; c < numCorners; ++c) {
+            size_t const v = corners[c];
+            adjacentQuads[adjacencyStart[v] + numRemaining[v]++] = q;
+        }
+    }
+
+    cachePositions.assign(numVertices, -1);
+    vertexScores.resize(numVertices);
+    for(size_t v = 0; v < numVertices; ++v) {
+        vertexScores[v] = getVertexScore(-1, numRemaining[v]);
+    }
+    emitted.assign(numQuads, false);
+    sortedQuads.resize(numQuads);
+
+    // The cache holds the corners of the emitted quad followed by the
+    // previous entries, which are not corners of it.
+    IndexType cache[MAX_CACHE_SIZE + 4];
+    IndexType newCache[MAX_CACHE_SIZE + 4];
+    int numCached = 0;
+    size_t nextFallback = 0;
+    size_t best = numQuads;
+    for(size_t i = 0; i < numQuads; ++i) {
+        // continue in Morton order, if no quad references a cached vertex
+        if(best == numQuads) {
+            while(emitted[nextFallback])
+                ++nextFallback;
+            best = nextFallback;
+        }
+        sortedQuads[i] = quads[best];
+        emitted[best] = true;
+
+        // remove the quad from the remaining quads of its corners
+        int const numCorners = getCorners(quads[best], corners);
+        int numNewCached = 0;
+        for(int c = 0; c < numCorners; ++c) {
+            size_t const v = corners[c];
+            size_t * const adjacent = &adjacentQuads[adjacencyStart[v]];
+            size_t * const last = adjacent + --numRemaining[v];
+            std::swap(*std::find(adjacent, last, best), *last);
+            newCache[numNewCached++] = corners[c];
+        }
+        for(int c = 0; c < numCached; ++c) {
+            if(std::find(corners, corners + numCorners, cache[c]) == corners + numCorners) {
+                newCache[numNewCached++] = cache[c];
+            }
+        }
+
+        // update the scores of the cached vertices, including the ones
+        // pushed out of the cache
+        for(int c = 0; c < numNewCached; ++c) {
+            size_t const v = newCache[c];
+            int const position = c < cacheSize ? c : -1;
+            cachePositions[v] = position;
+            vertexScores[v] = getVertexScore(position, numRemaining[v]);
+        }
+        numCached = std::min(numNewCached, cacheSize);
+        for(int c = 0; c < numCached; ++c) {
+            cache[c] = newCache[c];
+        }
+
+        // select the best remaining quad referencing a cached vertex
+        best = numQuads;
+        float bestScore = -1.0f;
+        for(int c = 0; c < numCached; ++c) {
+            size_t const v = cache[c];
+            size_t const * const adjacent = &adjacentQuads[adjacencyStart[v]];
+            for(size_t a = 0; a < numRemaining[v]; ++a) {
+                size_t const q = adjacent[a];
+                int const numQuadCorners = getCorners(quads[q], corners);
+                float score = 0.0f;
+                for(int qc = 0; qc < numQuadCorners; ++qc) {
+                    score += vertexScores[corners[qc]];
+                }
+                if(score > bestScore) {
+                    bestScore = score;
+                    best = q;
+                }
+            }
+        }
+    }
+    quads.swap(sortedQuads);
+}
+
+//------------------------------------------------------------------------------
+
+template<class IndexType> inline
+void BasicMeshOptimizer<IndexType>::reorderVertices(std::vector<Vertex> & vertices, std::vector<Quad> & quads) {
+    IndexType const unassigned = IndexType(-1);
+    vertexRemap.assign(vertices.size(), unassigned);
+    IndexType numAssigned = 0;
+    for(auto & quad : quads) {
+        IndexType * const indices[4] = {&quad.i0, &quad.i1, &quad.i2, &quad.i3};
+        for(int i = 0; i < 4; ++i) {
+            IndexType & newIndex = vertexRemap[*indices[i]];
+            if(newIndex == unassigned)
+                newIndex = numAssigned++;
+            *indices[i] = newIndex;
+        }
+    }
+
+    sortedVertices.resize(vertices.size());
+    for(size_t v = 0; v < vertices.size(); ++v) {
+        if(vertexRemap[v] == unassigned)
+            vertexRemap[v] = numAssigned++;
+        sortedVertices[vertexRemap[v]] = vertices[v];
+    }
+    vertices.swap(sortedVertices);
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_REORDER_H_INCLUDED
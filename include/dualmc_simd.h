@@ -0,0 +1,518 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_SIMD_H_INCLUDED
+#define DUALMC_SIMD_H_INCLUDED
+
+/// \file   dualmc_simd.h
+/// \author Dominik Wodniok
+/// \date   2026
+/// Vectorized kernels for classifying rows of cells and finding their
+/// crossed edges. The classification kernels exist for uint8_t, uint16_t,
+/// and float volumes. All other volume types and the remainder of rows are
+/// handled by the scalar code in DualMC.
+///
+/// SSE2 and NEON are used whenever the compiler targets them. AVX2 is
+/// selected at runtime if the CPU supports it (GCC and Clang only).
+/// Defining DUALMC_NO_SIMD disables all kernels and DUALMC_NO_AVX2 disables
+/// the AVX2 kernels.
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(DUALMC_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DUALMC_SIMD_SSE2
+#    include <emmintrin.h>
+#    if !defined(DUALMC_NO_AVX2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#      define DUALMC_SIMD_AVX2
+#      include <immintrin.h>
+#    endif
+#  elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define DUALMC_SIMD_NEON
+#    include <arm_neon.h>
+#  endif
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace dualmc {
+namespace simd {
+
+/// Compute the cube codes for the first cells of a row of cells given by the
+/// four voxel rows at (y,z), (y+1,z), (y,z+1), and (y+1,z+1). Each voxel row
+/// has to provide numCells+1 values.
+/// Returns the number of classified cells. The remaining cells have to be
+/// classified by the caller. The generic version does not classify any cell.
+template<class T>
+int32_t classifyCellRow(
+    T const * row00, T const * row10, T const * row01, T const * row11,
+    int32_t const numCells, T const iso, uint8_t * codes);
+
+#if defined(DUALMC_SIMD_SSE2) || defined(DUALMC_SIMD_NEON)
+/// Overload for 8-bit volumes.
+int32_t classifyCellRow(
+    uint8_t const * row00, uint8_t const * row10, uint8_t const * row01, uint8_t const * row11,
+    int32_t const numCells, uint8_t const iso, uint8_t * codes);
+
+/// Overload for 16-bit volumes.
+int32_t classifyCellRow(
+    uint16_t const * row00, uint16_t const * row10, uint16_t const * row01, uint16_t const * row11,
+    int32_t const numCells, uint16_t const iso, uint8_t * codes);
+
+/// Overload for float volumes.
+int32_t classifyCellRow(
+    float const * row00, float const * row10, float const * row01, float const * row11,
+    int32_t const numCells, float const iso, uint8_t * codes);
+#endif
+
+/// Find the first cell in [begin,end) of a row of cube codes, for which at
+/// least one of the x, y, or z edges starting at the cell's first corner are
+/// intersected by the iso surface. Returns end if there is no such cell.
+int32_t findActiveCell(uint8_t const * codes, int32_t const begin, int32_t const end);
+
+/// Write the crossed edges starting at the first corners of the cells
+/// [begin,end) of a row of cube codes to edges and return their number.
+/// Only edges along the selected axes are written, bit i of axes selects
+/// axis i. An edge is stored as x*8 + inside*4 + axis, where inside is the
+/// classification of its first corner. edges has to provide space for three
+/// values per cell. Blocks of cells without crossed edges are skipped with
+/// findActiveCell, the cells of the other blocks are compacted without
+/// branches.
+size_t compactCrossedEdges(uint8_t const * codes, int32_t const begin, int32_t const end,
+  uint32_t const axes, uint32_t * edges);
+
+// inline function definitions
+
+namespace detail {
+
+/// cube code bits of the first corner and its x, y, and z neighbors
+constexpr uint8_t EDGE_CORNERS = 1 | 2 | 4 | 16;
+
+/// index of the lowest set bit of a non-zero mask
+inline int32_t lowestBit(uint32_t const mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int32_t(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/// branch-free compaction of the crossed edges of cells, see
+/// compactCrossedEdges. Returns the end of the written edges.
+inline uint32_t * compactCrossedEdgesScalar(uint8_t const * codes, int32_t const begin, int32_t const end,
+  uint32_t const axes, uint32_t * edges) {
+    uint32_t const axisX = axes & 1;
+    uint32_t const axisY = (axes >> 1) & 1;
+    uint32_t const axisZ = (axes >> 2) & 1;
+    for(int32_t cx = begin; cx < end; ++cx) {
+        uint32_t const code = codes[cx];
+        uint32_t const edge = uint32_t(cx) * 8 + (code & 1) * 4;
+        // The slot after the last edge is always written, but only kept
+        // if the edge is crossed.
+        *edges = edge;
+        edges += ((code ^ (code >> 1)) & axisX);
+        *edges = edge + 1;
+        edges += ((code ^ (code >> 2)) & axisY);
+        *edges = edge + 2;
+        edges += ((code ^ (code >> 4)) & axisZ);
+    }
+    return edges;
+}
+
+/// scalar search for active cells
+inline int32_t findActiveCellScalar(uint8_t const * codes, int32_t begin, int32_t const end) {
+    for(; begin < end; ++begin) {
+        uint8_t const edgeCorners = codes[begin] & EDGE_CORNERS;
+        if(edgeCorners != 0 && edgeCorners != EDGE_CORNERS)
+            break;
+    }
+    return begin;
+}
+
+#if defined(DUALMC_SIMD_SSE2)
+
+//------------------------------------------------------------------------------
+// SSE2 kernels
+
+/// Combine the in/out masks of 16 cells and their x neighbors for the four
+/// voxel rows into cube codes.
+inline __m128i combineCornersSSE2(
+    __m128i const m00, __m128i const m00x, __m128i const m10, __m128i const m10x,
+    __m128i const m01, __m128i const m01x, __m128i const m11, __m128i const m11x) {
+    __m128i code = _mm_and_si128(m00, _mm_set1_epi8(1));
+    code = _mm_or_si128(code, _mm_and_si128(m00x, _mm_set1_epi8(2)));
+    code = _mm_or_si128(code, _mm_and_si128(m10, _mm_set1_epi8(4)));
+    code = _mm_or_si128(code, _mm_and_si128(m10x, _mm_set1_epi8(8)));
+    code = _mm_or_si128(code, _mm_and_si128(m01, _mm_set1_epi8(16)));
+    code = _mm_or_si128(code, _mm_and_si128(m01x, _mm_set1_epi8(32)));
+    code = _mm_or_si128(code, _mm_and_si128(m11, _mm_set1_epi8(64)));
+    code = _mm_or_si128(code, _mm_and_si128(m11x, _mm_set1_epi8(char(128))));
+    return code;
+}
+
+/// byte masks of v >= iso for 16 consecutive 8-bit values
+inline __m128i insideMaskSSE2(uint8_t const * p, __m128i const iso) {
+    __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+    // saturated iso - v is zero exactly if v >= iso
+    return _mm_cmpeq_epi8(_mm_subs_epu8(iso, v), _mm_setzero_si128());
+}
+
+/// byte masks of v >= iso for 16 consecutive 16-bit values
+inline __m128i insideMaskSSE2(uint16_t const * p, __m128i const iso) {
+    __m128i const v0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+    __m128i const v1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 8));
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const m0 = _mm_cmpeq_epi16(_mm_subs_epu16(iso, v0), zero);
+    __m128i const m1 = _mm_cmpeq_epi16(_mm_subs_epu16(iso, v1), zero);
+    return _mm_packs_epi16(m0, m1);
+}
+
+/// byte masks of v >= iso for 16 consecutive float values
+inline __m128i insideMaskSSE2(float const * p, __m128 const iso) {
+    __m128i const m0 = _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(p), iso));
+    __m128i const m1 = _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(p + 4), iso));
+    __m128i const m2 = _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(p + 8), iso));
+    __m128i const m3 = _mm_castps_si128(_mm_cmpge_ps(_mm_loadu_ps(p + 12), iso));
+    return _mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3));
+}
+
+/// classify cells in blocks of 16
+template<class T, class IsoVector>
+inline int32_t classifyCellRowSSE2(
+    T const * row00, T const * row10, T const * row01, T const * row11,
+    int32_t const numCells, IsoVector const iso, uint8_t * codes) {
+    int32_t cx = 0;
+    for(; cx + 16 <= numCells; cx += 16) {
+        __m128i const code = combineCornersSSE2(
+            insideMaskSSE2(row00 + cx, iso), insideMaskSSE2(row00 + cx + 1, iso),
+            insideMaskSSE2(row10 + cx, iso), insideMaskSSE2(row10 + cx + 1, iso),
+            insideMaskSSE2(row01 + cx, iso), insideMaskSSE2(row01 + cx + 1, iso),
+            insideMaskSSE2(row11 + cx, iso), insideMaskSSE2(row11 + cx + 1, iso));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(codes + cx), code);
+    }
+    return cx;
+}
+
+/// search active cells in blocks of 16
+inline int32_t findActiveCellSSE2(uint8_t const * codes, int32_t begin, int32_t const end) {
+    __m128i const edgeCorners = _mm_set1_epi8(EDGE_CORNERS);
+    for(; begin + 16 <= end; begin += 16) {
+        __m128i const c = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(codes + begin)), edgeCorners);
+        __m128i const inactive = _mm_or_si128(
+            _mm_cmpeq_epi8(c, _mm_setzero_si128()),
+            _mm_cmpeq_epi8(c, edgeCorners));
+        uint32_t const active = uint32_t(_mm_movemask_epi8(inactive)) ^ 0xffffu;
+        if(active != 0)
+            return begin + lowestBit(active);
+    }
+    return findActiveCellScalar(codes, begin, end);
+}
+
+#endif // DUALMC_SIMD_SSE2
+
+#if defined(DUALMC_SIMD_AVX2)
+
+//------------------------------------------------------------------------------
+// AVX2 kernels
+
+/// Check once whether the CPU supports AVX2.
+inline bool hasAVX2() {
+    static bool const supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+}
+
+/// Combine the in/out masks of 32 cells and their x neighbors for the four
+/// voxel rows into cube codes.
+__attribute__((target("avx2")))
+inline __m256i combineCornersAVX2(
+    __m256i const m00, __m256i const m00x, __m256i const m10, __m256i const m10x,
+    __m256i const m01, __m256i const m01x, __m256i const m11, __m256i const m11x) {
+    __m256i code = _mm256_and_si256(m00, _mm256_set1_epi8(1));
+    code = _mm256_or_si256(code, _mm256_and_si256(m00x, _mm256_set1_epi8(2)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m10, _mm256_set1_epi8(4)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m10x, _mm256_set1_epi8(8)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m01, _mm256_set1_epi8(16)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m01x, _mm256_set1_epi8(32)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m11, _mm256_set1_epi8(64)));
+    code = _mm256_or_si256(code, _mm256_and_si256(m11x, _mm256_set1_epi8(char(128))));
+    return code;
+}
+
+/// byte masks of v >= iso for 32 consecutive 8-bit values
+__attribute__((target("avx2")))
+inline __m256i insideMaskAVX2(uint8_t const * p, __m256i const iso) {
+    __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+    return _mm256_cmpeq_epi8(_mm256_subs_epu8(iso, v), _mm256_setzero_si256());
+}
+
+/// byte masks of v >= iso for 32 consecutive 16-bit values
+__attribute__((target("avx2")))
+inline __m256i insideMaskAVX2(uint16_t const * p, __m256i const iso) {
+    __m256i const v0 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+    __m256i const v1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p + 16));
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const m0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(iso, v0), zero);
+    __m256i const m1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(iso, v1), zero);
+    // packing works per 128-bit lane, restore the order of the 64-bit blocks
+    return _mm256_permute4x64_epi64(_mm256_packs_epi16(m0, m1), 0xd8);
+}
+
+/// byte masks of v >= iso for 32 consecutive float values
+__attribute__((target("avx2")))
+inline __m256i insideMaskAVX2(float const * p, __m256 const iso) {
+    __m256i const m0 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p), iso, _CMP_GE_OQ));
+    __m256i const m1 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p + 8), iso, _CMP_GE_OQ));
+    __m256i const m2 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p + 16), iso, _CMP_GE_OQ));
+    __m256i const m3 = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(p + 24), iso, _CMP_GE_OQ));
+    __m256i const packed = _mm256_packs_epi16(_mm256_packs_epi32(m0, m1), _mm256_packs_epi32(m2, m3));
+    // packing works per 128-bit lane, restore the order of the 32-bit blocks
+    return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+/// classify cells in blocks of 32
+template<class T, class IsoVector>
+__attribute__((target("avx2")))
+inline int32_t classifyCellRowAVX2(
+    T const * row00, T const * row10, T const * row01, T const * row11,
+    int32_t const numCells, IsoVector const iso, uint8_t * codes) {
+    int32_t cx = 0;
+    for(; cx + 32 <= numCells; cx += 32) {
+        __m256i const code = combineCornersAVX2(
+            insideMaskAVX2(row00 + cx, iso), insideMaskAVX2(row00 + cx + 1, iso),
+            insideMaskAVX2(row10 + cx, iso), insideMaskAVX2(row10 + cx + 1, iso),
+            insideMaskAVX2(row01 + cx, iso), insideMaskAVX2(row01 + cx + 1, iso),
+            insideMaskAVX2(row11 + cx, iso), insideMaskAVX2(row11 + cx + 1, iso));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(codes + cx), code);
+    }
+    return cx;
+}
+
+/// search active cells in blocks of 32
+__attribute__((target("avx2")))
+inline int32_t findActiveCellAVX2(uint8_t const * codes, int32_t begin, int32_t const end) {
+    __m256i const edgeCorners = _mm256_set1_epi8(EDGE_CORNERS);
+    for(; begin + 32 <= end; begin += 32) {
+        __m256i const c = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(codes + begin)), edgeCorners);
+        __m256i const inactive = _mm256_or_si256(
+            _mm256_cmpeq_epi8(c, _mm256_setzero_si256()),
+            _mm256_cmpeq_epi8(c, edgeCorners));
+        uint32_t const active = ~uint32_t(_mm256_movemask_epi8(inactive));
+        if(active != 0)
+            return begin + lowestBit(active);
+    }
+    return findActiveCellSSE2(codes, begin, end);
+}
+
+__attribute__((target("avx2")))
+inline int32_t classifyCellRowAVX2(
+    uint8_t const * row00, uint8_t const * row10, uint8_t const * row01, uint8_t const * row11,
+    int32_t const numCells, uint8_t const iso, uint8_t * codes) {
+    return classifyCellRowAVX2(row00, row10, row01, row11, numCells, _mm256_set1_epi8(char(iso)), codes);
+}
+
+__attribute__((target("avx2")))
+inline int32_t classifyCellRowAVX2(
+    uint16_t const * row00, uint16_t const * row10, uint16_t const * row01, uint16_t const * row11,
+    int32_t const numCells, uint16_t const iso, uint8_t * codes) {
+    return classifyCellRowAVX2(row00, row10, row01, row11, numCells, _mm256_set1_epi16(short(iso)), codes);
+}
+
+__attribute__((target("avx2")))
+inline int32_t classifyCellRowAVX2(
+    float const * row00, float const * row10, float const * row01, float const * row11,
+    int32_t const numCells, float const iso, uint8_t * codes) {
+    return classifyCellRowAVX2(row00, row10, row01, row11, numCells, _mm256_set1_ps(iso), codes);
+}
+
+#endif // DUALMC_SIMD_AVX2
+
+#if defined(DUALMC_SIMD_NEON)
+
+//------------------------------------------------------------------------------
+// NEON kernels
+
+/// Combine the in/out masks of 16 cells and their x neighbors for the four
+/// voxel rows into cube codes.
+inline uint8x16_t combineCornersNEON(
+    uint8x16_t const m00, uint8x16_t const m00x, uint8x16_t const m10, uint8x16_t const m10x,
+    uint8x16_t const m01, uint8x16_t const m01x, uint8x16_t const m11, uint8x16_t const m11x) {
+    uint8x16_t code = vandq_u8(m00, vdupq_n_u8(1));
+    code = vorrq_u8(code, vandq_u8(m00x, vdupq_n_u8(2)));
+    code = vorrq_u8(code, vandq_u8(m10, vdupq_n_u8(4)));
+    code = vorrq_u8(code, vandq_u8(m10x, vdupq_n_u8(8)));
+    code = vorrq_u8(code, vandq_u8(m01, vdupq_n_u8(16)));
+    code = vorrq_u8(code, vandq_u8(m01x, vdupq_n_u8(32)));
+    code = vorrq_u8(code, vandq_u8(m11, vdupq_n_u8(64)));
+    code = vorrq_u8(code, vandq_u8(m11x, vdupq_n_u8(128)));
+    return code;
+}
+
+/// byte masks of v >= iso for 16 consecutive 8-bit values
+inline uint8x16_t insideMaskNEON(uint8_t const * p, uint8_t const iso) {
+    return vcgeq_u8(vld1q_u8(p), vdupq_n_u8(iso));
+}
+
+/// byte masks of v >= iso for 16 consecutive 16-bit values
+inline uint8x16_t insideMaskNEON(uint16_t const * p, uint16_t const iso) {
+    uint16x8_t const isoVector = vdupq_n_u16(iso);
+    uint16x8_t const m0 = vcgeq_u16(vld1q_u16(p), isoVector);
+    uint16x8_t const m1 = vcgeq_u16(vld1q_u16(p + 8), isoVector);
+    return vcombine_u8(vmovn_u16(m0), vmovn_u16(m1));
+}
+
+/// byte masks of v >= iso for 16 consecutive float values
+inline uint8x16_t insideMaskNEON(float const * p, float const iso) {
+    float32x4_t const isoVector = vdupq_n_f32(iso);
+    uint32x4_t const m0 = vcgeq_f32(vld1q_f32(p), isoVector);
+    uint32x4_t const m1 = vcgeq_f32(vld1q_f32(p + 4), isoVector);
+    uint32x4_t const m2 = vcgeq_f32(vld1q_f32(p + 8), isoVector);
+    uint32x4_t const m3 = vcgeq_f32(vld1q_f32(p + 12), isoVector);
+    uint16x8_t const m01 = vcombine_u16(vmovn_u32(m0), vmovn_u32(m1));
+    uint16x8_t const m23 = vcombine_u16(vmovn_u32(m2), vmovn_u32(m3));
+    return vcombine_u8(vmovn_u16(m01), vmovn_u16(m23));
+}
+
+/// classify cells in blocks of 16
+template<class T>
+inline int32_t classifyCellRowNEON(
+    T const * row00, T const * row10, T const * row01, T const * row11,
+    int32_t const numCells, T const iso, uint8_t * codes) {
+    int32_t cx = 0;
+    for(; cx + 16 <= numCells; cx += 16) {
+        uint8x16_t const code = combineCornersNEON(
+            insideMaskNEON(row00 + cx, iso), insideMaskNEON(row00 + cx + 1, iso),
+            insideMaskNEON(row10 + cx, iso), insideMaskNEON(row10 + cx + 1, iso),
+            insideMaskNEON(row01 + cx, iso), insideMaskNEON(row01 + cx + 1, iso),
+            insideMaskNEON(row11 + cx, iso), insideMaskNEON(row11 + cx + 1, iso));
+        vst1q_u8(codes + cx, code);
+    }
+    return cx;
+}
+
+/// search active cells in blocks of 16
+inline int32_t findActiveCellNEON(uint8_t const * codes, int32_t begin, int32_t const end) {
+    uint8x16_t const edgeCorners = vdupq_n_u8(EDGE_CORNERS);
+    for(; begin + 16 <= end; begin += 16) {
+        uint8x16_t const c = vandq_u8(vld1q_u8(codes + begin), edgeCorners);
+        uint8x16_t const inactive = vorrq_u8(vceqq_u8(c, vdupq_n_u8(0)), vceqq_u8(c, edgeCorners));
+        // check if any of the 16 cells is active before searching it
+        uint8x8_t const folded = vand_u8(vget_low_u8(inactive), vget_high_u8(inactive));
+        if(vget_lane_u64(vreinterpret_u64_u8(folded), 0) != ~uint64_t(0))
+            return findActiveCellScalar(codes, begin, begin + 16);
+    }
+    return findActiveCellScalar(codes, begin, end);
+}
+
+#endif // DUALMC_SIMD_NEON
+
+} // END: namespace detail
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t classifyCellRow(
+    T const *, T const *, T const *, T const *,
+    int32_t const, T const, uint8_t *) {
+    // no kernel for this volume type
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+#if defined(DUALMC_SIMD_SSE2) || defined(DUALMC_SIMD_NEON)
+
+inline
+int32_t classifyCellRow(
+    uint8_t const * row00, uint8_t const * row10, uint8_t const * row01, uint8_t const * row11,
+    int32_t const numCells, uint8_t const iso, uint8_t * codes) {
+#if defined(DUALMC_SIMD_AVX2)
+    if(detail::hasAVX2())
+        return detail::classifyCellRowAVX2(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+#if defined(DUALMC_SIMD_SSE2)
+    return detail::classifyCellRowSSE2(row00, row10, row01, row11, numCells, _mm_set1_epi8(char(iso)), codes);
+#else
+    return detail::classifyCellRowNEON(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+inline
+int32_t classifyCellRow(
+    uint16_t const * row00, uint16_t const * row10, uint16_t const * row01, uint16_t const * row11,
+    int32_t const numCells, uint16_t const iso, uint8_t * codes) {
+#if defined(DUALMC_SIMD_AVX2)
+    if(detail::hasAVX2())
+        return detail::classifyCellRowAVX2(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+#if defined(DUALMC_SIMD_SSE2)
+    return detail::classifyCellRowSSE2(row00, row10, row01, row11, numCells, _mm_set1_epi16(short(iso)), codes);
+#else
+    return detail::classifyCellRowNEON(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+inline
+int32_t classifyCellRow(
+    float const * row00, float const * row10, float const * row01, float const * row11,
+    int32_t const numCells, float const iso, uint8_t * codes) {
+#if defined(DUALMC_SIMD_AVX2)
+    if(detail::hasAVX2())
+        return detail::classifyCellRowAVX2(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+#if defined(DUALMC_SIMD_SSE2)
+    return detail::classifyCellRowSSE2(row00, row10, row01, row11, numCells, _mm_set1_ps(iso), codes);
+#else
+    return detail::classifyCellRowNEON(row00, row10, row01, row11, numCells, iso, codes);
+#endif
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+inline
+int32_t findActiveCell(uint8_t const * codes, int32_t const begin, int32_t const end) {
+#if defined(DUALMC_SIMD_AVX2)
+    if(detail::hasAVX2())
+        return detail::findActiveCellAVX2(codes, begin, end);
+#endif
+#if defined(DUALMC_SIMD_SSE2)
+    return detail::findActiveCellSSE2(codes, begin, end);
+#elif defined(DUALMC_SIMD_NEON)
+    return detail::findActiveCellNEON(codes, begin, end);
+#else
+    return detail::findActiveCellScalar(codes, begin, end);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+inline
+size_t compactCrossedEdges(uint8_t const * codes, int32_t const begin, int32_t const end,
+  uint32_t const axes, uint32_t * edges) {
+    // blocks of the size of the widest search kernel
+    int32_t constexpr blockSize = 32;
+    uint32_t * last = edges;
+    for(int32_t cx = findActiveCell(codes, begin, end); cx < end; cx = findActiveCell(codes, cx, end)) {
+        int32_t const blockEnd = end - cx > blockSize ? cx + blockSize : end;
+        last = detail::compactCrossedEdgesScalar(codes, cx, blockEnd, axes, last);
+        cx = blockEnd;
+    }
+    return size_t(last - edges);
+}
+
+} // END: namespace simd
+} // END: namespace dualmc
+#endif // DUALMC_SIMD_H_INCLUDED
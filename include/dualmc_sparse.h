@@ -0,0 +1,211 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_SPARSE_H_INCLUDED
+#define DUALMC_SPARSE_H_INCLUDED
+
+/// \file   dualmc_sparse.h
+/// \author Dominik Wodniok
+/// \date   2026
+
+// c includes
+#include <cstddef>
+#include <cstdint>
+
+// stl includes
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace dualmc {
+
+/// \class  SparseVolume
+/// Sparse volume made from cubic bricks of voxels. Only bricks containing
+/// data are allocated, all other voxels have a constant background value.
+///
+/// DualMC::buildSparse accepts any type with the same volume accessors:
+///  - int32_t getBrickSize() const, the number of voxels along each axis
+///    of a brick
+///  - VolumeDataType getBackground() const
+///  - VolumeDataType const * getBrick(int32_t bx, int32_t by, int32_t bz) const,
+///    the brickSize^3 voxels of the brick with the coordinates (bx,by,bz)
+///    stored in x,y,z order, or nullptr for absent bricks
+/// Voxels of bricks outside of the volume extent are ignored, so adapters of
+/// other sparse grids, e.g. VDB leaf nodes, can return their bricks as they are.
+template<class T> class SparseVolume {
+public:
+    // typedefs
+    typedef T VolumeDataType;
+
+    /// Default constructor. Creates an empty volume.
+    SparseVolume();
+
+    /// Initialize a volume without allocated bricks.
+    void initialize(
+        int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+        int32_t const brickSize = 8,
+        VolumeDataType const background = VolumeDataType()
+        );
+
+    /// Get the number of voxels along each axis of a brick.
+    int32_t getBrickSize() const;
+
+    /// Get the value of all voxels outside of allocated bricks.
+    VolumeDataType getBackground() const;
+
+    /// Get the number of bricks along the given axis.
+    int32_t getNumBricks(int const axis) const;
+
+    /// Get the number of allocated bricks.
+    size_t getNumAllocatedBricks() const;
+
+    /// Get the voxels of a brick or nullptr if it is not allocated.
+    VolumeDataType const * getBrick(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+    /// Get the voxels of a brick. Bricks are allocated on first access and
+    /// filled with the background value. Allocating a brick invalidates the
+    /// pointers to the voxels of all other bricks.
+    VolumeDataType * allocateBrick(int32_t const bx, int32_t const by, int32_t const bz);
+
+    /// Get the value of a voxel.
+    VolumeDataType getVoxel(int32_t const x, int32_t const y, int32_t const z) const;
+
+    /// Set the value of a voxel. Allocates the brick of the voxel.
+    void setVoxel(int32_t const x, int32_t const y, int32_t const z, VolumeDataType const value);
+
+private:
+
+    /// Compute a linearized brick index.
+    size_t gB(int32_t const bx, int32_t const by, int32_t const bz) const;
+
+    /// Compute the index of a voxel in its brick.
+    size_t gV(int32_t const x, int32_t const y, int32_t const z) const;
+
+private:
+
+    /// number of voxels along each axis of a brick
+    int32_t brickSize;
+
+    /// number of bricks for x-,y-, and z-dimension
+    int32_t numBricks[3];
+
+    /// value of voxels outside of allocated bricks
+    VolumeDataType background;
+
+    /// offset of the voxels of each allocated brick by linearized brick index
+    std::unordered_map<size_t, size_t> brickOffsets;
+
+    /// voxels of all allocated bricks
+    std::vector<VolumeDataType> voxels;
+};
+
+// inline function definitions
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+SparseVolume<T>::SparseVolume() : brickSize(1), background() {
+    for(int i = 0; i < 3; ++i) {
+        numBricks[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void SparseVolume<T>::initialize(
+    int32_t const dimX, int32_t const dimY, int32_t const dimZ,
+    int32_t const brickSize,
+    VolumeDataType const background
+    ) {
+    this->brickSize = std::max<int32_t>(1, brickSize);
+    this->background = background;
+    int32_t const dims[3] = {dimX, dimY, dimZ};
+    for(int i = 0; i < 3; ++i) {
+        numBricks[i] = (std::max(0, dims[i]) + this->brickSize - 1) / this->brickSize;
+    }
+    brickOffsets.clear();
+    voxels.clear();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t SparseVolume<T>::getBrickSize() const {
+    return brickSize;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T SparseVolume<T>::getBackground() const {
+    return background;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+int32_t SparseVolume<T>::getNumBricks(int const axis) const {
+    return numBricks[axis];
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+size_t SparseVolume<T>::getNumAllocatedBricks() const {
+    return brickOffsets.size();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T const * SparseVolume<T>::getBrick(int32_t const bx, int32_t const by, int32_t const bz) const {
+    auto const iterator = brickOffsets.find(gB(bx, by, bz));
+    return iterator != brickOffsets.end() ? voxels.data() + iterator->second : nullptr;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T * SparseVolume<T>::allocateBrick(int32_t const bx, int32_t const by, int32_t const bz) {
+    auto const inserted = brickOffsets.emplace(gB(bx, by, bz), voxels.size());
+    if(inserted.second) {
+        size_t const brickVolume = size_t(brickSize) * size_t(brickSize) * size_t(brickSize);
+        voxels.resize(voxels.size() + brickVolume, background);
+    }
+    return voxels.data() + inserted.first->second;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+T SparseVolume<T>::getVoxel(int32_t const x, int32_t const y, int32_t const z) const {
+    VolumeDataType const * const brick = getBrick(x / brickSize, y / brickSize, z / brickSize);
+    return brick ? brick[gV(x, y, z)] : background;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+void SparseVolume<T>::setVoxel(int32_t const x, int32_t const y, int32_t const z, VolumeDataType const value) {
+    allocateBrick(x / brickSize, y / brickSize, z / brickSize)[gV(x, y, z)] = value;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+size_t SparseVolume<T>::gB(int32_t const bx, int32_t const by, int32_t const bz) const {
+    return size_t(bx) + size_t(numBricks[0]) * (size_t(by) + size_t(numBricks[1]) * size_t(bz));
+}
+
+//------------------------------------------------------------------------------
+
+template<class T> inline
+size_t SparseVolume<T>::gV(int32_t const x, int32_t const y, int32_t const z) const {
+    return size_t(x % brickSize) + size_t(brickSize) * (size_t(y % brickSize) + size_t(brickSize) * size_t(z % brickSize));
+}
+
+} // END: namespace dualmc
+#endif // DUALMC_SPARSE_H_INCLUDED
@@ -0,0 +1,351 @@
+// Copyright (C) 2017, Dominik Wodniok
+// This software may be modified and distributed under the terms
+// of the BSD 3-Clause license.
+// See the LICENSE.txt file for details.
+
+#ifndef DUALMC_TABLES_H_INCLUDED
+#define DUALMC_TABLES_H_INCLUDED
+
+/// \file   dualmc_tables.h
+/// \author Dominik Wodniok
+/// \date   2026
+///
+/// Compile time generation of the dual marching cubes lookup tables. The
+/// functions are constexpr ports of generateDualMCTable and
+/// generateManifoldTable of the gentables application. Corners, edges, and
+/// directions are numbered like in dualmc_tables.tpp.
+
+// c includes
+#include <cstdint>
+
+namespace dualmc {
+
+namespace tables {
+
+/// sequence of integers for expanding tables at compile time
+template<int... Values>
+struct IntegerSequence {};
+
+/// Generate the integer sequence 0,...,N-1.
+template<int N, int... Values>
+struct MakeIntegerSequence : MakeIntegerSequence<N-1, N-1, Values...> {};
+
+template<int... Values>
+struct MakeIntegerSequence<0, Values...> {
+    typedef IntegerSequence<Values...> Type;
+};
+
+/// the 256 cube codes
+typedef MakeIntegerSequence<256>::Type CubeCodes;
+
+//------------------------------------------------------------------------------
+// Dual marching cubes table
+
+/// Get the corners, which share an edge with any of the given corners.
+/// Corners differing in one bit of their Morton code are neighbors.
+constexpr uint32_t getAdjacentCorners(uint32_t const corners) {
+    return ((corners & 0x55u) << 1) | ((corners & 0xaau) >> 1) |
+           ((corners & 0x33u) << 2) | ((corners & 0xccu) >> 2) |
+           ((corners & 0x0fu) << 4) | ((corners & 0xf0u) >> 4);
+}
+
+/// Grow the given corners by their adjacent inside corners until the
+/// connected component of inside corners is complete.
+constexpr uint32_t getConnectedCorners(uint32_t const inside, uint32_t const corners) {
+    return (corners | (getAdjacentCorners(corners) & inside)) == corners ? corners :
+        getConnectedCorners(inside, corners | (getAdjacentCorners(corners) & inside));
+}
+
+/// Get the lowest corner of a non-empty corner mask.
+constexpr int getLowestCorner(uint32_t const corners) {
+    return (corners & 1u) ? 0 : 1 + getLowestCorner(corners >> 1);
+}
+
+/// Get the edge code of the edge of a corner along the given axis.
+constexpr uint32_t getCornerEdge(int const corner, int const axis) {
+    return axis == 0 ? 1u << (((corner >> 1) & 1) * 4 + ((corner >> 2) & 1) * 2) :
+           axis == 1 ? 1u << (8 + ((corner >> 2) & 1) * 2 + ((corner ^ (corner >> 2)) & 1)) :
+                       1u << (3 - (corner & 1) * 2 + ((corner >> 1) & 1) * 4);
+}
+
+/// Get the edges of an inside corner leading to outside corners.
+constexpr uint32_t getBoundaryEdges(uint32_t const inside, int const corner) {
+    return (((inside >> (corner ^ 1)) & 1u) ? 0u : getCornerEdge(corner, 0)) |
+           (((inside >> (corner ^ 2)) & 1u) ? 0u : getCornerEdge(corner, 1)) |
+           (((inside >> (corner ^ 4)) & 1u) ? 0u : getCornerEdge(corner, 2));
+}
+
+/// Get the crossed edges of the surface patch enclosing the given corners.
+constexpr uint32_t getPatchEdges(uint32_t const inside, uint32_t const corners, int const corner = 0) {
+    return corner == 8 ? 0u :
+        (((corners >> corner) & 1u) ? getBoundaryEdges(inside, corner) : 0u) |
+        getPatchEdges(inside, corners, corner + 1);
+}
+
+/// Get the connected component of remaining inside corners, which encloses
+/// the surface patch of the given slot. Components are ordered by their
+/// lowest corner.
+constexpr uint32_t getPatchCorners(uint32_t const inside, uint32_t const remaining, int const slot) {
+    return remaining == 0 ? 0u :
+        slot == 0 ? getConnectedCorners(inside, 1u << getLowestCorner(remaining)) :
+        getPatchCorners(inside, remaining & ~getConnectedCorners(inside, 1u << getLowestCorner(remaining)), slot - 1);
+}
+
+/// Get the corners whose connected components define the surface patches of
+/// a cube. Like in gentables, the outside corners are used for the four
+/// configurations, whose two inside corners are diagonally opposite.
+constexpr uint32_t getPatchInsideCorners(int const cube) {
+    return cube == 126 || cube == 189 || cube == 219 || cube == 231 ?
+        uint32_t(cube) ^ 0xffu : uint32_t(cube);
+}
+
+/// Get the dual point code of a slot of a cube, which is the edge code mask
+/// of the crossed edges of its surface patch. Unused slots are 0.
+constexpr int32_t getDualPointCode(int const cube, int const slot) {
+    return int32_t(getPatchEdges(getPatchInsideCorners(cube),
+        getPatchCorners(getPatchInsideCorners(cube), getPatchInsideCorners(cube), slot)));
+}
+
+//------------------------------------------------------------------------------
+// Manifold dual marching cubes table
+
+/// Rotate a cube configuration by 90 degrees around the x axis.
+constexpr uint32_t rotateConfigX(uint32_t const c) {
+    return ((c & 3u) << 2) | ((c & 12u) << 4) | ((c & 48u) >> 4) | ((c & 192u) >> 2);
+}
+
+/// Rotate a cube configuration by 90 degrees around the y axis.
+constexpr uint32_t rotateConfigY(uint32_t const c) {
+    return ((c & 5u) << 4) | ((c & 10u) >> 1) | ((c & 80u) << 1) | ((c & 160u) >> 4);
+}
+
+/// Rotate a cube configuration by 90 degrees around the z axis.
+constexpr uint32_t rotateConfigZ(uint32_t const c) {
+    return ((c & 17u) << 1) | ((c & 34u) << 2) | ((c & 68u) >> 2) | ((c & 136u) >> 1);
+}
+
+/// Rotate a cube configuration n times around the given axis.
+constexpr uint32_t rotateConfig(uint32_t const c, int const axis, int const n) {
+    return n == 0 ? c : rotateConfig(
+        axis == 0 ? rotateConfigX(c) : axis == 1 ? rotateConfigY(c) : rotateConfigZ(c),
+        axis, n - 1);
+}
+
+/// Rotate a configuration with its ambiguous face in positive x direction to
+/// the i-th face visited by exploreConfigRotations of gentables. The faces
+/// are visited in the order +x,+y,-x,-y,-z,+z.
+constexpr uint32_t orientConfig(uint32_t const c, int const face) {
+    return face < 4 ? rotateConfig(c, 2, face) :
+        rotateConfig(rotateConfig(c, 2, 3), 0, face == 4 ? 1 : 3);
+}
+
+/// Get the direction of the i-th visited face. The first bit of a direction
+/// encodes the sign, the second and third bit the axis.
+constexpr int getFaceDirection(int const face) {
+    return (0x542031 >> (4 * face)) & 0xf;
+}
+
+/// Check if a cube configuration is one of the four rotations of the given
+/// configuration around an axis.
+constexpr bool isAxisRotation(uint32_t const cube, uint32_t const config, int const axis) {
+    return cube == config || rotateConfig(cube, axis, 1) == config ||
+           rotateConfig(cube, axis, 2) == config || rotateConfig(cube, axis, 3) == config;
+}
+
+/// Get the direction of the ambiguous face of a cube configuration or 255 for
+/// non-problematic configurations. gentables registers the four rotations of
+/// each C16 and C19 orientation around the axis of its ambiguous face, later
+/// registrations overwriting earlier ones. Therefore, the orientations are
+/// searched in reverse, starting with the last face of C19.
+constexpr int getProblematicConfigDirection(int const cube, int const i = 11) {
+    return i < 0 ? 255 :
+        isAxisRotation(uint32_t(cube), orientConfig(i < 6 ? 199u : 215u, i % 6), getFaceDirection(i % 6) >> 1) ?
+        getFaceDirection(i % 6) : getProblematicConfigDirection(cube, i - 1);
+}
+
+//------------------------------------------------------------------------------
+// Derived tables
+
+/// Get the number of dual points of a dualPointsList entry.
+constexpr int getNumDualPoints(int32_t const (&codes)[4]) {
+    return (codes[0] != 0 ? 1 : 0) + (codes[1] != 0 ? 1 : 0) +
+           (codes[2] != 0 ? 1 : 0) + (codes[3] != 0 ? 1 : 0);
+}
+
+/// Get the slot of the dual point of a dualPointsList entry containing an
+/// edge. Uncrossed edges use slot 0.
+constexpr int getDualPointSlot(int32_t const (&codes)[4], int const edge) {
+    return ((codes[0] >> edge) & 1) ? 0 : ((codes[1] >> edge) & 1) ? 1 :
+           ((codes[2] >> edge) & 1) ? 2 : ((codes[3] >> edge) & 1) ? 3 : 0;
+}
+
+/// Get the offset of the neighbor cell sharing the ambiguous face in the
+/// given direction along an axis.
+constexpr int getNeighborOffset(int const direction, int const axis) {
+    return (direction >> 1) == axis ? ((direction & 1) ? 1 : -1) : 0;
+}
+
+//------------------------------------------------------------------------------
+// Tables
+
+/// Tables generated for all cube codes of the sequence.
+template<class Sequence>
+struct GeneratedBaseTables;
+
+template<int... Cubes>
+struct GeneratedBaseTables<IntegerSequence<Cubes...>> {
+    /// dual point codes of the up to four dual points of each cube
+    static constexpr int32_t dualPointsList[256][4] = {
+        {getDualPointCode(Cubes, 0), getDualPointCode(Cubes, 1),
+         getDualPointCode(Cubes, 2), getDualPointCode(Cubes, 3)}...
+    };
+
+    /// direction of the ambiguous face of each cube, 255 for non-problematic
+    /// configurations
+    static constexpr uint8_t problematicConfigs[256] = {
+        uint8_t(getProblematicConfigDirection(Cubes))...
+    };
+};
+
+template<int... Cubes>
+constexpr int32_t GeneratedBaseTables<IntegerSequence<Cubes...>>::dualPointsList[256][4];
+
+template<int... Cubes>
+constexpr uint8_t GeneratedBaseTables<IntegerSequence<Cubes...>>::problematicConfigs[256];
+
+/// Generated tables and the tables derived from them for the fast paths.
+template<class Sequence>
+struct GeneratedTables;
+
+template<int... Cubes>
+struct GeneratedTables<IntegerSequence<Cubes...>> : GeneratedBaseTables<IntegerSequence<Cubes...>> {
+    typedef GeneratedBaseTables<IntegerSequence<Cubes...>> Base;
+
+    /// number of dual points of each cube
+    static constexpr uint8_t numDualPoints[256] = {
+        uint8_t(getNumDualPoints(Base::dualPointsList[Cubes]))...
+    };
+
+    /// slot of the dual point of each cube and edge index
+    static constexpr uint8_t dualPointSlots[256][12] = {
+        {uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 0)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 1)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 2)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 3)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 4)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 5)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 6)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 7)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 8)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 9)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 10)),
+         uint8_t(getDualPointSlot(Base::dualPointsList[Cubes], 11))}...
+    };
+
+    /// offset of the neighbor cell in each problematicConfigs direction
+    static constexpr int8_t neighborOffsets[6][3] = {
+        {int8_t(getNeighborOffset(0, 0)), int8_t(getNeighborOffset(0, 1)), int8_t(getNeighborOffset(0, 2))},
+        {int8_t(getNeighborOffset(1, 0)), int8_t(getNeighborOffset(1, 1)), int8_t(getNeighborOffset(1, 2))},
+        {int8_t(getNeighborOffset(2, 0)), int8_t(getNeighborOffset(2, 1)), int8_t(getNeighborOffset(2, 2))},
+        {int8_t(getNeighborOffset(3, 0)), int8_t(getNeighborOffset(3, 1)), int8_t(getNeighborOffset(3, 2))},
+        {int8_t(getNeighborOffset(4, 0)), int8_t(getNeighborOffset(4, 1)), int8_t(getNeighborOffset(4, 2))},
+        {int8_t(getNeighborOffset(5, 0)), int8_t(getNeighborOffset(5, 1)), int8_t(getNeighborOffset(5, 2))}
+    };
+};
+
+template<int... Cubes>
+constexpr uint8_t GeneratedTables<IntegerSequence<Cubes...>>::numDualPoints[256];
+
+template<int... Cubes>
+constexpr uint8_t GeneratedTables<IntegerSequence<Cubes...>>::dualPointSlots[256][12];
+
+template<int... Cubes>
+constexpr int8_t GeneratedTables<IntegerSequence<Cubes...>>::neighborOffsets[6][3];
+
+/// the tables of all cube codes
+typedef GeneratedTables<CubeCodes> Tables;
+
+//------------------------------------------------------------------------------
+// Consistency checks
+//
+// Ranges of cubes are checked by halving them to keep the recursion depth of
+// the constant evaluation low.
+
+/// Check that the dual points of a dualPointsList entry cover exactly the
+/// crossed edges of the cube, that they do not share edges, and that the used
+/// slots come first.
+constexpr bool checkDualPoints(int const cube, int32_t const (&codes)[4]) {
+    return (codes[0] | codes[1] | codes[2] | codes[3]) ==
+           int32_t(getPatchEdges(uint32_t(cube), uint32_t(cube))) &&
+           (codes[0] & codes[1]) == 0 && ((codes[0] | codes[1]) & codes[2]) == 0 &&
+           ((codes[0] | codes[1] | codes[2]) & codes[3]) == 0 &&
+           (codes[1] == 0 || codes[0] != 0) && (codes[2] == 0 || codes[1] != 0) &&
+           (codes[3] == 0 || codes[2] != 0);
+}
+
+/// Get the corners of the cube face in the given direction.
+constexpr uint32_t getFaceCorners(int const direction) {
+    return ((direction >> 1) == 0 ? 0x55u : (direction >> 1) == 1 ? 0x33u : 0x0fu) <<
+        ((direction & 1) << (direction >> 1));
+}
+
+/// Check if the given corners are two diagonally opposite corners of a face.
+constexpr bool isFaceDiagonal(uint32_t const corners) {
+    return corners != 0 && (corners & (corners - 1)) != 0 &&
+        ((corners & (corners - 1)) & ((corners & (corners - 1)) - 1)) == 0 &&
+        (getAdjacentCorners(corners) & corners) == 0;
+}
+
+/// Check that a cube is either not problematic or has an ambiguous face in
+/// the direction of its problematicConfigs entry.
+constexpr bool checkProblematicConfig(int const cube, int const direction) {
+    return direction == 255 || isFaceDiagonal(uint32_t(cube) & getFaceCorners(direction));
+}
+
+/// Apply the cube checks to a range of cubes.
+constexpr bool checkCubes(int const begin, int const end) {
+    return end - begin == 1 ?
+        checkDualPoints(begin, Tables::dualPointsList[begin]) &&
+        checkProblematicConfig(begin, Tables::problematicConfigs[begin]) :
+        checkCubes(begin, begin + (end - begin) / 2) && checkCubes(begin + (end - begin) / 2, end);
+}
+
+/// Count the problematic configurations of a range of cubes.
+constexpr int countProblematicConfigs(int const begin, int const end) {
+    return end - begin == 1 ? (Tables::problematicConfigs[begin] != 255 ? 1 : 0) :
+        countProblematicConfigs(begin, begin + (end - begin) / 2) +
+        countProblematicConfigs(begin + (end - begin) / 2, end);
+}
+
+/// Hash a table entry combined with its position.
+constexpr uint64_t hashTableEntry(uint64_t const h) {
+    return h ^ (h >> 29);
+}
+
+/// Get the value of the i-th entry of the dual point and manifold tables.
+constexpr uint64_t getTableEntry(int const i) {
+    return i < 1024 ? uint64_t(uint32_t(Tables::dualPointsList[i / 4][i % 4])) :
+        uint64_t(Tables::problematicConfigs[i - 1024]);
+}
+
+/// Compute a position dependent checksum of a range of table entries.
+constexpr uint64_t getTableChecksum(int const begin, int const end) {
+    return end - begin == 1 ?
+        hashTableEntry(((getTableEntry(begin) << 16) | uint64_t(begin)) * 0x9e3779b97f4a7c15ull) :
+        getTableChecksum(begin, begin + (end - begin) / 2) +
+        getTableChecksum(begin + (end - begin) / 2, end);
+}
+
+static_assert(checkCubes(0, 256),
+    "dual points have to partition the crossed edges of each cube");
+static_assert(countProblematicConfigs(0, 256) == 36,
+    "the rotations of C16 and C19 have to give 36 problematic configurations");
+// checksum of the tables written by gentables
+static_assert(getTableChecksum(0, 1280) == 0x9da401e1bb006429ull,
+    "generated tables differ from the tables written by gentables");
+
+} // END: namespace tables
+
+} // END: namespace dualmc
+
+#endif // DUALMC_TABLES_H_INCLUDED